@@ -11,8 +11,23 @@
 #ifndef CC_H
 #define CC_H
 
+#include "cc_algorithm.h"
+#include "cc_art.h"
+#include "cc_bloom.h"
+#include "cc_btree_map.h"
+#include "cc_concurrent_map.h"
+#include "cc_count_min.h"
+#include "cc_flat_map.h"
+#include "cc_hamt.h"
+#include "cc_hll.h"
 #include "cc_list.h"
+#include "cc_lru_cache.h"
 #include "cc_map.h"
+#include "cc_multimap.h"
+#include "cc_ordered_map.h"
+#include "cc_rcu_map.h"
+#include "cc_set.h"
+#include "cc_spill_map.h"
 #include "cc_string.h"
 #include "cc_vector.h"
 #include "cc_version.h"
@@ -0,0 +1,2491 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cc_algorithm.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+struct _cc_sort
+{
+  size_t element_size;
+  cc_compare_fn compare;
+  const struct cc_functions* functions;
+  bool trivial;
+  void* temp;
+};
+
+// A unit of parallel sorting work: either sort the elements at a in place,
+// or merge the sorted ranges at a and b into dest.
+struct _cc_sort_task
+{
+  void* a;
+  size_t a_count;
+  void* b;
+  size_t b_count;
+  void* dest;
+};
+
+struct _cc_sort_job
+{
+  struct _cc_sort sort;
+  struct _cc_sort_task* tasks;
+  void* temps;
+};
+
+typedef void (*_cc_parallel_fn)(void* arg, size_t task, size_t worker);
+
+struct _cc_parallel_worker
+{
+  struct _cc_parallel* parallel;
+  size_t index;
+  pthread_t thread;
+  bool started;
+};
+
+// A pool of worker threads kept for the length of one algorithm.  Each round
+// hands the workers a function and a number of tasks, which they claim one
+// at a time until none are left.
+struct _cc_parallel
+{
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_cond_t idle;
+  struct _cc_parallel_worker* workers;
+  size_t threads;
+  size_t round;
+  size_t busy;
+  bool stop;
+  _cc_parallel_fn fn;
+  void* arg;
+  size_t task_count;
+  atomic_size_t next;
+};
+
+struct _cc_radix
+{
+  size_t element_size;
+  size_t offset;
+  size_t key_size;
+  enum cc_radix_key type;
+  cc_radix_key_fn key;
+  void* arg;
+  const struct cc_functions* functions;
+  bool trivial;
+};
+
+// A radix sort spread over chunks of the vector.  The counts hold 256
+// buckets for each digit of each chunk.
+struct _cc_radix_job
+{
+  struct _cc_radix radix;
+  void* src;
+  void* dst;
+  size_t count;
+  size_t chunks;
+  size_t digits;
+  size_t digit;
+  size_t* counts;
+};
+
+enum _cc_set_key
+{
+  _cc_set_other,
+  _cc_set_int,
+  _cc_set_uint32,
+  _cc_set_int64,
+  _cc_set_uint64
+};
+
+struct _cc_set
+{
+  size_t element_size;
+  cc_compare_fn compare;
+  enum _cc_set_key key;
+};
+
+struct _cc_timsort_run
+{
+  void* data;
+  size_t count;
+};
+
+// The state of a stable merge sort.  With the merge rules below, run lengths
+// grow at least as fast as the Fibonacci numbers, so 85 runs cover any
+// vector that fits in memory.
+struct _cc_timsort
+{
+  struct _cc_sort sort;
+  void* buffer;
+  size_t min_gallop;
+  size_t run_count;
+  struct _cc_timsort_run runs[85];
+};
+
+const size_t _cc_sort_insertion_limit = 16;
+
+// Merges switch to galloping after one run wins this many times in a row.
+const size_t _cc_timsort_min_gallop = 7;
+
+// Intersections gallop through the longer side once it is this many times
+// longer than the other.
+const size_t _cc_set_gallop_ratio = 32;
+
+// Below this many elements per thread, threads cost more than they save.
+const size_t _cc_sort_parallel_grain = 8192;
+
+int
+_cc_sort_compare(const struct _cc_sort* s, const void* a, const void* b)
+{
+  return s->compare(a, b, s->element_size);
+}
+
+void
+_cc_sort_move(const struct _cc_sort* s, void* dest, void* src)
+{
+  if (s->trivial)
+  {
+    memcpy(dest, src, s->element_size);
+  }
+  else
+  {
+    cc_relocate(s->functions, dest, src, s->element_size);
+  }
+}
+
+void
+_cc_sort_move_range(const struct _cc_sort* s,
+                    void* dest,
+                    void* src,
+                    size_t count)
+{
+  // The ranges may overlap.
+  cc_relocate_range(s->functions, dest, src, count, s->element_size);
+}
+
+void
+_cc_sort_swap(const struct _cc_sort* s, void* a, void* b)
+{
+  _cc_sort_move(s, s->temp, a);
+  _cc_sort_move(s, a, b);
+  _cc_sort_move(s, b, s->temp);
+}
+
+void
+_cc_sort_insertion(const struct _cc_sort* s, void* data, size_t count)
+{
+  size_t size = s->element_size;
+  for (size_t n = 1; n < count; ++n)
+  {
+    void* p = data + n * size;
+    if (_cc_sort_compare(s, p, p - size) < 0)
+    {
+      _cc_sort_move(s, s->temp, p);
+      do
+      {
+        _cc_sort_move(s, p, p - size);
+        p -= size;
+      }
+      while (p > data && _cc_sort_compare(s, s->temp, p - size) < 0);
+      _cc_sort_move(s, p, s->temp);
+    }
+  }
+}
+
+void
+_cc_sort_sift_down(const struct _cc_sort* s,
+                   void* data,
+                   size_t root,
+                   size_t count)
+{
+  size_t size = s->element_size;
+  while (true)
+  {
+    size_t child = 2 * root + 1;
+    if (child >= count)
+    {
+      return;
+    }
+    if (child + 1 < count
+        && _cc_sort_compare(s, data + child * size,
+                            data + (child + 1) * size) < 0)
+    {
+      ++child;
+    }
+    if (_cc_sort_compare(s, data + root * size, data + child * size) >= 0)
+    {
+      return;
+    }
+    _cc_sort_swap(s, data + root * size, data + child * size);
+    root = child;
+  }
+}
+
+void
+_cc_sort_sift_up(const struct _cc_sort* s, void* data, size_t child)
+{
+  size_t size = s->element_size;
+  while (child > 0)
+  {
+    size_t parent = (child - 1) / 2;
+    if (_cc_sort_compare(s, data + parent * size, data + child * size) >= 0)
+    {
+      return;
+    }
+    _cc_sort_swap(s, data + parent * size, data + child * size);
+    child = parent;
+  }
+}
+
+void
+_cc_sort_heap_pop_all(const struct _cc_sort* s, void* data, size_t count)
+{
+  // Turn a max-heap into a sorted range.
+  for (size_t n = count - 1; n > 0; --n)
+  {
+    _cc_sort_swap(s, data, data + n * s->element_size);
+    _cc_sort_sift_down(s, data, 0, n);
+  }
+}
+
+void
+_cc_sort_heap(const struct _cc_sort* s, void* data, size_t count)
+{
+  for (size_t n = count / 2; n > 0; --n)
+  {
+    _cc_sort_sift_down(s, data, n - 1, count);
+  }
+  _cc_sort_heap_pop_all(s, data, count);
+}
+
+size_t
+_cc_sort_partition(const struct _cc_sort* s, void* data, size_t count)
+{
+  // Partition around a median-of-three pivot and return where the pivot
+  // ends up.  Nothing before it compares greater and nothing after it
+  // compares less.
+  size_t size = s->element_size;
+  void* first = data;
+  void* middle = data + (count / 2) * size;
+  void* last = data + (count - 1) * size;
+  if (_cc_sort_compare(s, middle, first) < 0)
+  {
+    _cc_sort_swap(s, middle, first);
+  }
+  if (_cc_sort_compare(s, last, middle) < 0)
+  {
+    _cc_sort_swap(s, last, middle);
+    if (_cc_sort_compare(s, middle, first) < 0)
+    {
+      _cc_sort_swap(s, middle, first);
+    }
+  }
+  _cc_sort_swap(s, first, middle);
+
+  // Stopping on elements equal to the pivot keeps the partitions balanced
+  // when there are many duplicates.
+  size_t i = 1;
+  size_t j = count - 1;
+  while (true)
+  {
+    while (i <= j && _cc_sort_compare(s, data + i * size, first) < 0)
+    {
+      ++i;
+    }
+    while (i <= j && _cc_sort_compare(s, data + j * size, first) > 0)
+    {
+      --j;
+    }
+    if (i >= j)
+    {
+      break;
+    }
+    _cc_sort_swap(s, data + i * size, data + j * size);
+    ++i;
+    --j;
+  }
+  if (j > 0)
+  {
+    _cc_sort_swap(s, first, data + j * size);
+  }
+  return j;
+}
+
+void
+_cc_sort_intro(const struct _cc_sort* s,
+               void* data,
+               size_t count,
+               size_t depth)
+{
+  // Quicksort, falling back to heapsort when the recursion grows too deep
+  // and to insertion sort for short ranges.
+  size_t size = s->element_size;
+  while (count > _cc_sort_insertion_limit)
+  {
+    if (depth == 0)
+    {
+      _cc_sort_heap(s, data, count);
+      return;
+    }
+    --depth;
+
+    // Recurse into the smaller side and loop on the larger one.
+    size_t j = _cc_sort_partition(s, data, count);
+    size_t left = j;
+    size_t right = count - j - 1;
+    if (left < right)
+    {
+      _cc_sort_intro(s, data, left, depth);
+      data += (j + 1) * size;
+      count = right;
+    }
+    else
+    {
+      _cc_sort_intro(s, data + (j + 1) * size, right, depth);
+      count = left;
+    }
+  }
+  _cc_sort_insertion(s, data, count);
+}
+
+void
+_cc_sort_select(const struct _cc_sort* s,
+                void* data,
+                size_t count,
+                size_t nth,
+                size_t depth)
+{
+  // Quickselect, falling back to heapsort when the partitions keep coming
+  // out lopsided.
+  size_t size = s->element_size;
+  while (count > _cc_sort_insertion_limit)
+  {
+    if (depth == 0)
+    {
+      _cc_sort_heap(s, data, count);
+      return;
+    }
+    --depth;
+
+    size_t j = _cc_sort_partition(s, data, count);
+    if (nth == j)
+    {
+      return;
+    }
+    else if (nth < j)
+    {
+      count = j;
+    }
+    else
+    {
+      data += (j + 1) * size;
+      nth -= j + 1;
+      count -= j + 1;
+    }
+  }
+  _cc_sort_insertion(s, data, count);
+}
+
+size_t
+_cc_sort_depth(size_t count)
+{
+  size_t depth = 0;
+  for (; count > 1; count >>= 1)
+  {
+    depth += 2;
+  }
+  return depth;
+}
+
+size_t
+_cc_sort_corank(const struct _cc_sort* s,
+                const void* a,
+                size_t a_count,
+                const void* b,
+                size_t b_count,
+                size_t k)
+{
+  // Find how many of the first k merged elements come from a, with ties
+  // going to a.
+  size_t size = s->element_size;
+  size_t lo = k > b_count ? k - b_count : 0;
+  size_t hi = k < a_count ? k : a_count;
+  while (lo < hi)
+  {
+    size_t i = lo + (hi - lo) / 2;
+    size_t j = k - i;
+    if (j > 0 && _cc_sort_compare(s, a + i * size, b + (j - 1) * size) <= 0)
+    {
+      lo = i + 1;
+    }
+    else
+    {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+void
+_cc_sort_merge(const struct _cc_sort* s, struct _cc_sort_task* task)
+{
+  // A task without a b range only moves the a range into place.
+  if (!task->b)
+  {
+    _cc_sort_move_range(s, task->dest, task->a, task->a_count);
+    return;
+  }
+
+  size_t size = s->element_size;
+  void* a = task->a;
+  void* b = task->b;
+  void* a_end = a + task->a_count * size;
+  void* b_end = b + task->b_count * size;
+  void* dest = task->dest;
+  while (a < a_end && b < b_end)
+  {
+    if (_cc_sort_compare(s, b, a) < 0)
+    {
+      _cc_sort_move(s, dest, b);
+      b += size;
+    }
+    else
+    {
+      _cc_sort_move(s, dest, a);
+      a += size;
+    }
+    dest += size;
+  }
+  _cc_sort_move_range(s, dest, a, (a_end - a) / size);
+  dest += a_end - a;
+  _cc_sort_move_range(s, dest, b, (b_end - b) / size);
+}
+
+void
+_cc_sort_binary_insertion(const struct _cc_sort* s,
+                          void* data,
+                          size_t sorted,
+                          size_t count)
+{
+  // Insert each element after the sorted prefix behind all of the elements
+  // that do not compare greater, which keeps equal elements in order.
+  size_t size = s->element_size;
+  for (size_t n = sorted; n < count; ++n)
+  {
+    void* p = data + n * size;
+    size_t lo = 0;
+    size_t hi = n;
+    while (lo < hi)
+    {
+      size_t m = lo + (hi - lo) / 2;
+      if (_cc_sort_compare(s, p, data + m * size) < 0)
+      {
+        hi = m;
+      }
+      else
+      {
+        lo = m + 1;
+      }
+    }
+    if (lo < n)
+    {
+      _cc_sort_move(s, s->temp, p);
+      _cc_sort_move_range(s, data + (lo + 1) * size, data + lo * size, n - lo);
+      _cc_sort_move(s, data + lo * size, s->temp);
+    }
+  }
+}
+
+size_t
+_cc_timsort_min_run(size_t count)
+{
+  // A run length between 32 and 64 that splits count into a power of two
+  // or slightly fewer runs.
+  size_t r = 0;
+  while (count >= 64)
+  {
+    r |= count & 1;
+    count >>= 1;
+  }
+  return count + r;
+}
+
+size_t
+_cc_timsort_count_run(const struct _cc_sort* s, void* data, size_t count)
+{
+  // Find the length of the run at the front, reversing it if it is strictly
+  // descending.  Strictness keeps the reversal stable.
+  size_t size = s->element_size;
+  if (count < 2)
+  {
+    return count;
+  }
+  size_t n = 2;
+  if (_cc_sort_compare(s, data + size, data) < 0)
+  {
+    while (n < count
+           && _cc_sort_compare(s, data + n * size,
+                               data + (n - 1) * size) < 0)
+    {
+      ++n;
+    }
+    for (size_t i = 0, j = n - 1; i < j; ++i, --j)
+    {
+      _cc_sort_swap(s, data + i * size, data + j * size);
+    }
+  }
+  else
+  {
+    while (n < count
+           && _cc_sort_compare(s, data + n * size,
+                               data + (n - 1) * size) >= 0)
+    {
+      ++n;
+    }
+  }
+  return n;
+}
+
+size_t
+_cc_timsort_gallop_left(const struct _cc_sort* s,
+                        const void* key,
+                        void* data,
+                        size_t count,
+                        size_t hint)
+{
+  // Find the first element that is not less than the key, searching out
+  // from the hint in steps that double.
+  size_t size = s->element_size;
+  ptrdiff_t last = 0;
+  ptrdiff_t offset = 1;
+  ptrdiff_t h = (ptrdiff_t) hint;
+  if (_cc_sort_compare(s, data + h * size, key) < 0)
+  {
+    ptrdiff_t max = (ptrdiff_t) count - h;
+    while (offset < max
+           && _cc_sort_compare(s, data + (h + offset) * size, key) < 0)
+    {
+      last = offset;
+      offset = 2 * offset + 1;
+    }
+    if (offset > max)
+    {
+      offset = max;
+    }
+    last += h;
+    offset += h;
+  }
+  else
+  {
+    ptrdiff_t max = h + 1;
+    while (offset < max
+           && _cc_sort_compare(s, data + (h - offset) * size, key) >= 0)
+    {
+      last = offset;
+      offset = 2 * offset + 1;
+    }
+    if (offset > max)
+    {
+      offset = max;
+    }
+    ptrdiff_t k = last;
+    last = h - offset;
+    offset = h - k;
+  }
+
+  // The answer is in (last, offset].
+  ++last;
+  while (last < offset)
+  {
+    ptrdiff_t m = last + (offset - last) / 2;
+    if (_cc_sort_compare(s, data + m * size, key) < 0)
+    {
+      last = m + 1;
+    }
+    else
+    {
+      offset = m;
+    }
+  }
+  return (size_t) offset;
+}
+
+size_t
+_cc_timsort_gallop_right(const struct _cc_sort* s,
+                         const void* key,
+                         void* data,
+                         size_t count,
+                         size_t hint)
+{
+  // Find the first element that is greater than the key.
+  size_t size = s->element_size;
+  ptrdiff_t last = 0;
+  ptrdiff_t offset = 1;
+  ptrdiff_t h = (ptrdiff_t) hint;
+  if (_cc_sort_compare(s, key, data + h * size) < 0)
+  {
+    ptrdiff_t max = h + 1;
+    while (offset < max
+           && _cc_sort_compare(s, key, data + (h - offset) * size) < 0)
+    {
+      last = offset;
+      offset = 2 * offset + 1;
+    }
+    if (offset > max)
+    {
+      offset = max;
+    }
+    ptrdiff_t k = last;
+    last = h - offset;
+    offset = h - k;
+  }
+  else
+  {
+    ptrdiff_t max = (ptrdiff_t) count - h;
+    while (offset < max
+           && _cc_sort_compare(s, key, data + (h + offset) * size) >= 0)
+    {
+      last = offset;
+      offset = 2 * offset + 1;
+    }
+    if (offset > max)
+    {
+      offset = max;
+    }
+    last += h;
+    offset += h;
+  }
+
+  ++last;
+  while (last < offset)
+  {
+    ptrdiff_t m = last + (offset - last) / 2;
+    if (_cc_sort_compare(s, key, data + m * size) < 0)
+    {
+      offset = m;
+    }
+    else
+    {
+      last = m + 1;
+    }
+  }
+  return (size_t) offset;
+}
+
+void
+_cc_timsort_merge_low(struct _cc_timsort* t,
+                      void* a,
+                      size_t a_count,
+                      void* b,
+                      size_t b_count)
+{
+  // Merge from the front with the shorter run a moved into the buffer.  The
+  // caller has arranged that b's first element goes first and a's last
+  // element goes last.
+  const struct _cc_sort* s = &t->sort;
+  size_t size = s->element_size;
+  void* dest = a;
+  void* pa = t->buffer;
+  void* pb = b;
+  _cc_sort_move_range(s, pa, a, a_count);
+
+  _cc_sort_move(s, dest, pb);
+  dest += size;
+  pb += size;
+  if (--b_count == 0)
+  {
+    goto done;
+  }
+  if (a_count == 1)
+  {
+    goto last_a;
+  }
+
+  while (true)
+  {
+    // Take one element at a time until one run keeps winning.
+    size_t a_wins = 0;
+    size_t b_wins = 0;
+    do
+    {
+      if (_cc_sort_compare(s, pb, pa) < 0)
+      {
+        _cc_sort_move(s, dest, pb);
+        dest += size;
+        pb += size;
+        ++b_wins;
+        a_wins = 0;
+        if (--b_count == 0)
+        {
+          goto done;
+        }
+      }
+      else
+      {
+        _cc_sort_move(s, dest, pa);
+        dest += size;
+        pa += size;
+        ++a_wins;
+        b_wins = 0;
+        if (--a_count == 1)
+        {
+          goto last_a;
+        }
+      }
+    }
+    while (a_wins < t->min_gallop && b_wins < t->min_gallop);
+
+    // Then gallop, moving whole stretches at once, for as long as that pays.
+    ++t->min_gallop;
+    do
+    {
+      t->min_gallop -= t->min_gallop > 1;
+
+      a_wins = _cc_timsort_gallop_right(s, pb, pa, a_count, 0);
+      if (a_wins > 0)
+      {
+        _cc_sort_move_range(s, dest, pa, a_wins);
+        dest += a_wins * size;
+        pa += a_wins * size;
+        a_count -= a_wins;
+        if (a_count == 1)
+        {
+          goto last_a;
+        }
+        if (a_count == 0)
+        {
+          goto done;
+        }
+      }
+      _cc_sort_move(s, dest, pb);
+      dest += size;
+      pb += size;
+      if (--b_count == 0)
+      {
+        goto done;
+      }
+
+      b_wins = _cc_timsort_gallop_left(s, pa, pb, b_count, 0);
+      if (b_wins > 0)
+      {
+        _cc_sort_move_range(s, dest, pb, b_wins);
+        dest += b_wins * size;
+        pb += b_wins * size;
+        b_count -= b_wins;
+        if (b_count == 0)
+        {
+          goto done;
+        }
+      }
+      _cc_sort_move(s, dest, pa);
+      dest += size;
+      pa += size;
+      if (--a_count == 1)
+      {
+        goto last_a;
+      }
+    }
+    while (a_wins >= _cc_timsort_min_gallop
+           || b_wins >= _cc_timsort_min_gallop);
+    ++t->min_gallop;
+  }
+
+last_a:
+  _cc_sort_move_range(s, dest, pb, b_count);
+  _cc_sort_move(s, dest + b_count * size, pa);
+  return;
+
+done:
+  _cc_sort_move_range(s, dest, pa, a_count);
+}
+
+void
+_cc_timsort_merge_high(struct _cc_timsort* t,
+                       void* a,
+                       size_t a_count,
+                       void* b,
+                       size_t b_count)
+{
+  // Merge from the back with the shorter run b moved into the buffer.
+  const struct _cc_sort* s = &t->sort;
+  size_t size = s->element_size;
+  void* dest = b + (b_count - 1) * size;
+  void* pa = a + (a_count - 1) * size;
+  void* pb = t->buffer + (b_count - 1) * size;
+  _cc_sort_move_range(s, t->buffer, b, b_count);
+
+  _cc_sort_move(s, dest, pa);
+  dest -= size;
+  pa -= size;
+  if (--a_count == 0)
+  {
+    goto done;
+  }
+  if (b_count == 1)
+  {
+    goto first_b;
+  }
+
+  while (true)
+  {
+    size_t a_wins = 0;
+    size_t b_wins = 0;
+    do
+    {
+      if (_cc_sort_compare(s, pb, pa) < 0)
+      {
+        _cc_sort_move(s, dest, pa);
+        dest -= size;
+        pa -= size;
+        ++a_wins;
+        b_wins = 0;
+        if (--a_count == 0)
+        {
+          goto done;
+        }
+      }
+      else
+      {
+        _cc_sort_move(s, dest, pb);
+        dest -= size;
+        pb -= size;
+        ++b_wins;
+        a_wins = 0;
+        if (--b_count == 1)
+        {
+          goto first_b;
+        }
+      }
+    }
+    while (a_wins < t->min_gallop && b_wins < t->min_gallop);
+
+    ++t->min_gallop;
+    do
+    {
+      t->min_gallop -= t->min_gallop > 1;
+
+      size_t k = _cc_timsort_gallop_right(s, pb, a, a_count, a_count - 1);
+      a_wins = a_count - k;
+      if (a_wins > 0)
+      {
+        dest -= a_wins * size;
+        pa -= a_wins * size;
+        _cc_sort_move_range(s, dest + size, pa + size, a_wins);
+        a_count -= a_wins;
+        if (a_count == 0)
+        {
+          goto done;
+        }
+      }
+      _cc_sort_move(s, dest, pb);
+      dest -= size;
+      pb -= size;
+      if (--b_count == 1)
+      {
+        goto first_b;
+      }
+
+      k = _cc_timsort_gallop_left(s, pa, t->buffer, b_count, b_count - 1);
+      b_wins = b_count - k;
+      if (b_wins > 0)
+      {
+        dest -= b_wins * size;
+        pb -= b_wins * size;
+        _cc_sort_move_range(s, dest + size, pb + size, b_wins);
+        b_count -= b_wins;
+        if (b_count == 1)
+        {
+          goto first_b;
+        }
+        if (b_count == 0)
+        {
+          goto done;
+        }
+      }
+      _cc_sort_move(s, dest, pa);
+      dest -= size;
+      pa -= size;
+      if (--a_count == 0)
+      {
+        goto done;
+      }
+    }
+    while (a_wins >= _cc_timsort_min_gallop
+           || b_wins >= _cc_timsort_min_gallop);
+    ++t->min_gallop;
+  }
+
+first_b:
+  dest -= a_count * size;
+  pa -= a_count * size;
+  _cc_sort_move_range(s, dest + size, pa + size, a_count);
+  _cc_sort_move(s, dest, pb);
+  return;
+
+done:
+  _cc_sort_move_range(s, dest - (b_count - 1) * size, t->buffer, b_count);
+}
+
+void
+_cc_timsort_merge_at(struct _cc_timsort* t, size_t i)
+{
+  // Merge runs i and i + 1, skipping the elements of either that are
+  // already in place.
+  const struct _cc_sort* s = &t->sort;
+  size_t size = s->element_size;
+  void* a = t->runs[i].data;
+  size_t a_count = t->runs[i].count;
+  void* b = t->runs[i + 1].data;
+  size_t b_count = t->runs[i + 1].count;
+
+  t->runs[i].count = a_count + b_count;
+  for (size_t n = i + 1; n + 1 < t->run_count; ++n)
+  {
+    t->runs[n] = t->runs[n + 1];
+  }
+  --t->run_count;
+
+  size_t k = _cc_timsort_gallop_right(s, b, a, a_count, 0);
+  a += k * size;
+  a_count -= k;
+  if (a_count == 0)
+  {
+    return;
+  }
+  b_count = _cc_timsort_gallop_left(
+      s,
+      a + (a_count - 1) * size,
+      b,
+      b_count,
+      b_count - 1
+    );
+  if (b_count == 0)
+  {
+    return;
+  }
+
+  if (a_count <= b_count)
+  {
+    _cc_timsort_merge_low(t, a, a_count, b, b_count);
+  }
+  else
+  {
+    _cc_timsort_merge_high(t, a, a_count, b, b_count);
+  }
+}
+
+void
+_cc_timsort_collapse(struct _cc_timsort* t)
+{
+  // Keep the run lengths growing at least as fast as the Fibonacci numbers
+  // from the top of the stack down, so merges stay balanced.
+  struct _cc_timsort_run* r = t->runs;
+  while (t->run_count > 1)
+  {
+    size_t n = t->run_count - 2;
+    if ((n > 0 && r[n - 1].count <= r[n].count + r[n + 1].count)
+        || (n > 1 && r[n - 2].count <= r[n - 1].count + r[n].count))
+    {
+      if (r[n - 1].count < r[n + 1].count)
+      {
+        --n;
+      }
+    }
+    else if (r[n].count > r[n + 1].count)
+    {
+      return;
+    }
+    _cc_timsort_merge_at(t, n);
+  }
+}
+
+void
+_cc_timsort_force_collapse(struct _cc_timsort* t)
+{
+  struct _cc_timsort_run* r = t->runs;
+  while (t->run_count > 1)
+  {
+    size_t n = t->run_count - 2;
+    if (n > 0 && r[n - 1].count < r[n + 1].count)
+    {
+      --n;
+    }
+    _cc_timsort_merge_at(t, n);
+  }
+}
+
+size_t
+_cc_split(size_t count, size_t parts, size_t index)
+{
+  // The first element of the index-th of parts nearly equal pieces.
+  return count / parts * index + count % parts * index / parts;
+}
+
+size_t
+_cc_parallel_threads(size_t count, size_t threads)
+{
+  if (threads == 0)
+  {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = online > 0 ? (size_t) online : 1;
+  }
+  if (threads > count / _cc_sort_parallel_grain)
+  {
+    threads = count / _cc_sort_parallel_grain;
+  }
+  return threads > 1 ? threads : 1;
+}
+
+void
+_cc_parallel_run(struct _cc_parallel* self, size_t worker)
+{
+  size_t n;
+  while ((n = atomic_fetch_add(&self->next, 1)) < self->task_count)
+  {
+    self->fn(self->arg, n, worker);
+  }
+}
+
+void*
+_cc_parallel_work(void* arg)
+{
+  struct _cc_parallel_worker* worker = (struct _cc_parallel_worker*) arg;
+  struct _cc_parallel* self = worker->parallel;
+  size_t round = 0;
+  pthread_mutex_lock(&self->lock);
+  while (true)
+  {
+    while (self->round == round && !self->stop)
+    {
+      pthread_cond_wait(&self->wake, &self->lock);
+    }
+    if (self->stop)
+    {
+      break;
+    }
+    round = self->round;
+    pthread_mutex_unlock(&self->lock);
+
+    _cc_parallel_run(self, worker->index);
+
+    pthread_mutex_lock(&self->lock);
+    if (--self->busy == 0)
+    {
+      pthread_cond_signal(&self->idle);
+    }
+  }
+  pthread_mutex_unlock(&self->lock);
+  return NULL;
+}
+
+void
+_cc_parallel_start(struct _cc_parallel* self,
+                   struct _cc_parallel_worker* workers,
+                   size_t threads)
+{
+  // The calling thread is worker zero.  Threads that cannot be started are
+  // simply left out, since the caller picks up whatever work is left.
+  pthread_mutex_init(&self->lock, NULL);
+  pthread_cond_init(&self->wake, NULL);
+  pthread_cond_init(&self->idle, NULL);
+  self->workers = workers;
+  self->threads = threads;
+  self->round = 0;
+  self->busy = 0;
+  self->stop = false;
+  for (size_t n = 0; n < threads; ++n)
+  {
+    workers[n].parallel = self;
+    workers[n].index = n;
+    workers[n].started = n > 0 && pthread_create(
+        &workers[n].thread,
+        NULL,
+        _cc_parallel_work,
+        workers + n
+      ) == 0;
+  }
+}
+
+void
+_cc_parallel_for(struct _cc_parallel* self,
+                 _cc_parallel_fn fn,
+                 void* arg,
+                 size_t task_count)
+{
+  pthread_mutex_lock(&self->lock);
+  self->fn = fn;
+  self->arg = arg;
+  self->task_count = task_count;
+  atomic_store(&self->next, 0);
+  self->busy = 0;
+  for (size_t n = 1; n < self->threads; ++n)
+  {
+    self->busy += self->workers[n].started ? 1 : 0;
+  }
+  ++self->round;
+  pthread_cond_broadcast(&self->wake);
+  pthread_mutex_unlock(&self->lock);
+
+  _cc_parallel_run(self, 0);
+
+  pthread_mutex_lock(&self->lock);
+  while (self->busy > 0)
+  {
+    pthread_cond_wait(&self->idle, &self->lock);
+  }
+  pthread_mutex_unlock(&self->lock);
+}
+
+void
+_cc_parallel_stop(struct _cc_parallel* self)
+{
+  pthread_mutex_lock(&self->lock);
+  self->stop = true;
+  pthread_cond_broadcast(&self->wake);
+  pthread_mutex_unlock(&self->lock);
+  for (size_t n = 1; n < self->threads; ++n)
+  {
+    if (self->workers[n].started)
+    {
+      pthread_join(self->workers[n].thread, NULL);
+    }
+  }
+  pthread_cond_destroy(&self->idle);
+  pthread_cond_destroy(&self->wake);
+  pthread_mutex_destroy(&self->lock);
+}
+
+void
+_cc_sort_run_task(void* arg, size_t task, size_t worker)
+{
+  struct _cc_sort_job* job = (struct _cc_sort_job*) arg;
+  struct _cc_sort s = job->sort;
+  s.temp = job->temps + worker * s.element_size;
+  struct _cc_sort_task* t = job->tasks + task;
+  _cc_sort_intro(&s, t->a, t->a_count, _cc_sort_depth(t->a_count));
+}
+
+void
+_cc_sort_merge_task(void* arg, size_t task, size_t worker)
+{
+  struct _cc_sort_job* job = (struct _cc_sort_job*) arg;
+  _cc_sort_merge(&job->sort, job->tasks + task);
+}
+
+void
+cc_vector_sort(struct cc_vector* self, cc_compare_fn compare)
+{
+  if (self && compare && self->size > 1)
+  {
+    void* temp = malloc(self->element_size);
+    if (!temp)
+    {
+      return;
+    }
+
+    struct _cc_sort s = {
+      .element_size = self->element_size,
+      .compare = compare,
+      .functions = &self->functions,
+      .trivial = self->functions.relocator == cc_default_relocator,
+      .temp = temp
+    };
+    _cc_sort_intro(&s, self->data, self->size, _cc_sort_depth(self->size));
+
+    free(temp);
+  }
+}
+
+void
+cc_vector_parallel_sort(struct cc_vector* self,
+                        cc_compare_fn compare,
+                        size_t threads)
+{
+  if (!self || !compare || self->size < 2)
+  {
+    return;
+  }
+
+  size_t count = self->size;
+  size_t size = self->element_size;
+  threads = _cc_parallel_threads(count, threads);
+  if (threads == 1)
+  {
+    cc_vector_sort(self, compare);
+    return;
+  }
+
+  // Each round has at most one task per thread plus one per pair of runs.
+  void* buffer = malloc(count * size);
+  void* temps = malloc(threads * size);
+  struct _cc_sort_task* tasks = malloc(2 * threads * sizeof(*tasks));
+  size_t* bounds = malloc((threads + 1) * sizeof(size_t));
+  struct _cc_parallel_worker* workers = malloc(threads * sizeof(*workers));
+  if (!buffer || !temps || !tasks || !bounds || !workers)
+  {
+    free(workers);
+    free(bounds);
+    free(tasks);
+    free(temps);
+    free(buffer);
+    cc_vector_sort(self, compare);
+    return;
+  }
+
+  struct _cc_sort_job job = {
+    .sort = {
+      .element_size = size,
+      .compare = compare,
+      .functions = &self->functions,
+      .trivial = self->functions.relocator == cc_default_relocator,
+      .temp = NULL
+    },
+    .tasks = tasks,
+    .temps = temps
+  };
+
+  struct _cc_parallel pool;
+  _cc_parallel_start(&pool, workers, threads);
+
+  // Sort one run per thread in place.
+  size_t runs = threads;
+  for (size_t r = 0; r <= runs; ++r)
+  {
+    bounds[r] = _cc_split(count, runs, r);
+  }
+  for (size_t r = 0; r < runs; ++r)
+  {
+    tasks[r].a = self->data + bounds[r] * size;
+    tasks[r].a_count = bounds[r + 1] - bounds[r];
+  }
+  _cc_parallel_for(&pool, _cc_sort_run_task, &job, runs);
+
+  // Merge pairs of runs until one is left, back and forth between the vector
+  // and the buffer.  Each merge is cut into pieces in proportion to its
+  // length, so every round keeps all threads busy.
+  void* src = self->data;
+  void* dst = buffer;
+  while (runs > 1)
+  {
+    size_t task_count = 0;
+    size_t merged = 0;
+    for (size_t r = 0; r < runs; r += 2)
+    {
+      size_t first = bounds[r];
+      size_t middle = bounds[r + 1];
+      size_t last = r + 1 < runs ? bounds[r + 2] : middle;
+      void* a = src + first * size;
+      void* b = src + middle * size;
+
+      size_t length = last - first;
+      size_t pieces = length / (count / threads + 1) + 1;
+      size_t i0 = 0;
+      size_t k0 = 0;
+      for (size_t p = 1; p <= pieces; ++p)
+      {
+        size_t k1 = _cc_split(length, pieces, p);
+        size_t i1 = _cc_sort_corank(
+            &job.sort,
+            a,
+            middle - first,
+            b,
+            last - middle,
+            k1
+          );
+        struct _cc_sort_task* task = tasks + task_count++;
+        task->a = a + i0 * size;
+        task->a_count = i1 - i0;
+        task->b = b + (k0 - i0) * size;
+        task->b_count = (k1 - i1) - (k0 - i0);
+        task->dest = dst + (first + k0) * size;
+        i0 = i1;
+        k0 = k1;
+      }
+      bounds[merged++] = first;
+    }
+    bounds[merged] = count;
+    runs = merged;
+
+    _cc_parallel_for(&pool, _cc_sort_merge_task, &job, task_count);
+    void* swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != self->data)
+  {
+    for (size_t t = 0; t < threads; ++t)
+    {
+      size_t first = _cc_split(count, threads, t);
+      size_t last = _cc_split(count, threads, t + 1);
+      tasks[t].a = src + first * size;
+      tasks[t].a_count = last - first;
+      tasks[t].b = NULL;
+      tasks[t].b_count = 0;
+      tasks[t].dest = self->data + first * size;
+    }
+    _cc_parallel_for(&pool, _cc_sort_merge_task, &job, threads);
+  }
+
+  _cc_parallel_stop(&pool);
+  free(workers);
+  free(bounds);
+  free(tasks);
+  free(temps);
+  free(buffer);
+}
+
+void
+cc_vector_stable_sort(struct cc_vector* self, cc_compare_fn compare)
+{
+  if (!self || !compare || self->size < 2)
+  {
+    return;
+  }
+
+  size_t count = self->size;
+  size_t size = self->element_size;
+  size_t min_run = _cc_timsort_min_run(count);
+  void* temp = malloc(size);
+  if (!temp)
+  {
+    return;
+  }
+
+  struct _cc_timsort t = {
+    .sort = {
+      .element_size = size,
+      .compare = compare,
+      .functions = &self->functions,
+      .trivial = self->functions.relocator == cc_default_relocator,
+      .temp = temp
+    },
+    .buffer = NULL,
+    .min_gallop = _cc_timsort_min_gallop,
+    .run_count = 0
+  };
+
+  // No merge needs room for more than half of the elements.  Without that
+  // room, fall back to a quadratic but still stable insertion sort.
+  if (count > min_run)
+  {
+    t.buffer = malloc(count / 2 * size);
+    if (!t.buffer)
+    {
+      min_run = count;
+    }
+  }
+
+  // Push natural runs, extended to at least min_run elements, and merge as
+  // the run lengths call for it.
+  void* data = self->data;
+  size_t remaining = count;
+  while (remaining > 0)
+  {
+    size_t n = _cc_timsort_count_run(&t.sort, data, remaining);
+    if (n < min_run)
+    {
+      size_t forced = min_run < remaining ? min_run : remaining;
+      _cc_sort_binary_insertion(&t.sort, data, n, forced);
+      n = forced;
+    }
+    t.runs[t.run_count].data = data;
+    t.runs[t.run_count].count = n;
+    ++t.run_count;
+    _cc_timsort_collapse(&t);
+    data += n * size;
+    remaining -= n;
+  }
+  _cc_timsort_force_collapse(&t);
+
+  free(t.buffer);
+  free(temp);
+}
+
+void
+cc_vector_nth_element(struct cc_vector* self,
+                      size_t nth,
+                      cc_compare_fn compare)
+{
+  if (self && compare && nth < self->size && self->size > 1)
+  {
+    void* temp = malloc(self->element_size);
+    if (!temp)
+    {
+      return;
+    }
+
+    struct _cc_sort s = {
+      .element_size = self->element_size,
+      .compare = compare,
+      .functions = &self->functions,
+      .trivial = self->functions.relocator == cc_default_relocator,
+      .temp = temp
+    };
+    size_t depth = _cc_sort_depth(self->size);
+    _cc_sort_select(&s, self->data, self->size, nth, depth);
+
+    free(temp);
+  }
+}
+
+void
+cc_vector_partial_sort(struct cc_vector* self,
+                       size_t count,
+                       cc_compare_fn compare)
+{
+  if (self && compare && count > 0 && self->size > 1)
+  {
+    if (count >= self->size)
+    {
+      cc_vector_sort(self, compare);
+      return;
+    }
+
+    void* temp = malloc(self->element_size);
+    if (!temp)
+    {
+      return;
+    }
+
+    // Select the last of the first count elements, then sort the ones in
+    // front of it.
+    struct _cc_sort s = {
+      .element_size = self->element_size,
+      .compare = compare,
+      .functions = &self->functions,
+      .trivial = self->functions.relocator == cc_default_relocator,
+      .temp = temp
+    };
+    size_t depth = _cc_sort_depth(self->size);
+    _cc_sort_select(&s, self->data, self->size, count - 1, depth);
+    _cc_sort_intro(&s, self->data, count - 1, _cc_sort_depth(count - 1));
+
+    free(temp);
+  }
+}
+
+bool
+cc_vector_top_k(const struct cc_vector* self,
+                size_t k,
+                cc_compare_fn compare,
+                struct cc_vector* out)
+{
+  if (!self || !compare || !out || out == self
+      || out->element_size != self->element_size)
+  {
+    return false;
+  }
+
+  cc_vector_erase(out, 0, out->size);
+  if (k > self->size)
+  {
+    k = self->size;
+  }
+  if (k == 0)
+  {
+    return true;
+  }
+  cc_vector_reserve(out, k);
+  void* temp = malloc(self->element_size);
+  if (out->capacity < k || !temp)
+  {
+    free(temp);
+    return false;
+  }
+
+  // Keep the best k elements seen so far in a max-heap, so each of the
+  // others costs one comparison against the worst of them.
+  struct _cc_sort s = {
+    .element_size = out->element_size,
+    .compare = compare,
+    .functions = &out->functions,
+    .trivial = out->functions.relocator == cc_default_relocator,
+    .temp = temp
+  };
+  size_t size = self->element_size;
+  const void* element = self->data;
+  for (size_t n = 0; n < self->size; ++n, element += size)
+  {
+    if (out->size < k)
+    {
+      cc_vector_push_back(out, element);
+      _cc_sort_sift_up(&s, out->data, out->size - 1);
+    }
+    else if (compare(element, out->data, size) < 0)
+    {
+      cc_vector_set(out, 0, element);
+      _cc_sort_sift_down(&s, out->data, 0, k);
+    }
+  }
+  _cc_sort_heap_pop_all(&s, out->data, k);
+
+  free(temp);
+  return true;
+}
+
+uint64_t
+_cc_radix_key(const struct _cc_radix* r, const void* element)
+{
+  if (r->key)
+  {
+    return r->key(element, r->arg);
+  }
+
+  // Map the key onto an unsigned integer with the same order.
+  const void* p = element + r->offset;
+  uint64_t bits;
+  switch (r->key_size)
+  {
+    case 1:
+    {
+      uint8_t x;
+      memcpy(&x, p, 1);
+      bits = x;
+      break;
+    }
+    case 2:
+    {
+      uint16_t x;
+      memcpy(&x, p, 2);
+      bits = x;
+      break;
+    }
+    case 4:
+    {
+      uint32_t x;
+      memcpy(&x, p, 4);
+      bits = x;
+      break;
+    }
+    default:
+    {
+      memcpy(&bits, p, 8);
+      break;
+    }
+  }
+
+  uint64_t sign = (uint64_t) 1 << (8 * r->key_size - 1);
+  switch (r->type)
+  {
+    case CC_RADIX_SIGNED:
+      return bits ^ sign;
+    case CC_RADIX_FLOAT:
+      return bits & sign ? ~bits & (sign | (sign - 1)) : bits | sign;
+    default:
+      return bits;
+  }
+}
+
+void
+_cc_radix_move(const struct _cc_radix* r, void* dest, void* src)
+{
+  // Constant sizes let the compiler turn the common records into plain
+  // loads and stores.
+  if (!r->trivial)
+  {
+    cc_relocate(r->functions, dest, src, r->element_size);
+    return;
+  }
+  switch (r->element_size)
+  {
+    case 4:
+      memcpy(dest, src, 4);
+      break;
+    case 8:
+      memcpy(dest, src, 8);
+      break;
+    case 16:
+      memcpy(dest, src, 16);
+      break;
+    default:
+      memcpy(dest, src, r->element_size);
+      break;
+  }
+}
+
+void
+_cc_radix_count_all(void* arg, size_t chunk, size_t worker)
+{
+  struct _cc_radix_job* job = (struct _cc_radix_job*) arg;
+  const struct _cc_radix* r = &job->radix;
+  size_t size = r->element_size;
+  size_t digits = job->digits;
+  size_t* counts = job->counts + chunk * digits * 256;
+  memset(counts, 0, digits * 256 * sizeof(size_t));
+
+  size_t first = _cc_split(job->count, job->chunks, chunk);
+  size_t last = _cc_split(job->count, job->chunks, chunk + 1);
+  const void* element = job->src + first * size;
+  for (size_t n = first; n < last; ++n, element += size)
+  {
+    uint64_t key = _cc_radix_key(r, element);
+    for (size_t d = 0; d < digits; ++d, key >>= 8)
+    {
+      ++counts[d * 256 + (key & 255)];
+    }
+  }
+}
+
+void
+_cc_radix_count(void* arg, size_t chunk, size_t worker)
+{
+  struct _cc_radix_job* job = (struct _cc_radix_job*) arg;
+  const struct _cc_radix* r = &job->radix;
+  size_t size = r->element_size;
+  size_t shift = 8 * job->digit;
+  size_t* counts = job->counts + (chunk * job->digits + job->digit) * 256;
+  memset(counts, 0, 256 * sizeof(size_t));
+
+  size_t first = _cc_split(job->count, job->chunks, chunk);
+  size_t last = _cc_split(job->count, job->chunks, chunk + 1);
+  const void* element = job->src + first * size;
+  for (size_t n = first; n < last; ++n, element += size)
+  {
+    ++counts[(_cc_radix_key(r, element) >> shift) & 255];
+  }
+}
+
+void
+_cc_radix_scatter(void* arg, size_t chunk, size_t worker)
+{
+  struct _cc_radix_job* job = (struct _cc_radix_job*) arg;
+  const struct _cc_radix* r = &job->radix;
+  size_t size = r->element_size;
+  size_t shift = 8 * job->digit;
+  size_t* offsets = job->counts + (chunk * job->digits + job->digit) * 256;
+
+  size_t first = _cc_split(job->count, job->chunks, chunk);
+  size_t last = _cc_split(job->count, job->chunks, chunk + 1);
+  void* element = job->src + first * size;
+  for (size_t n = first; n < last; ++n, element += size)
+  {
+    size_t bucket = (_cc_radix_key(r, element) >> shift) & 255;
+    void* dest = job->dst + offsets[bucket]++ * size;
+    _cc_radix_move(r, dest, element);
+  }
+}
+
+void
+_cc_radix_copy_back(void* arg, size_t chunk, size_t worker)
+{
+  struct _cc_radix_job* job = (struct _cc_radix_job*) arg;
+  const struct _cc_radix* r = &job->radix;
+  size_t size = r->element_size;
+  size_t first = _cc_split(job->count, job->chunks, chunk);
+  size_t last = _cc_split(job->count, job->chunks, chunk + 1);
+  cc_relocate_range(
+      r->functions,
+      job->dst + first * size,
+      job->src + first * size,
+      last - first,
+      size
+    );
+}
+
+bool
+_cc_radix_sort(struct cc_vector* self,
+               struct _cc_radix* r,
+               size_t digits,
+               size_t threads)
+{
+  size_t count = self->size;
+  size_t size = self->element_size;
+  r->element_size = size;
+  r->functions = &self->functions;
+  r->trivial = self->functions.relocator == cc_default_relocator;
+  if (count < 2)
+  {
+    return true;
+  }
+
+  threads = _cc_parallel_threads(count, threads);
+  void* buffer = malloc(count * size);
+  size_t* counts = malloc(threads * digits * 256 * sizeof(size_t));
+  struct _cc_parallel_worker* workers = malloc(threads * sizeof(*workers));
+  if (!buffer || !counts || !workers)
+  {
+    free(workers);
+    free(counts);
+    free(buffer);
+    return false;
+  }
+
+  struct _cc_radix_job job = {
+    .radix = *r,
+    .src = self->data,
+    .dst = buffer,
+    .count = count,
+    .chunks = threads,
+    .digits = digits,
+    .digit = 0,
+    .counts = counts
+  };
+
+  struct _cc_parallel pool;
+  _cc_parallel_start(&pool, workers, threads);
+
+  // Count every digit of every chunk up front, so that the passes over
+  // digits that are the same for all keys can be skipped.  With a single
+  // chunk these counts stay valid for every pass; otherwise each chunk is
+  // recounted after the elements have moved.
+  _cc_parallel_for(&pool, _cc_radix_count_all, &job, threads);
+  bool counted = true;
+  for (size_t d = 0; d < digits; ++d)
+  {
+    bool skip = false;
+    for (size_t b = 0; b < 256 && !skip; ++b)
+    {
+      size_t total = 0;
+      for (size_t c = 0; c < threads; ++c)
+      {
+        total += counts[(c * digits + d) * 256 + b];
+      }
+      skip = total == count;
+    }
+    if (skip)
+    {
+      continue;
+    }
+
+    job.digit = d;
+    if (!counted)
+    {
+      _cc_parallel_for(&pool, _cc_radix_count, &job, threads);
+    }
+    counted = threads == 1;
+
+    // Each chunk scatters its elements of a bucket after those of the
+    // chunks before it, which keeps the sort stable.
+    size_t offset = 0;
+    for (size_t b = 0; b < 256; ++b)
+    {
+      for (size_t c = 0; c < threads; ++c)
+      {
+        size_t* x = counts + (c * digits + d) * 256 + b;
+        size_t n = *x;
+        *x = offset;
+        offset += n;
+      }
+    }
+    _cc_parallel_for(&pool, _cc_radix_scatter, &job, threads);
+
+    void* swap = job.src;
+    job.src = job.dst;
+    job.dst = swap;
+  }
+
+  if (job.src != self->data)
+  {
+    job.dst = self->data;
+    _cc_parallel_for(&pool, _cc_radix_copy_back, &job, threads);
+  }
+
+  _cc_parallel_stop(&pool);
+  free(workers);
+  free(counts);
+  free(buffer);
+  return true;
+}
+
+bool
+_cc_radix_valid(size_t element_size,
+                size_t offset,
+                size_t key_size,
+                enum cc_radix_key type)
+{
+  bool sized = key_size == 1 || key_size == 2 || key_size == 4
+            || key_size == 8;
+  bool typed = type == CC_RADIX_UNSIGNED || type == CC_RADIX_SIGNED
+            || (type == CC_RADIX_FLOAT && key_size >= 4);
+  return sized && typed && offset <= element_size
+      && key_size <= element_size - offset;
+}
+
+bool
+cc_vector_radix_sort(struct cc_vector* self,
+                     size_t offset,
+                     size_t key_size,
+                     enum cc_radix_key type)
+{
+  return cc_vector_parallel_radix_sort(self, offset, key_size, type, 1);
+}
+
+bool
+cc_vector_radix_sort_by(struct cc_vector* self,
+                        cc_radix_key_fn key,
+                        void* arg)
+{
+  return cc_vector_parallel_radix_sort_by(self, key, arg, 1);
+}
+
+bool
+cc_vector_parallel_radix_sort(struct cc_vector* self,
+                              size_t offset,
+                              size_t key_size,
+                              enum cc_radix_key type,
+                              size_t threads)
+{
+  if (self && _cc_radix_valid(self->element_size, offset, key_size, type))
+  {
+    struct _cc_radix r = {
+      .offset = offset,
+      .key_size = key_size,
+      .type = type,
+      .key = NULL,
+      .arg = NULL
+    };
+    return _cc_radix_sort(self, &r, key_size, threads);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+bool
+cc_vector_parallel_radix_sort_by(struct cc_vector* self,
+                                 cc_radix_key_fn key,
+                                 void* arg,
+                                 size_t threads)
+{
+  if (self && key)
+  {
+    struct _cc_radix r = {
+      .offset = 0,
+      .key_size = sizeof(uint64_t),
+      .type = CC_RADIX_UNSIGNED,
+      .key = key,
+      .arg = arg
+    };
+    return _cc_radix_sort(self, &r, sizeof(uint64_t), threads);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+struct _cc_set
+_cc_set_init(size_t element_size, cc_compare_fn compare)
+{
+  // Recognize the typed integer comparators, so that the common searches
+  // and merges compare inline instead of through a function pointer.
+  struct _cc_set t = {
+    .element_size = element_size,
+    .compare = compare,
+    .key = _cc_set_other
+  };
+  if (compare == cc_int_comparator && element_size == sizeof(int))
+  {
+    t.key = _cc_set_int;
+  }
+  else if (compare == cc_uint32_comparator && element_size == 4)
+  {
+    t.key = _cc_set_uint32;
+  }
+  else if (compare == cc_int64_comparator && element_size == 8)
+  {
+    t.key = _cc_set_int64;
+  }
+  else if (compare == cc_uint64_comparator && element_size == 8)
+  {
+    t.key = _cc_set_uint64;
+  }
+  return t;
+}
+
+int
+_cc_set_compare(const struct _cc_set* t, const void* left, const void* right)
+{
+  switch (t->key)
+  {
+    case _cc_set_int:
+    {
+      int a = *(const int*) left;
+      int b = *(const int*) right;
+      return (a > b) - (a < b);
+    }
+    case _cc_set_uint32:
+    {
+      uint32_t a = *(const uint32_t*) left;
+      uint32_t b = *(const uint32_t*) right;
+      return (a > b) - (a < b);
+    }
+    case _cc_set_int64:
+    {
+      int64_t a = *(const int64_t*) left;
+      int64_t b = *(const int64_t*) right;
+      return (a > b) - (a < b);
+    }
+    case _cc_set_uint64:
+    {
+      uint64_t a = *(const uint64_t*) left;
+      uint64_t b = *(const uint64_t*) right;
+      return (a > b) - (a < b);
+    }
+    default:
+      return t->compare(left, right, t->element_size);
+  }
+}
+
+size_t
+_cc_set_lower_bound(const struct _cc_set* t,
+                    const void* data,
+                    size_t first,
+                    size_t last,
+                    const void* value)
+{
+  size_t size = t->element_size;
+  size_t count = last - first;
+  while (count > 0)
+  {
+    size_t half = count / 2;
+    if (_cc_set_compare(t, data + (first + half) * size, value) < 0)
+    {
+      first += half + 1;
+      count -= half + 1;
+    }
+    else
+    {
+      count = half;
+    }
+  }
+  return first;
+}
+
+size_t
+_cc_set_upper_bound(const struct _cc_set* t,
+                    const void* data,
+                    size_t first,
+                    size_t last,
+                    const void* value)
+{
+  size_t size = t->element_size;
+  size_t count = last - first;
+  while (count > 0)
+  {
+    size_t half = count / 2;
+    if (_cc_set_compare(t, value, data + (first + half) * size) < 0)
+    {
+      count = half;
+    }
+    else
+    {
+      first += half + 1;
+      count -= half + 1;
+    }
+  }
+  return first;
+}
+
+size_t
+_cc_set_gallop(const struct _cc_set* t,
+               const void* data,
+               size_t first,
+               size_t last,
+               const void* value,
+               bool upper)
+{
+  // Find the lower or upper bound of value at or after first by probing at
+  // distances that double, so the cost grows with the distance moved rather
+  // than with the length of the range.
+  size_t size = t->element_size;
+  int limit = upper ? 0 : -1;
+  size_t step = 1;
+  size_t lo = first;
+  size_t hi = first;
+  while (hi < last && _cc_set_compare(t, data + hi * size, value) <= limit)
+  {
+    lo = hi + 1;
+    hi = step < last - hi ? hi + step : last;
+    step *= 2;
+  }
+  return upper ? _cc_set_upper_bound(t, data, lo, hi, value)
+               : _cc_set_lower_bound(t, data, lo, hi, value);
+}
+
+bool
+_cc_set_prepare(const struct cc_vector* a,
+                const struct cc_vector* b,
+                struct cc_vector* out,
+                size_t count)
+{
+  // Empty out and make room for count elements, so that nothing fails
+  // part of the way through.
+  if (!a || !b || !out || out == a || out == b
+      || a->element_size != b->element_size
+      || out->element_size != a->element_size)
+  {
+    return false;
+  }
+  cc_vector_erase(out, 0, out->size);
+  cc_vector_reserve(out, count);
+  return out->capacity >= count;
+}
+
+size_t
+_cc_set_intersection32(const uint32_t* a,
+                       size_t a_count,
+                       const uint32_t* b,
+                       size_t b_count,
+                       bool is_signed,
+                       uint32_t* out)
+{
+  // Flipping the sign bit orders signed keys as unsigned ones.
+  uint32_t bias = is_signed ? UINT32_C(0x80000000) : 0;
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+#if defined(__SSE2__)
+  // Compare blocks of four keys from each side all against each other, and
+  // only step through the keys one by one when the blocks share one.
+  while (i + 4 <= a_count && j + 4 <= b_count)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+    __m128i y = _mm_loadu_si128((const __m128i*) (b + j));
+    __m128i match = _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi32(x, y),
+            _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(0, 3, 2, 1)))
+          ),
+        _mm_or_si128(
+            _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2))),
+            _mm_cmpeq_epi32(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(2, 1, 0, 3)))
+          )
+      );
+    if (_mm_movemask_epi8(match) == 0)
+    {
+      // Whichever block ends lower cannot match anything further on.
+      if ((a[i + 3] ^ bias) < (b[j + 3] ^ bias))
+      {
+        i += 4;
+      }
+      else
+      {
+        j += 4;
+      }
+      continue;
+    }
+
+    size_t i_end = i + 4;
+    size_t j_end = j + 4;
+    while (i < i_end && j < j_end)
+    {
+      uint32_t x = a[i] ^ bias;
+      uint32_t y = b[j] ^ bias;
+      if (x < y)
+      {
+        ++i;
+      }
+      else if (y < x)
+      {
+        ++j;
+      }
+      else
+      {
+        out[k++] = a[i++];
+        ++j;
+      }
+    }
+  }
+#endif
+  while (i < a_count && j < b_count)
+  {
+    uint32_t x = a[i] ^ bias;
+    uint32_t y = b[j] ^ bias;
+    if (x < y)
+    {
+      ++i;
+    }
+    else if (y < x)
+    {
+      ++j;
+    }
+    else
+    {
+      out[k++] = a[i++];
+      ++j;
+    }
+  }
+  return k;
+}
+
+#if defined(__SSE2__)
+__m128i
+_cc_cmpeq_epi64(__m128i x, __m128i y)
+{
+#if defined(__SSE4_1__)
+  return _mm_cmpeq_epi64(x, y);
+#else
+  // Two 64-bit keys are equal when both of their 32-bit halves are.
+  __m128i halves = _mm_cmpeq_epi32(x, y);
+  return _mm_and_si128(
+      halves,
+      _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))
+    );
+#endif
+}
+#endif
+
+size_t
+_cc_set_intersection64(const uint64_t* a,
+                       size_t a_count,
+                       const uint64_t* b,
+                       size_t b_count,
+                       bool is_signed,
+                       uint64_t* out)
+{
+  uint64_t bias = is_signed ? UINT64_C(0x8000000000000000) : 0;
+  size_t i = 0;
+  size_t j = 0;
+  size_t k = 0;
+#if defined(__SSE2__)
+  // As in _cc_set_intersection32(), but with blocks of two keys.
+  while (i + 2 <= a_count && j + 2 <= b_count)
+  {
+    __m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+    __m128i y = _mm_loadu_si128((const __m128i*) (b + j));
+    __m128i match = _mm_or_si128(
+        _cc_cmpeq_epi64(x, y),
+        _cc_cmpeq_epi64(x, _mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)))
+      );
+    if (_mm_movemask_epi8(match) == 0)
+    {
+      if ((a[i + 1] ^ bias) < (b[j + 1] ^ bias))
+      {
+        i += 2;
+      }
+      else
+      {
+        j += 2;
+      }
+      continue;
+    }
+
+    size_t i_end = i + 2;
+    size_t j_end = j + 2;
+    while (i < i_end && j < j_end)
+    {
+      uint64_t x = a[i] ^ bias;
+      uint64_t y = b[j] ^ bias;
+      out[k] = a[i];
+      k += x == y;
+      i += x <= y;
+      j += y <= x;
+    }
+  }
+#endif
+  while (i < a_count && j < b_count)
+  {
+    uint64_t x = a[i] ^ bias;
+    uint64_t y = b[j] ^ bias;
+    out[k] = a[i];
+    k += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return k;
+}
+
+size_t
+cc_vector_lower_bound(const struct cc_vector* self,
+                      const void* value,
+                      cc_compare_fn compare)
+{
+  if (self && value && compare)
+  {
+    struct _cc_set t = _cc_set_init(self->element_size, compare);
+    return _cc_set_lower_bound(&t, self->data, 0, self->size, value);
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_vector_upper_bound(const struct cc_vector* self,
+                      const void* value,
+                      cc_compare_fn compare)
+{
+  if (self && value && compare)
+  {
+    struct _cc_set t = _cc_set_init(self->element_size, compare);
+    return _cc_set_upper_bound(&t, self->data, 0, self->size, value);
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_vector_equal_range(const struct cc_vector* self,
+                      const void* value,
+                      cc_compare_fn compare,
+                      size_t* first,
+                      size_t* last)
+{
+  size_t lower = 0;
+  size_t upper = 0;
+  if (self && value && compare)
+  {
+    struct _cc_set t = _cc_set_init(self->element_size, compare);
+    lower = _cc_set_lower_bound(&t, self->data, 0, self->size, value);
+    upper = _cc_set_upper_bound(&t, self->data, lower, self->size, value);
+  }
+  if (first)
+  {
+    *first = lower;
+  }
+  if (last)
+  {
+    *last = upper;
+  }
+}
+
+bool
+cc_vector_binary_search(const struct cc_vector* self,
+                        const void* value,
+                        cc_compare_fn compare)
+{
+  if (self && value && compare)
+  {
+    struct _cc_set t = _cc_set_init(self->element_size, compare);
+    size_t n = _cc_set_lower_bound(&t, self->data, 0, self->size, value);
+    return n < self->size
+        && _cc_set_compare(&t, self->data + n * t.element_size, value) == 0;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+bool
+cc_vector_merge(const struct cc_vector* a,
+                const struct cc_vector* b,
+                cc_compare_fn compare,
+                struct cc_vector* out)
+{
+  if (!compare || !_cc_set_prepare(a, b, out, a && b ? a->size + b->size : 0))
+  {
+    return false;
+  }
+
+  // Copy whole stretches of either side at once, taking a's elements
+  // first among equals.
+  struct _cc_set t = _cc_set_init(a->element_size, compare);
+  size_t size = t.element_size;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a->size && j < b->size)
+  {
+    const void* y = b->data + j * size;
+    size_t n = _cc_set_gallop(&t, a->data, i, a->size, y, true);
+    cc_vector_append_array(out, a->data + i * size, n - i);
+    i = n;
+    if (i < a->size)
+    {
+      const void* x = a->data + i * size;
+      n = _cc_set_gallop(&t, b->data, j, b->size, x, false);
+      cc_vector_append_array(out, b->data + j * size, n - j);
+      j = n;
+    }
+  }
+  cc_vector_append_array(out, a->data + i * size, a->size - i);
+  cc_vector_append_array(out, b->data + j * size, b->size - j);
+  return true;
+}
+
+bool
+cc_vector_set_union(const struct cc_vector* a,
+                    const struct cc_vector* b,
+                    cc_compare_fn compare,
+                    struct cc_vector* out)
+{
+  if (!compare || !_cc_set_prepare(a, b, out, a && b ? a->size + b->size : 0))
+  {
+    return false;
+  }
+
+  struct _cc_set t = _cc_set_init(a->element_size, compare);
+  size_t size = t.element_size;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a->size && j < b->size)
+  {
+    const void* x = a->data + i * size;
+    const void* y = b->data + j * size;
+    int c = _cc_set_compare(&t, x, y);
+    if (c < 0)
+    {
+      cc_vector_push_back(out, x);
+      ++i;
+    }
+    else if (c > 0)
+    {
+      cc_vector_push_back(out, y);
+      ++j;
+    }
+    else
+    {
+      cc_vector_push_back(out, x);
+      ++i;
+      ++j;
+    }
+  }
+  cc_vector_append_array(out, a->data + i * size, a->size - i);
+  cc_vector_append_array(out, b->data + j * size, b->size - j);
+  return true;
+}
+
+bool
+cc_vector_set_intersection(const struct cc_vector* a,
+                           const struct cc_vector* b,
+                           cc_compare_fn compare,
+                           struct cc_vector* out)
+{
+  size_t count = a && b ? (a->size < b->size ? a->size : b->size) : 0;
+  if (!compare || !_cc_set_prepare(a, b, out, count))
+  {
+    return false;
+  }
+
+  struct _cc_set t = _cc_set_init(a->element_size, compare);
+  size_t size = t.element_size;
+  bool skewed = a->size / _cc_set_gallop_ratio > b->size
+             || b->size / _cc_set_gallop_ratio > a->size;
+  bool trivial = out->functions.copier == cc_default_copier;
+  if (!skewed && trivial && (t.key == _cc_set_int || t.key == _cc_set_uint32))
+  {
+    out->size = _cc_set_intersection32(
+        a->data,
+        a->size,
+        b->data,
+        b->size,
+        t.key == _cc_set_int,
+        out->data
+      );
+  }
+  else if (!skewed && trivial
+           && (t.key == _cc_set_int64 || t.key == _cc_set_uint64))
+  {
+    out->size = _cc_set_intersection64(
+        a->data,
+        a->size,
+        b->data,
+        b->size,
+        t.key == _cc_set_int64,
+        out->data
+      );
+  }
+  else if (skewed && a->size < b->size)
+  {
+    // Gallop through the longer side for each element of the shorter one.
+    size_t j = 0;
+    for (size_t i = 0; i < a->size && j < b->size; ++i)
+    {
+      const void* x = a->data + i * size;
+      j = _cc_set_gallop(&t, b->data, j, b->size, x, false);
+      if (j < b->size && _cc_set_compare(&t, b->data + j * size, x) == 0)
+      {
+        cc_vector_push_back(out, x);
+        ++j;
+      }
+    }
+  }
+  else if (skewed)
+  {
+    size_t i = 0;
+    for (size_t j = 0; j < b->size && i < a->size; ++j)
+    {
+      const void* y = b->data + j * size;
+      i = _cc_set_gallop(&t, a->data, i, a->size, y, false);
+      if (i < a->size && _cc_set_compare(&t, a->data + i * size, y) == 0)
+      {
+        cc_vector_push_back(out, a->data + i * size);
+        ++i;
+      }
+    }
+  }
+  else
+  {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a->size && j < b->size)
+    {
+      const void* x = a->data + i * size;
+      int c = _cc_set_compare(&t, x, b->data + j * size);
+      if (c < 0)
+      {
+        ++i;
+      }
+      else if (c > 0)
+      {
+        ++j;
+      }
+      else
+      {
+        cc_vector_push_back(out, x);
+        ++i;
+        ++j;
+      }
+    }
+  }
+  return true;
+}
+
+bool
+cc_vector_set_difference(const struct cc_vector* a,
+                         const struct cc_vector* b,
+                         cc_compare_fn compare,
+                         struct cc_vector* out)
+{
+  if (!compare || !_cc_set_prepare(a, b, out, a ? a->size : 0))
+  {
+    return false;
+  }
+
+  // Copy each stretch of a that lies between elements of b at once.
+  struct _cc_set t = _cc_set_init(a->element_size, compare);
+  size_t size = t.element_size;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a->size && j < b->size)
+  {
+    const void* y = b->data + j * size;
+    size_t n = _cc_set_gallop(&t, a->data, i, a->size, y, false);
+    cc_vector_append_array(out, a->data + i * size, n - i);
+    i = n;
+    if (i < a->size)
+    {
+      const void* x = a->data + i * size;
+      j = _cc_set_gallop(&t, b->data, j, b->size, x, false);
+      if (j < b->size && _cc_set_compare(&t, b->data + j * size, x) == 0)
+      {
+        ++i;
+        ++j;
+      }
+    }
+  }
+  cc_vector_append_array(out, a->data + i * size, a->size - i);
+  return true;
+}
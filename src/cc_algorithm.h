@@ -0,0 +1,173 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_ALGORITHM_H
+#define CC_ALGORITHM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cc_memory.h"
+#include "cc_vector.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// How a radix sort key is interpreted.  Keys of every type are 1, 2, 4 or 8
+// bytes in the machine's byte order; float keys are 4 or 8 bytes.
+enum cc_radix_key
+{
+  CC_RADIX_UNSIGNED,
+  CC_RADIX_SIGNED,
+  CC_RADIX_FLOAT
+};
+
+// Returns a key whose unsigned order is the order of the given element.
+typedef uint64_t (*cc_radix_key_fn)(const void* element, void* arg);
+
+// Algorithms over the elements of a vector.  Elements are ordered by a
+// cc_compare_fn, which is passed the vector's element size, and are moved
+// with the relocator of the vector's functions, so rearranging a vector never
+// copies or deletes its elements.  The parallel variants split the work over
+// the given number of threads, or over every online processor if that number
+// is zero.
+void
+cc_vector_sort(struct cc_vector* self, cc_compare_fn compare);
+
+void
+cc_vector_parallel_sort(struct cc_vector* self,
+                        cc_compare_fn compare,
+                        size_t threads);
+
+// A stable merge sort that finds the runs already in order, extends short
+// ones by binary insertion and merges them with galloping, so a vector that
+// is nearly sorted is sorted in close to linear time.  It needs a buffer for
+// half of the elements.
+void
+cc_vector_stable_sort(struct cc_vector* self, cc_compare_fn compare);
+
+// Rearranges the vector so the element at nth is the one a sort would put
+// there, with none of the elements before it comparing greater and none of
+// those after it comparing less.  Takes linear time on average.
+void
+cc_vector_nth_element(struct cc_vector* self,
+                      size_t nth,
+                      cc_compare_fn compare);
+
+// Sorts the first count elements of what a full sort would produce, leaving
+// the rest in no particular order.
+void
+cc_vector_partial_sort(struct cc_vector* self,
+                       size_t count,
+                       cc_compare_fn compare);
+
+// Replaces the contents of out, which must have the same element size, with
+// sorted copies of the first k elements a sort of self would produce, in
+// O(n log k) time without rearranging self.  Returns false if out cannot
+// hold them.
+bool
+cc_vector_top_k(const struct cc_vector* self,
+                size_t k,
+                cc_compare_fn compare,
+                struct cc_vector* out);
+
+// Stable LSD radix sorts, one pass per byte of the key, skipping the bytes
+// that are the same for every element.  The key is either key_size bytes at
+// the given offset within each element or the result of a key function.
+// These return false, leaving the vector untouched, if the key does not fit
+// in the element or the sort cannot allocate its buffer.
+bool
+cc_vector_radix_sort(struct cc_vector* self,
+                     size_t offset,
+                     size_t key_size,
+                     enum cc_radix_key type);
+
+bool
+cc_vector_radix_sort_by(struct cc_vector* self,
+                        cc_radix_key_fn key,
+                        void* arg);
+
+bool
+cc_vector_parallel_radix_sort(struct cc_vector* self,
+                              size_t offset,
+                              size_t key_size,
+                              enum cc_radix_key type,
+                              size_t threads);
+
+bool
+cc_vector_parallel_radix_sort_by(struct cc_vector* self,
+                                 cc_radix_key_fn key,
+                                 void* arg,
+                                 size_t threads);
+
+// Binary searches over a vector sorted by compare.  The lower bound is the
+// index of the first element that does not compare less than value and the
+// upper bound that of the first element that compares greater; both are the
+// vector's size if there is no such element.
+size_t
+cc_vector_lower_bound(const struct cc_vector* self,
+                      const void* value,
+                      cc_compare_fn compare);
+
+size_t
+cc_vector_upper_bound(const struct cc_vector* self,
+                      const void* value,
+                      cc_compare_fn compare);
+
+void
+cc_vector_equal_range(const struct cc_vector* self,
+                      const void* value,
+                      cc_compare_fn compare,
+                      size_t* first,
+                      size_t* last);
+
+bool
+cc_vector_binary_search(const struct cc_vector* self,
+                        const void* value,
+                        cc_compare_fn compare);
+
+// Operations on vectors sorted by compare, which replace the contents of out
+// with copies of the result.  The three vectors must have the same element
+// size and out must be neither a nor b.  An element that appears m times in
+// a and n times in b appears m + n times in a merge, max(m, n) times in a
+// union, min(m, n) times in an intersection and max(m - n, 0) times in a
+// difference.  Intersections of vectors of integers sorted by the matching
+// typed comparator take a faster path.  These return false if out cannot
+// hold the result.
+bool
+cc_vector_merge(const struct cc_vector* a,
+                const struct cc_vector* b,
+                cc_compare_fn compare,
+                struct cc_vector* out);
+
+bool
+cc_vector_set_union(const struct cc_vector* a,
+                    const struct cc_vector* b,
+                    cc_compare_fn compare,
+                    struct cc_vector* out);
+
+bool
+cc_vector_set_intersection(const struct cc_vector* a,
+                           const struct cc_vector* b,
+                           cc_compare_fn compare,
+                           struct cc_vector* out);
+
+bool
+cc_vector_set_difference(const struct cc_vector* a,
+                         const struct cc_vector* b,
+                         cc_compare_fn compare,
+                         struct cc_vector* out);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_ALGORITHM_H
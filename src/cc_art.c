@@ -0,0 +1,1253 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_art.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Child pointers that refer to leaves are tagged in their low bit.
+
+bool
+_cc_art_is_leaf(const struct cc_art_node* node)
+{
+  return ((uintptr_t) node & 1) != 0;
+}
+
+struct cc_art_leaf*
+_cc_art_as_leaf(const struct cc_art_node* node)
+{
+  return (struct cc_art_leaf*) ((uintptr_t) node & ~(uintptr_t) 1);
+}
+
+struct cc_art_node*
+_cc_art_tag(const struct cc_art_leaf* leaf)
+{
+  return (struct cc_art_node*) ((uintptr_t) leaf | 1);
+}
+
+size_t
+_cc_art_min(size_t a, size_t b)
+{
+  return a < b ? a : b;
+}
+
+struct cc_art_leaf*
+_cc_art_new_leaf(struct cc_art* self,
+                 const uint8_t* key,
+                 size_t length,
+                 const void* value)
+{
+  // The value and the key share the leaf's allocation.
+  size_t header = (sizeof(struct cc_art_leaf) + 15) & ~(size_t) 15;
+  void* buffer = malloc(header + self->value_size + length);
+  struct cc_art_leaf* leaf = (struct cc_art_leaf*) buffer;
+  if (!leaf)
+  {
+    return NULL;
+  }
+
+  leaf->length = length;
+  leaf->value = buffer + header;
+  leaf->key = (uint8_t*) leaf->value + self->value_size;
+  memcpy(leaf->key, key, length);
+  self->value_functions.copier(leaf->value, value, self->value_size);
+  return leaf;
+}
+
+void
+_cc_art_free_leaf(struct cc_art* self, struct cc_art_leaf* leaf)
+{
+  self->value_functions.deleter(leaf->value);
+  free(leaf);
+}
+
+void
+_cc_art_set_value(struct cc_art* self,
+                  struct cc_art_leaf* leaf,
+                  const void* value)
+{
+  self->value_functions.deleter(leaf->value);
+  self->value_functions.copier(leaf->value, value, self->value_size);
+}
+
+bool
+_cc_art_leaf_matches(const struct cc_art_leaf* leaf,
+                     const uint8_t* key,
+                     size_t length)
+{
+  return leaf->length == length && memcmp(leaf->key, key, length) == 0;
+}
+
+size_t
+_cc_art_node_size(uint8_t type)
+{
+  switch (type)
+  {
+    case CC_ART_NODE4:
+      return sizeof(struct cc_art_node4);
+    case CC_ART_NODE16:
+      return sizeof(struct cc_art_node16);
+    case CC_ART_NODE48:
+      return sizeof(struct cc_art_node48);
+    default:
+      return sizeof(struct cc_art_node256);
+  }
+}
+
+struct cc_art_node*
+_cc_art_new_node(uint8_t type)
+{
+  struct cc_art_node* node = (struct cc_art_node*) calloc(
+      1,
+      _cc_art_node_size(type)
+    );
+  if (node)
+  {
+    node->type = type;
+  }
+  return node;
+}
+
+void
+_cc_art_copy_header(struct cc_art_node* dest, const struct cc_art_node* src)
+{
+  dest->count = src->count;
+  dest->prefix_length = src->prefix_length;
+  memcpy(dest->prefix, src->prefix, CC_ART_MAX_PREFIX);
+  dest->leaf = src->leaf;
+}
+
+struct cc_art_node**
+_cc_art_find_child(struct cc_art_node* node, uint8_t byte)
+{
+  switch (node->type)
+  {
+    case CC_ART_NODE4:
+    {
+      struct cc_art_node4* n = (struct cc_art_node4*) node;
+      for (uint16_t i = 0; i < node->count; ++i)
+      {
+        if (n->keys[i] == byte)
+        {
+          return n->children + i;
+        }
+      }
+      return NULL;
+    }
+    case CC_ART_NODE16:
+    {
+      struct cc_art_node16* n = (struct cc_art_node16*) node;
+#if defined(__SSE2__)
+      // Compare the byte against all sixteen keys at once and mask off the
+      // unused slots.
+      __m128i keys = _mm_loadu_si128((const __m128i*) n->keys);
+      __m128i match = _mm_cmpeq_epi8(_mm_set1_epi8((char) byte), keys);
+      unsigned int mask = (unsigned int) _mm_movemask_epi8(match);
+      mask &= (1u << node->count) - 1;
+      return mask ? n->children + __builtin_ctz(mask) : NULL;
+#else
+      for (uint16_t i = 0; i < node->count; ++i)
+      {
+        if (n->keys[i] == byte)
+        {
+          return n->children + i;
+        }
+      }
+      return NULL;
+#endif
+    }
+    case CC_ART_NODE48:
+    {
+      struct cc_art_node48* n = (struct cc_art_node48*) node;
+      uint8_t slot = n->index[byte];
+      return slot ? n->children + slot - 1 : NULL;
+    }
+    default:
+    {
+      struct cc_art_node256* n = (struct cc_art_node256*) node;
+      return n->children[byte] ? n->children + byte : NULL;
+    }
+  }
+}
+
+bool
+_cc_art_add_child(struct cc_art_node** ref,
+                  struct cc_art_node* node,
+                  uint8_t byte,
+                  struct cc_art_node* child)
+{
+  switch (node->type)
+  {
+    case CC_ART_NODE4:
+    case CC_ART_NODE16:
+    {
+      // Both small layouts keep their keys sorted for ordered traversal.
+      uint16_t capacity = node->type == CC_ART_NODE4 ? 4 : 16;
+      uint8_t* keys = node->type == CC_ART_NODE4
+                    ? ((struct cc_art_node4*) node)->keys
+                    : ((struct cc_art_node16*) node)->keys;
+      struct cc_art_node** children = node->type == CC_ART_NODE4
+                                    ? ((struct cc_art_node4*) node)->children
+                                    : ((struct cc_art_node16*) node)->children;
+      if (node->count < capacity)
+      {
+        uint16_t pos = 0;
+        while (pos < node->count && keys[pos] < byte)
+        {
+          ++pos;
+        }
+        memmove(keys + pos + 1, keys + pos, node->count - pos);
+        memmove(
+            children + pos + 1,
+            children + pos,
+            (node->count - pos) * sizeof(struct cc_art_node*)
+          );
+        keys[pos] = byte;
+        children[pos] = child;
+        ++node->count;
+        return true;
+      }
+
+      struct cc_art_node* grown = _cc_art_new_node(node->type + 1);
+      if (!grown)
+      {
+        return false;
+      }
+      _cc_art_copy_header(grown, node);
+      if (node->type == CC_ART_NODE4)
+      {
+        struct cc_art_node16* n = (struct cc_art_node16*) grown;
+        memcpy(n->keys, keys, 4);
+        memcpy(n->children, children, 4 * sizeof(struct cc_art_node*));
+      }
+      else
+      {
+        struct cc_art_node48* n = (struct cc_art_node48*) grown;
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+          n->index[keys[i]] = i + 1;
+          n->children[i] = children[i];
+        }
+      }
+      free(node);
+      *ref = grown;
+      return _cc_art_add_child(ref, grown, byte, child);
+    }
+    case CC_ART_NODE48:
+    {
+      struct cc_art_node48* n = (struct cc_art_node48*) node;
+      if (node->count < 48)
+      {
+        uint8_t pos = 0;
+        while (n->children[pos])
+        {
+          ++pos;
+        }
+        n->children[pos] = child;
+        n->index[byte] = pos + 1;
+        ++node->count;
+        return true;
+      }
+
+      struct cc_art_node256* grown = (struct cc_art_node256*) _cc_art_new_node(
+          CC_ART_NODE256
+        );
+      if (!grown)
+      {
+        return false;
+      }
+      _cc_art_copy_header(&grown->header, node);
+      for (size_t b = 0; b < 256; ++b)
+      {
+        if (n->index[b])
+        {
+          grown->children[b] = n->children[n->index[b] - 1];
+        }
+      }
+      free(node);
+      *ref = &grown->header;
+      return _cc_art_add_child(ref, *ref, byte, child);
+    }
+    default:
+    {
+      struct cc_art_node256* n = (struct cc_art_node256*) node;
+      n->children[byte] = child;
+      ++node->count;
+      return true;
+    }
+  }
+}
+
+void
+_cc_art_collapse(struct cc_art_node** ref)
+{
+  // A node4 left without children is replaced by its leaf, and one left with
+  // a single child and no leaf is merged into that child.
+  struct cc_art_node* node = *ref;
+  struct cc_art_node4* n = (struct cc_art_node4*) node;
+  if (node->count == 0)
+  {
+    *ref = node->leaf ? _cc_art_tag(node->leaf) : NULL;
+    free(node);
+  }
+  else if (node->count == 1 && !node->leaf)
+  {
+    struct cc_art_node* child = n->children[0];
+    if (!_cc_art_is_leaf(child))
+    {
+      uint8_t prefix[CC_ART_MAX_PREFIX] = { 0 };
+      size_t stored = _cc_art_min(node->prefix_length, CC_ART_MAX_PREFIX);
+      memcpy(prefix, node->prefix, stored);
+      if (stored < CC_ART_MAX_PREFIX)
+      {
+        prefix[stored++] = n->keys[0];
+      }
+      if (stored < CC_ART_MAX_PREFIX)
+      {
+        memcpy(
+            prefix + stored,
+            child->prefix,
+            _cc_art_min(child->prefix_length, CC_ART_MAX_PREFIX - stored)
+          );
+      }
+      child->prefix_length += node->prefix_length + 1;
+      memcpy(child->prefix, prefix, CC_ART_MAX_PREFIX);
+    }
+    *ref = child;
+    free(node);
+  }
+}
+
+void
+_cc_art_shrink(struct cc_art_node** ref)
+{
+  struct cc_art_node* node = *ref;
+  struct cc_art_node* shrunk = _cc_art_new_node(node->type - 1);
+  if (!shrunk)
+  {
+    return;
+  }
+  _cc_art_copy_header(shrunk, node);
+
+  switch (node->type)
+  {
+    case CC_ART_NODE16:
+    {
+      struct cc_art_node16* n = (struct cc_art_node16*) node;
+      struct cc_art_node4* s = (struct cc_art_node4*) shrunk;
+      memcpy(s->keys, n->keys, node->count);
+      memcpy(
+          s->children,
+          n->children,
+          node->count * sizeof(struct cc_art_node*)
+        );
+      break;
+    }
+    case CC_ART_NODE48:
+    {
+      struct cc_art_node48* n = (struct cc_art_node48*) node;
+      struct cc_art_node16* s = (struct cc_art_node16*) shrunk;
+      uint8_t pos = 0;
+      for (size_t b = 0; b < 256; ++b)
+      {
+        if (n->index[b])
+        {
+          s->keys[pos] = (uint8_t) b;
+          s->children[pos++] = n->children[n->index[b] - 1];
+        }
+      }
+      break;
+    }
+    default:
+    {
+      struct cc_art_node256* n = (struct cc_art_node256*) node;
+      struct cc_art_node48* s = (struct cc_art_node48*) shrunk;
+      uint8_t pos = 0;
+      for (size_t b = 0; b < 256; ++b)
+      {
+        if (n->children[b])
+        {
+          s->index[b] = pos + 1;
+          s->children[pos++] = n->children[b];
+        }
+      }
+      break;
+    }
+  }
+
+  free(node);
+  *ref = shrunk;
+}
+
+void
+_cc_art_remove_child(struct cc_art_node** ref,
+                     struct cc_art_node* node,
+                     uint8_t byte,
+                     struct cc_art_node** slot)
+{
+  switch (node->type)
+  {
+    case CC_ART_NODE4:
+    case CC_ART_NODE16:
+    {
+      uint8_t* keys = node->type == CC_ART_NODE4
+                    ? ((struct cc_art_node4*) node)->keys
+                    : ((struct cc_art_node16*) node)->keys;
+      struct cc_art_node** children = node->type == CC_ART_NODE4
+                                    ? ((struct cc_art_node4*) node)->children
+                                    : ((struct cc_art_node16*) node)->children;
+      size_t pos = slot - children;
+      memmove(keys + pos, keys + pos + 1, node->count - pos - 1);
+      memmove(
+          children + pos,
+          children + pos + 1,
+          (node->count - pos - 1) * sizeof(struct cc_art_node*)
+        );
+      --node->count;
+      if (node->type == CC_ART_NODE4)
+      {
+        _cc_art_collapse(ref);
+      }
+      else if (node->count == 3)
+      {
+        _cc_art_shrink(ref);
+      }
+      break;
+    }
+    case CC_ART_NODE48:
+    {
+      struct cc_art_node48* n = (struct cc_art_node48*) node;
+      n->children[n->index[byte] - 1] = NULL;
+      n->index[byte] = 0;
+      if (--node->count == 12)
+      {
+        _cc_art_shrink(ref);
+      }
+      break;
+    }
+    default:
+    {
+      struct cc_art_node256* n = (struct cc_art_node256*) node;
+      n->children[byte] = NULL;
+      if (--node->count == 37)
+      {
+        _cc_art_shrink(ref);
+      }
+      break;
+    }
+  }
+}
+
+const struct cc_art_leaf*
+_cc_art_minimum(const struct cc_art_node* node)
+{
+  while (!_cc_art_is_leaf(node))
+  {
+    if (node->leaf)
+    {
+      return node->leaf;
+    }
+    switch (node->type)
+    {
+      case CC_ART_NODE4:
+        node = ((const struct cc_art_node4*) node)->children[0];
+        break;
+      case CC_ART_NODE16:
+        node = ((const struct cc_art_node16*) node)->children[0];
+        break;
+      case CC_ART_NODE48:
+      {
+        const struct cc_art_node48* n = (const struct cc_art_node48*) node;
+        size_t b = 0;
+        while (!n->index[b])
+        {
+          ++b;
+        }
+        node = n->children[n->index[b] - 1];
+        break;
+      }
+      default:
+      {
+        const struct cc_art_node256* n = (const struct cc_art_node256*) node;
+        size_t b = 0;
+        while (!n->children[b])
+        {
+          ++b;
+        }
+        node = n->children[b];
+        break;
+      }
+    }
+  }
+  return _cc_art_as_leaf(node);
+}
+
+size_t
+_cc_art_prefix_mismatch(const struct cc_art_node* node,
+                        const uint8_t* key,
+                        size_t length,
+                        size_t depth)
+{
+  // Bytes beyond the stored part of the prefix are read from any leaf below
+  // the node, since all of them share it.
+  size_t limit = _cc_art_min(node->prefix_length, length - depth);
+  size_t stored = _cc_art_min(limit, CC_ART_MAX_PREFIX);
+  size_t n = 0;
+  for (; n < stored; ++n)
+  {
+    if (node->prefix[n] != key[depth + n])
+    {
+      return n;
+    }
+  }
+  if (limit > CC_ART_MAX_PREFIX)
+  {
+    const struct cc_art_leaf* leaf = _cc_art_minimum(node);
+    for (; n < limit; ++n)
+    {
+      if (leaf->key[depth + n] != key[depth + n])
+      {
+        return n;
+      }
+    }
+  }
+  return n;
+}
+
+bool
+_cc_art_check_prefix(const struct cc_art_node* node,
+                     const uint8_t* key,
+                     size_t length,
+                     size_t depth)
+{
+  // Lookups compare only the stored bytes; the leaf comparison at the end
+  // catches any mismatch in the rest.
+  if (depth + node->prefix_length > length)
+  {
+    return false;
+  }
+  size_t stored = _cc_art_min(node->prefix_length, CC_ART_MAX_PREFIX);
+  return memcmp(node->prefix, key + depth, stored) == 0;
+}
+
+bool
+_cc_art_attach(struct cc_art_node** ref, struct cc_art_leaf* leaf, size_t depth)
+{
+  if (leaf->length == depth)
+  {
+    (*ref)->leaf = leaf;
+    return true;
+  }
+  else
+  {
+    return _cc_art_add_child(ref, *ref, leaf->key[depth], _cc_art_tag(leaf));
+  }
+}
+
+bool
+_cc_art_insert(struct cc_art* self,
+               struct cc_art_node** ref,
+               const uint8_t* key,
+               size_t length,
+               size_t depth,
+               const void* value)
+{
+  struct cc_art_node* node = *ref;
+  if (!node)
+  {
+    struct cc_art_leaf* leaf = _cc_art_new_leaf(self, key, length, value);
+    *ref = leaf ? _cc_art_tag(leaf) : NULL;
+    return leaf != NULL;
+  }
+
+  if (_cc_art_is_leaf(node))
+  {
+    struct cc_art_leaf* existing = _cc_art_as_leaf(node);
+    if (_cc_art_leaf_matches(existing, key, length))
+    {
+      _cc_art_set_value(self, existing, value);
+      return false;
+    }
+
+    // Split the leaf into a node4 whose prefix is the common part.
+    size_t limit = _cc_art_min(existing->length, length);
+    size_t common = 0;
+    while (depth + common < limit
+           && existing->key[depth + common] == key[depth + common])
+    {
+      ++common;
+    }
+
+    struct cc_art_leaf* leaf = _cc_art_new_leaf(self, key, length, value);
+    struct cc_art_node* parent = _cc_art_new_node(CC_ART_NODE4);
+    if (!leaf || !parent)
+    {
+      if (leaf)
+      {
+        _cc_art_free_leaf(self, leaf);
+      }
+      free(parent);
+      return false;
+    }
+    parent->prefix_length = (uint32_t) common;
+    memcpy(parent->prefix, key + depth, _cc_art_min(common, CC_ART_MAX_PREFIX));
+    _cc_art_attach(&parent, existing, depth + common);
+    _cc_art_attach(&parent, leaf, depth + common);
+    *ref = parent;
+    return true;
+  }
+
+  if (node->prefix_length > 0)
+  {
+    size_t diff = _cc_art_prefix_mismatch(node, key, length, depth);
+    if (diff < node->prefix_length)
+    {
+      // The key leaves the compressed path part way, so split the path with
+      // a new node4 holding the shared part.
+      struct cc_art_leaf* leaf = _cc_art_new_leaf(self, key, length, value);
+      struct cc_art_node* parent = _cc_art_new_node(CC_ART_NODE4);
+      if (!leaf || !parent)
+      {
+        if (leaf)
+        {
+          _cc_art_free_leaf(self, leaf);
+        }
+        free(parent);
+        return false;
+      }
+      parent->prefix_length = (uint32_t) diff;
+      memcpy(
+          parent->prefix,
+          node->prefix,
+          _cc_art_min(diff, CC_ART_MAX_PREFIX)
+        );
+
+      uint8_t byte;
+      size_t rest = node->prefix_length - diff - 1;
+      if (node->prefix_length <= CC_ART_MAX_PREFIX)
+      {
+        byte = node->prefix[diff];
+        memmove(node->prefix, node->prefix + diff + 1, rest);
+      }
+      else
+      {
+        const struct cc_art_leaf* minimum = _cc_art_minimum(node);
+        byte = minimum->key[depth + diff];
+        memcpy(
+            node->prefix,
+            minimum->key + depth + diff + 1,
+            _cc_art_min(rest, CC_ART_MAX_PREFIX)
+          );
+      }
+      node->prefix_length = (uint32_t) rest;
+
+      _cc_art_add_child(&parent, parent, byte, node);
+      _cc_art_attach(&parent, leaf, depth + diff);
+      *ref = parent;
+      return true;
+    }
+    depth += node->prefix_length;
+  }
+
+  if (depth == length)
+  {
+    if (node->leaf)
+    {
+      _cc_art_set_value(self, node->leaf, value);
+      return false;
+    }
+    node->leaf = _cc_art_new_leaf(self, key, length, value);
+    return node->leaf != NULL;
+  }
+
+  struct cc_art_node** child = _cc_art_find_child(node, key[depth]);
+  if (child)
+  {
+    return _cc_art_insert(self, child, key, length, depth + 1, value);
+  }
+
+  struct cc_art_leaf* leaf = _cc_art_new_leaf(self, key, length, value);
+  if (!leaf)
+  {
+    return false;
+  }
+  if (!_cc_art_add_child(ref, node, key[depth], _cc_art_tag(leaf)))
+  {
+    _cc_art_free_leaf(self, leaf);
+    return false;
+  }
+  return true;
+}
+
+bool
+_cc_art_erase(struct cc_art* self,
+              struct cc_art_node** ref,
+              const uint8_t* key,
+              size_t length,
+              size_t depth)
+{
+  struct cc_art_node* node = *ref;
+  if (_cc_art_is_leaf(node))
+  {
+    struct cc_art_leaf* leaf = _cc_art_as_leaf(node);
+    if (!_cc_art_leaf_matches(leaf, key, length))
+    {
+      return false;
+    }
+    _cc_art_free_leaf(self, leaf);
+    *ref = NULL;
+    return true;
+  }
+
+  if (node->prefix_length > 0)
+  {
+    if (!_cc_art_check_prefix(node, key, length, depth))
+    {
+      return false;
+    }
+    depth += node->prefix_length;
+  }
+
+  if (depth == length)
+  {
+    struct cc_art_leaf* leaf = node->leaf;
+    if (!leaf || !_cc_art_leaf_matches(leaf, key, length))
+    {
+      return false;
+    }
+    _cc_art_free_leaf(self, leaf);
+    node->leaf = NULL;
+    if (node->type == CC_ART_NODE4)
+    {
+      _cc_art_collapse(ref);
+    }
+    return true;
+  }
+
+  struct cc_art_node** child = _cc_art_find_child(node, key[depth]);
+  if (!child)
+  {
+    return false;
+  }
+  if (_cc_art_is_leaf(*child))
+  {
+    struct cc_art_leaf* leaf = _cc_art_as_leaf(*child);
+    if (!_cc_art_leaf_matches(leaf, key, length))
+    {
+      return false;
+    }
+    _cc_art_free_leaf(self, leaf);
+    _cc_art_remove_child(ref, node, key[depth], child);
+    return true;
+  }
+  return _cc_art_erase(self, child, key, length, depth + 1);
+}
+
+void
+_cc_art_free(struct cc_art* self, struct cc_art_node* node)
+{
+  if (!node)
+  {
+    return;
+  }
+  if (_cc_art_is_leaf(node))
+  {
+    _cc_art_free_leaf(self, _cc_art_as_leaf(node));
+    return;
+  }
+
+  if (node->leaf)
+  {
+    _cc_art_free_leaf(self, node->leaf);
+  }
+  switch (node->type)
+  {
+    case CC_ART_NODE4:
+    {
+      struct cc_art_node4* n = (struct cc_art_node4*) node;
+      for (uint16_t i = 0; i < node->count; ++i)
+      {
+        _cc_art_free(self, n->children[i]);
+      }
+      break;
+    }
+    case CC_ART_NODE16:
+    {
+      struct cc_art_node16* n = (struct cc_art_node16*) node;
+      for (uint16_t i = 0; i < node->count; ++i)
+      {
+        _cc_art_free(self, n->children[i]);
+      }
+      break;
+    }
+    case CC_ART_NODE48:
+    {
+      struct cc_art_node48* n = (struct cc_art_node48*) node;
+      for (size_t i = 0; i < 48; ++i)
+      {
+        _cc_art_free(self, n->children[i]);
+      }
+      break;
+    }
+    default:
+    {
+      struct cc_art_node256* n = (struct cc_art_node256*) node;
+      for (size_t i = 0; i < 256; ++i)
+      {
+        _cc_art_free(self, n->children[i]);
+      }
+      break;
+    }
+  }
+  free(node);
+}
+
+struct cc_art_node*
+_cc_art_clone(struct cc_art* self, const struct cc_art_node* node)
+{
+  if (!node)
+  {
+    return NULL;
+  }
+  if (_cc_art_is_leaf(node))
+  {
+    const struct cc_art_leaf* leaf = _cc_art_as_leaf(node);
+    struct cc_art_leaf* copy = _cc_art_new_leaf(
+        self,
+        leaf->key,
+        leaf->length,
+        leaf->value
+      );
+    return copy ? _cc_art_tag(copy) : NULL;
+  }
+
+  size_t size = _cc_art_node_size(node->type);
+  struct cc_art_node* copy = (struct cc_art_node*) malloc(size);
+  if (!copy)
+  {
+    return NULL;
+  }
+  memcpy(copy, node, size);
+  if (node->leaf)
+  {
+    copy->leaf = _cc_art_new_leaf(
+        self,
+        node->leaf->key,
+        node->leaf->length,
+        node->leaf->value
+      );
+  }
+
+  size_t count;
+  struct cc_art_node** children;
+  switch (node->type)
+  {
+    case CC_ART_NODE4:
+      count = node->count;
+      children = ((struct cc_art_node4*) copy)->children;
+      break;
+    case CC_ART_NODE16:
+      count = node->count;
+      children = ((struct cc_art_node16*) copy)->children;
+      break;
+    case CC_ART_NODE48:
+      count = 48;
+      children = ((struct cc_art_node48*) copy)->children;
+      break;
+    default:
+      count = 256;
+      children = ((struct cc_art_node256*) copy)->children;
+      break;
+  }
+  for (size_t i = 0; i < count; ++i)
+  {
+    children[i] = _cc_art_clone(self, children[i]);
+  }
+  return copy;
+}
+
+void
+_cc_art_visit(const struct cc_art_node* node, cc_art_visit_fn visit, void* arg)
+{
+  if (_cc_art_is_leaf(node))
+  {
+    struct cc_art_leaf* leaf = _cc_art_as_leaf(node);
+    visit(leaf->key, leaf->length, leaf->value, arg);
+    return;
+  }
+
+  // A key ending at this node sorts before every key that continues past it.
+  if (node->leaf)
+  {
+    visit(node->leaf->key, node->leaf->length, node->leaf->value, arg);
+  }
+  switch (node->type)
+  {
+    case CC_ART_NODE4:
+    {
+      const struct cc_art_node4* n = (const struct cc_art_node4*) node;
+      for (uint16_t i = 0; i < node->count; ++i)
+      {
+        _cc_art_visit(n->children[i], visit, arg);
+      }
+      break;
+    }
+    case CC_ART_NODE16:
+    {
+      const struct cc_art_node16* n = (const struct cc_art_node16*) node;
+      for (uint16_t i = 0; i < node->count; ++i)
+      {
+        _cc_art_visit(n->children[i], visit, arg);
+      }
+      break;
+    }
+    case CC_ART_NODE48:
+    {
+      const struct cc_art_node48* n = (const struct cc_art_node48*) node;
+      for (size_t b = 0; b < 256; ++b)
+      {
+        if (n->index[b])
+        {
+          _cc_art_visit(n->children[n->index[b] - 1], visit, arg);
+        }
+      }
+      break;
+    }
+    default:
+    {
+      const struct cc_art_node256* n = (const struct cc_art_node256*) node;
+      for (size_t b = 0; b < 256; ++b)
+      {
+        if (n->children[b])
+        {
+          _cc_art_visit(n->children[b], visit, arg);
+        }
+      }
+      break;
+    }
+  }
+}
+
+struct cc_art*
+cc_art_new(size_t value_size)
+{
+  return cc_art_new_f(value_size, cc_default_functions);
+}
+
+struct cc_art*
+cc_art_new_f(size_t value_size, const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_art));
+  struct cc_art* self = (struct cc_art*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->size = 0;
+  self->value_size = value_size;
+  self->value_functions = value_functions;
+  self->root = NULL;
+
+  return self;
+}
+
+struct cc_art*
+cc_art_copy(const struct cc_art* other)
+{
+  struct cc_art* self = cc_art_new_f(other->value_size, other->value_functions);
+  if (self)
+  {
+    self->root = _cc_art_clone(self, other->root);
+    self->size = other->size;
+  }
+  return self;
+}
+
+void
+cc_art_delete(struct cc_art* self)
+{
+  if (self)
+  {
+    _cc_art_free(self, self->root);
+    free(self);
+  }
+}
+
+bool
+cc_art_empty(const struct cc_art* self)
+{
+  if (self)
+  {
+    return self->size == 0;
+  }
+  else
+  {
+    return true;
+  }
+}
+
+size_t
+cc_art_size(const struct cc_art* self)
+{
+  if (self)
+  {
+    return self->size;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_art_clear(struct cc_art* self)
+{
+  if (self)
+  {
+    _cc_art_free(self, self->root);
+    self->root = NULL;
+    self->size = 0;
+  }
+}
+
+void
+cc_art_insert(struct cc_art* self,
+              const void* key,
+              size_t length,
+              const void* value)
+{
+  if (self && key && value)
+  {
+    if (_cc_art_insert(self, &self->root, key, length, 0, value))
+    {
+      ++self->size;
+    }
+  }
+}
+
+void
+cc_art_erase(struct cc_art* self, const void* key, size_t length)
+{
+  if (self && self->root && key)
+  {
+    if (_cc_art_erase(self, &self->root, key, length, 0))
+    {
+      --self->size;
+    }
+  }
+}
+
+void*
+cc_art_find(const struct cc_art* self, const void* key, size_t length)
+{
+  if (!self || !key)
+  {
+    return NULL;
+  }
+
+  const uint8_t* bytes = (const uint8_t*) key;
+  struct cc_art_node* node = self->root;
+  size_t depth = 0;
+  while (node)
+  {
+    if (_cc_art_is_leaf(node))
+    {
+      struct cc_art_leaf* leaf = _cc_art_as_leaf(node);
+      return _cc_art_leaf_matches(leaf, bytes, length) ? leaf->value : NULL;
+    }
+    if (node->prefix_length > 0)
+    {
+      if (!_cc_art_check_prefix(node, bytes, length, depth))
+      {
+        return NULL;
+      }
+      depth += node->prefix_length;
+    }
+    if (depth == length)
+    {
+      struct cc_art_leaf* leaf = node->leaf;
+      return leaf && _cc_art_leaf_matches(leaf, bytes, length)
+           ? leaf->value
+           : NULL;
+    }
+    struct cc_art_node** child = _cc_art_find_child(node, bytes[depth]);
+    node = child ? *child : NULL;
+    ++depth;
+  }
+  return NULL;
+}
+
+bool
+cc_art_contains(const struct cc_art* self, const void* key, size_t length)
+{
+  return cc_art_find(self, key, length) != NULL;
+}
+
+void*
+cc_art_longest_prefix(const struct cc_art* self,
+                      const void* key,
+                      size_t length,
+                      size_t* match_length)
+{
+  const uint8_t* bytes = (const uint8_t*) key;
+  const struct cc_art_leaf* best = NULL;
+  struct cc_art_node* node = self && key ? self->root : NULL;
+  size_t depth = 0;
+  while (node)
+  {
+    if (_cc_art_is_leaf(node))
+    {
+      const struct cc_art_leaf* leaf = _cc_art_as_leaf(node);
+      if (leaf->length <= length && memcmp(leaf->key, bytes, leaf->length) == 0)
+      {
+        best = leaf;
+      }
+      break;
+    }
+
+    // Every byte of the path is checked, so a leaf stored at a node on it
+    // is a prefix of the key.
+    if (node->prefix_length > 0)
+    {
+      if (depth + node->prefix_length > length
+          || _cc_art_prefix_mismatch(node, bytes, length, depth)
+             < node->prefix_length)
+      {
+        break;
+      }
+      depth += node->prefix_length;
+    }
+    if (node->leaf)
+    {
+      best = node->leaf;
+    }
+    if (depth == length)
+    {
+      break;
+    }
+    struct cc_art_node** child = _cc_art_find_child(node, bytes[depth]);
+    node = child ? *child : NULL;
+    ++depth;
+  }
+
+  if (match_length)
+  {
+    *match_length = best ? best->length : 0;
+  }
+  return best ? best->value : NULL;
+}
+
+void
+cc_art_for_each(const struct cc_art* self, cc_art_visit_fn visit, void* arg)
+{
+  if (self && self->root && visit)
+  {
+    _cc_art_visit(self->root, visit, arg);
+  }
+}
+
+void
+cc_art_for_each_prefix(const struct cc_art* self,
+                       const void* prefix,
+                       size_t length,
+                       cc_art_visit_fn visit,
+                       void* arg)
+{
+  if (!self || !visit || !prefix)
+  {
+    return;
+  }
+
+  const uint8_t* bytes = (const uint8_t*) prefix;
+  struct cc_art_node* node = self->root;
+  size_t depth = 0;
+  while (node)
+  {
+    if (_cc_art_is_leaf(node))
+    {
+      struct cc_art_leaf* leaf = _cc_art_as_leaf(node);
+      if (leaf->length >= length && memcmp(leaf->key, bytes, length) == 0)
+      {
+        visit(leaf->key, leaf->length, leaf->value, arg);
+      }
+      return;
+    }
+    if (node->prefix_length > 0)
+    {
+      size_t limit = _cc_art_min(node->prefix_length, length - depth);
+      if (_cc_art_prefix_mismatch(node, bytes, length, depth) < limit)
+      {
+        return;
+      }
+      depth += node->prefix_length;
+    }
+    if (depth >= length)
+    {
+      _cc_art_visit(node, visit, arg);
+      return;
+    }
+    struct cc_art_node** child = _cc_art_find_child(node, bytes[depth]);
+    node = child ? *child : NULL;
+    ++depth;
+  }
+}
+
+void
+cc_art_insert_string(struct cc_art* self,
+                     const struct cc_string* key,
+                     const void* value)
+{
+  if (key)
+  {
+    cc_art_insert(self, key->data, key->size, value);
+  }
+}
+
+void
+cc_art_erase_string(struct cc_art* self, const struct cc_string* key)
+{
+  if (key)
+  {
+    cc_art_erase(self, key->data, key->size);
+  }
+}
+
+void*
+cc_art_find_string(const struct cc_art* self, const struct cc_string* key)
+{
+  if (key)
+  {
+    return cc_art_find(self, key->data, key->size);
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void*
+cc_art_longest_prefix_string(const struct cc_art* self,
+                             const struct cc_string* key,
+                             size_t* match_length)
+{
+  if (key)
+  {
+    return cc_art_longest_prefix(self, key->data, key->size, match_length);
+  }
+  else
+  {
+    return NULL;
+  }
+}
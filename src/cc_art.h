@@ -0,0 +1,165 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_ART_H
+#define CC_ART_H
+
+#include "cc_memory.h"
+#include "cc_string.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define CC_ART_NODE4 0
+#define CC_ART_NODE16 1
+#define CC_ART_NODE48 2
+#define CC_ART_NODE256 3
+
+#define CC_ART_MAX_PREFIX 8
+
+// An adaptive radix tree mapping byte strings to values.  Inner nodes branch
+// on one key byte and grow through four layouts (4, 16, 48 and 256 children)
+// as they fill, and chains of single-child nodes are compressed into a
+// prefix of which the first CC_ART_MAX_PREFIX bytes are stored in the node.
+// Keys are kept in byte order, so the tree supports prefix iteration and
+// longest-prefix matching as well as exact lookups.  A key that ends at an
+// inner node is stored in that node's leaf slot.
+struct cc_art_leaf
+{
+  size_t length;
+  void* value;
+  uint8_t* key;
+};
+
+struct cc_art_node
+{
+  uint8_t type;
+  uint16_t count;
+  uint32_t prefix_length;
+  uint8_t prefix[CC_ART_MAX_PREFIX];
+  struct cc_art_leaf* leaf;
+};
+
+struct cc_art_node4
+{
+  struct cc_art_node header;
+  uint8_t keys[4];
+  struct cc_art_node* children[4];
+};
+
+struct cc_art_node16
+{
+  struct cc_art_node header;
+  uint8_t keys[16];
+  struct cc_art_node* children[16];
+};
+
+struct cc_art_node48
+{
+  struct cc_art_node header;
+  uint8_t index[256];
+  struct cc_art_node* children[48];
+};
+
+struct cc_art_node256
+{
+  struct cc_art_node header;
+  struct cc_art_node* children[256];
+};
+
+struct cc_art
+{
+  size_t size;
+  size_t value_size;
+  struct cc_functions value_functions;
+  struct cc_art_node* root;
+};
+
+typedef struct cc_art* cc_art_t;
+
+typedef void (*cc_art_visit_fn)(const void* key,
+                                size_t length,
+                                void* value,
+                                void* arg);
+
+struct cc_art*
+cc_art_new(size_t value_size);
+
+struct cc_art*
+cc_art_new_f(size_t value_size, const struct cc_functions value_functions);
+
+struct cc_art*
+cc_art_copy(const struct cc_art* other);
+
+void
+cc_art_delete(struct cc_art* self);
+
+bool
+cc_art_empty(const struct cc_art* self);
+
+size_t
+cc_art_size(const struct cc_art* self);
+
+void
+cc_art_clear(struct cc_art* self);
+
+void
+cc_art_insert(struct cc_art* self,
+              const void* key,
+              size_t length,
+              const void* value);
+
+void
+cc_art_erase(struct cc_art* self, const void* key, size_t length);
+
+void*
+cc_art_find(const struct cc_art* self, const void* key, size_t length);
+
+bool
+cc_art_contains(const struct cc_art* self, const void* key, size_t length);
+
+void*
+cc_art_longest_prefix(const struct cc_art* self,
+                      const void* key,
+                      size_t length,
+                      size_t* match_length);
+
+void
+cc_art_for_each(const struct cc_art* self, cc_art_visit_fn visit, void* arg);
+
+void
+cc_art_for_each_prefix(const struct cc_art* self,
+                       const void* prefix,
+                       size_t length,
+                       cc_art_visit_fn visit,
+                       void* arg);
+
+void
+cc_art_insert_string(struct cc_art* self,
+                     const struct cc_string* key,
+                     const void* value);
+
+void
+cc_art_erase_string(struct cc_art* self, const struct cc_string* key);
+
+void*
+cc_art_find_string(const struct cc_art* self, const struct cc_string* key);
+
+void*
+cc_art_longest_prefix_string(const struct cc_art* self,
+                             const struct cc_string* key,
+                             size_t* match_length);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_ART_H
@@ -0,0 +1,224 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_bloom.h"
+
+bool
+_cc_bloom_size(struct cc_bloom* self, size_t expected_count)
+{
+  // An optimal filter needs log2(1/p) probes and log2(1/p) / ln(2) bits per
+  // key.  Confining the probes to one block raises the false positive rate
+  // a little, so the bits are padded by a fifth.
+  double probes = cc_log(1.0 / self->false_positive_rate)
+                / 0.6931471805599453;
+  double bits = 1.2 * 1.4427 * probes * (double) expected_count;
+  size_t block_count = (size_t) (bits / (64.0 * CC_BLOOM_BLOCK_WORDS)) + 1;
+  uint32_t hash_count = (uint32_t) (probes + 0.5);
+
+  uint64_t* blocks = (uint64_t*) aligned_alloc(
+      64,
+      block_count * CC_BLOOM_BLOCK_WORDS * sizeof(uint64_t)
+    );
+  if (!blocks)
+  {
+    return false;
+  }
+  memset(blocks, 0, block_count * CC_BLOOM_BLOCK_WORDS * sizeof(uint64_t));
+
+  free(self->blocks);
+  self->blocks = blocks;
+  self->block_count = block_count;
+  self->expected_count = expected_count;
+  self->hash_count = hash_count < 1 ? 1 : hash_count > 16 ? 16 : hash_count;
+  return true;
+}
+
+struct cc_bloom*
+cc_bloom_new(size_t expected_count, double false_positive_rate)
+{
+  void* buffer = malloc(sizeof(struct cc_bloom));
+  struct cc_bloom* self = (struct cc_bloom*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  bool valid = false_positive_rate > 0.0 && false_positive_rate < 1.0;
+  self->false_positive_rate = valid ? false_positive_rate : 0.01;
+  self->blocks = NULL;
+  if (!_cc_bloom_size(self, expected_count))
+  {
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_bloom*
+cc_bloom_copy(const struct cc_bloom* other)
+{
+  struct cc_bloom* self = cc_bloom_new(
+      other->expected_count,
+      other->false_positive_rate
+    );
+  if (self)
+  {
+    memcpy(
+        self->blocks,
+        other->blocks,
+        other->block_count * CC_BLOOM_BLOCK_WORDS * sizeof(uint64_t)
+      );
+  }
+  return self;
+}
+
+void
+cc_bloom_delete(struct cc_bloom* self)
+{
+  if (self)
+  {
+    free(self->blocks);
+    free(self);
+  }
+}
+
+size_t
+cc_bloom_block_count(const struct cc_bloom* self)
+{
+  if (self)
+  {
+    return self->block_count;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+uint32_t
+cc_bloom_hash_count(const struct cc_bloom* self)
+{
+  if (self)
+  {
+    return self->hash_count;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+double
+cc_bloom_false_positive_rate(const struct cc_bloom* self)
+{
+  if (self)
+  {
+    return self->false_positive_rate;
+  }
+  else
+  {
+    return 0.0;
+  }
+}
+
+void
+cc_bloom_clear(struct cc_bloom* self)
+{
+  if (self)
+  {
+    memset(
+        self->blocks,
+        0,
+        self->block_count * CC_BLOOM_BLOCK_WORDS * sizeof(uint64_t)
+      );
+  }
+}
+
+bool
+cc_bloom_reset(struct cc_bloom* self, size_t expected_count)
+{
+  if (self)
+  {
+    return _cc_bloom_size(self, expected_count);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+void
+cc_bloom_add(struct cc_bloom* self, const void* key, size_t size)
+{
+  if (self && key)
+  {
+    cc_bloom_add_hash(self, cc_default_hasher(key, size));
+  }
+}
+
+bool
+cc_bloom_contains(const struct cc_bloom* self, const void* key, size_t size)
+{
+  if (self && key)
+  {
+    return cc_bloom_contains_hash(self, cc_default_hasher(key, size));
+  }
+  else
+  {
+    return false;
+  }
+}
+
+void
+cc_bloom_add_hash(struct cc_bloom* self, uint64_t hash)
+{
+  if (self)
+  {
+    // The high half of the hash picks the block; the low half is stepped by
+    // a rotation of itself to generate the probes within it.
+    size_t block = (size_t) (((hash >> 32) * self->block_count) >> 32);
+    uint64_t* words = self->blocks + block * CC_BLOOM_BLOCK_WORDS;
+    uint32_t h = (uint32_t) hash;
+    uint32_t delta = (h >> 17) | (h << 15);
+    for (uint32_t n = 0; n < self->hash_count; ++n, h += delta)
+    {
+      uint32_t bit = h % (64 * CC_BLOOM_BLOCK_WORDS);
+      words[bit / 64] |= (uint64_t) 1 << (bit % 64);
+    }
+  }
+}
+
+bool
+cc_bloom_contains_hash(const struct cc_bloom* self, uint64_t hash)
+{
+  if (self)
+  {
+    size_t block = (size_t) (((hash >> 32) * self->block_count) >> 32);
+    const uint64_t* words = self->blocks + block * CC_BLOOM_BLOCK_WORDS;
+    uint32_t h = (uint32_t) hash;
+    uint32_t delta = (h >> 17) | (h << 15);
+    for (uint32_t n = 0; n < self->hash_count; ++n, h += delta)
+    {
+      uint32_t bit = h % (64 * CC_BLOOM_BLOCK_WORDS);
+      if (!(words[bit / 64] & ((uint64_t) 1 << (bit % 64))))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_BLOOM_H
+#define CC_BLOOM_H
+
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+#define CC_BLOOM_BLOCK_WORDS 8
+
+// A blocked Bloom filter.  The bits are split into 64-byte blocks, and the
+// high half of a 64-bit hash picks the one block that all of a key's probes
+// fall into, so a lookup touches a single cache line.  Keys can be added and
+// tested directly, or by a hash the caller already has, which is how a
+// cc_map or cc_set with an attached filter uses its stored node hashes.
+struct cc_bloom
+{
+  size_t block_count;
+  size_t expected_count;
+  double false_positive_rate;
+  uint32_t hash_count;
+  uint64_t* blocks;
+};
+
+typedef struct cc_bloom* cc_bloom_t;
+
+struct cc_bloom*
+cc_bloom_new(size_t expected_count, double false_positive_rate);
+
+struct cc_bloom*
+cc_bloom_copy(const struct cc_bloom* other);
+
+void
+cc_bloom_delete(struct cc_bloom* self);
+
+size_t
+cc_bloom_block_count(const struct cc_bloom* self);
+
+uint32_t
+cc_bloom_hash_count(const struct cc_bloom* self);
+
+double
+cc_bloom_false_positive_rate(const struct cc_bloom* self);
+
+void
+cc_bloom_clear(struct cc_bloom* self);
+
+bool
+cc_bloom_reset(struct cc_bloom* self, size_t expected_count);
+
+void
+cc_bloom_add(struct cc_bloom* self, const void* key, size_t size);
+
+bool
+cc_bloom_contains(const struct cc_bloom* self, const void* key, size_t size);
+
+void
+cc_bloom_add_hash(struct cc_bloom* self, uint64_t hash);
+
+bool
+cc_bloom_contains_hash(const struct cc_bloom* self, uint64_t hash);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_BLOOM_H
@@ -0,0 +1,1295 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_btree_map.h"
+
+// Splits leave nodes at least half full and only a root split adds a level,
+// so no tree that fits in memory comes close to this height.
+#define CC_BTREE_MAP_MAX_HEIGHT 64
+
+const size_t cc_btree_map_sizeof = sizeof(struct cc_btree_map);
+
+const size_t _cc_btree_map_key_bytes = 256;
+
+const struct cc_functions cc_btree_map_functions = (struct cc_functions){
+  .hasher = cc_btree_map_hasher,
+  .copier = cc_btree_map_copier,
+  .deleter = cc_btree_map_deleter,
+  .equality = cc_btree_map_equality,
+  .relocator = cc_default_relocator
+};
+
+size_t
+_cc_btree_map_round(size_t size, size_t alignment)
+{
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+// A node is a header followed, for branches, by order + 2 child pointers and
+// then, for both kinds, order + 1 keys and (leaves only) order + 1 values.
+// The extra slot holds an entry while an overfull node is being split.
+size_t
+_cc_btree_map_keys_offset(const struct cc_btree_map* self, bool leaf)
+{
+  size_t offset = _cc_btree_map_round(sizeof(struct cc_btree_node), 16);
+  if (!leaf)
+  {
+    size_t children = (self->order + 2) * sizeof(struct cc_btree_node*);
+    offset += _cc_btree_map_round(children, 16);
+  }
+  return offset;
+}
+
+size_t
+_cc_btree_map_values_offset(const struct cc_btree_map* self)
+{
+  size_t keys = (self->order + 1) * self->key_size;
+  return _cc_btree_map_keys_offset(self, true)
+      + _cc_btree_map_round(keys, 16);
+}
+
+size_t
+_cc_btree_map_node_size(const struct cc_btree_map* self)
+{
+  size_t leaf = _cc_btree_map_values_offset(self)
+      + (self->order + 1) * self->value_size;
+  size_t branch = _cc_btree_map_keys_offset(self, false)
+      + (self->order + 1) * self->key_size;
+  return _cc_btree_map_round(leaf > branch ? leaf : branch, 64);
+}
+
+struct cc_btree_node**
+_cc_btree_map_children(const struct cc_btree_map* self,
+                       const struct cc_btree_node* node)
+{
+  size_t offset = _cc_btree_map_round(sizeof(struct cc_btree_node), 16);
+  return (struct cc_btree_node**) ((char*) node + offset);
+}
+
+void*
+_cc_btree_map_key(const struct cc_btree_map* self,
+                  const struct cc_btree_node* node,
+                  size_t n)
+{
+  return (char*) node
+      + _cc_btree_map_keys_offset(self, node->leaf)
+      + n * self->key_size;
+}
+
+void*
+_cc_btree_map_value(const struct cc_btree_map* self,
+                    const struct cc_btree_node* node,
+                    size_t n)
+{
+  if (self->value_size > 0)
+  {
+    return (char*) node
+        + _cc_btree_map_values_offset(self)
+        + n * self->value_size;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+struct cc_btree_node*
+_cc_btree_map_node_new(const struct cc_btree_map* self, bool leaf)
+{
+  void* buffer = aligned_alloc(64, _cc_btree_map_node_size(self));
+  struct cc_btree_node* node = (struct cc_btree_node*) buffer;
+  if (node)
+  {
+    node->prev = NULL;
+    node->next = NULL;
+    node->count = 0;
+    node->leaf = leaf;
+  }
+  return node;
+}
+
+void
+_cc_btree_map_node_free(struct cc_btree_map* self,
+                        struct cc_btree_node* node,
+                        struct cc_btree_node* keep)
+{
+  if (!node->leaf)
+  {
+    struct cc_btree_node** children = _cc_btree_map_children(self, node);
+    for (size_t n = 0; n <= node->count; ++n)
+    {
+      _cc_btree_map_node_free(self, children[n], keep);
+    }
+  }
+
+  for (size_t n = 0; n < node->count; ++n)
+  {
+    self->key_functions.deleter(_cc_btree_map_key(self, node, n));
+    if (node->leaf && self->value_size > 0)
+    {
+      self->value_functions.deleter(_cc_btree_map_value(self, node, n));
+    }
+  }
+  node->count = 0;
+
+  if (node != keep)
+  {
+    free(node);
+  }
+}
+
+void
+_cc_btree_map_chain_free(struct cc_btree_map* self, struct cc_btree_node* leaf)
+{
+  struct cc_btree_node* next;
+  while (leaf)
+  {
+    next = leaf->next;
+    _cc_btree_map_node_free(self, leaf, NULL);
+    leaf = next;
+  }
+}
+
+// Returns the first position whose key is not less than (or, if upper is
+// set, greater than) the given key.
+size_t
+_cc_btree_map_search(const struct cc_btree_map* self,
+                     const struct cc_btree_node* node,
+                     const void* key,
+                     bool upper)
+{
+  size_t low = 0;
+  size_t high = node->count;
+  while (low < high)
+  {
+    size_t mid = low + (high - low) / 2;
+    int result = self->compare(
+        _cc_btree_map_key(self, node, mid),
+        key,
+        self->key_size
+      );
+    if (result < 0 || (upper && result == 0))
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+struct cc_btree_node*
+_cc_btree_map_leaf(const struct cc_btree_map* self, const void* key)
+{
+  // Separator n is no greater than any key in child n + 1, so keys equal to a
+  // separator are found to its right.
+  struct cc_btree_node* node = self->root;
+  while (!node->leaf)
+  {
+    size_t n = _cc_btree_map_search(self, node, key, true);
+    node = _cc_btree_map_children(self, node)[n];
+  }
+  return node;
+}
+
+bool
+_cc_btree_map_get(const struct cc_btree_map* self,
+                  const void* key,
+                  struct cc_btree_node** leaf,
+                  size_t* position)
+{
+  struct cc_btree_node* node = _cc_btree_map_leaf(self, key);
+  size_t n = _cc_btree_map_search(self, node, key, false);
+  *leaf = node;
+  *position = n;
+  return n < node->count
+      && self->compare(
+          _cc_btree_map_key(self, node, n),
+          key,
+          self->key_size
+        ) == 0;
+}
+
+struct cc_btree_map_iterator
+_cc_btree_map_bound(struct cc_btree_map* self, const void* key, bool upper)
+{
+  struct cc_btree_node* node = _cc_btree_map_leaf(self, key);
+  size_t n = _cc_btree_map_search(self, node, key, upper);
+  if (n == node->count)
+  {
+    node = node->next;
+    n = 0;
+  }
+
+  return (struct cc_btree_map_iterator){
+    .map = self,
+    .node = node,
+    .position = n
+  };
+}
+
+bool
+_cc_btree_map_init(struct cc_btree_map* self,
+                   size_t key_size,
+                   size_t value_size,
+                   cc_compare_fn compare,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions)
+{
+  size_t order = _cc_btree_map_key_bytes / (key_size > 0 ? key_size : 1);
+
+  self->size = 0;
+  self->height = 1;
+  self->order = order < 8 ? 8 : order > 128 ? 128 : order;
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->compare = compare ? compare : cc_default_comparator;
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->root = _cc_btree_map_node_new(self, true);
+  self->first = self->root;
+
+  return self->root != NULL;
+}
+
+// Appends an entry that is not less than any entry already in the map.  Only
+// the leaf chain is extended; _cc_btree_map_build() adds the branches.
+bool
+_cc_btree_map_append(struct cc_btree_map* self,
+                     struct cc_btree_node** last,
+                     const void* key,
+                     const void* value)
+{
+  struct cc_btree_node* leaf = *last;
+  if (leaf->count > 0
+      && self->compare(
+          _cc_btree_map_key(self, leaf, leaf->count - 1),
+          key,
+          self->key_size
+        ) == 0)
+  {
+    if (self->value_size > 0)
+    {
+      void* existing = _cc_btree_map_value(self, leaf, leaf->count - 1);
+      self->value_functions.deleter(existing);
+      self->value_functions.copier(existing, value, self->value_size);
+    }
+    return true;
+  }
+
+  if (leaf->count == self->order)
+  {
+    struct cc_btree_node* next = _cc_btree_map_node_new(self, true);
+    if (!next)
+    {
+      return false;
+    }
+    next->prev = leaf;
+    leaf->next = next;
+    leaf = next;
+    *last = next;
+  }
+
+  self->key_functions.copier(
+      _cc_btree_map_key(self, leaf, leaf->count),
+      key,
+      self->key_size
+    );
+  if (self->value_size > 0)
+  {
+    self->value_functions.copier(
+        _cc_btree_map_value(self, leaf, leaf->count),
+        value,
+        self->value_size
+      );
+  }
+  ++leaf->count;
+  ++self->size;
+
+  return true;
+}
+
+bool
+_cc_btree_map_build(struct cc_btree_map* self)
+{
+  size_t count = 0;
+  for (struct cc_btree_node* leaf = self->first; leaf; leaf = leaf->next)
+  {
+    ++count;
+  }
+
+  // Count the branches level by level and allocate them all first, so that a
+  // failure leaves nothing half built.
+  size_t fanout = self->order + 1;
+  size_t total = 0;
+  for (size_t n = count; n > 1; n = (n + fanout - 1) / fanout)
+  {
+    total += (n + fanout - 1) / fanout;
+  }
+
+  struct cc_btree_node** level = (struct cc_btree_node**) malloc(
+      (count + total) * sizeof(struct cc_btree_node*)
+    );
+  const void** lows = (const void**) malloc(count * sizeof(const void*));
+  if (!level || !lows)
+  {
+    free(level);
+    free(lows);
+    return false;
+  }
+
+  struct cc_btree_node** branches = level + count;
+  for (size_t n = 0; n < total; ++n)
+  {
+    branches[n] = _cc_btree_map_node_new(self, false);
+    if (!branches[n])
+    {
+      while (n > 0)
+      {
+        free(branches[--n]);
+      }
+      free(level);
+      free(lows);
+      return false;
+    }
+  }
+
+  size_t n = 0;
+  for (struct cc_btree_node* leaf = self->first; leaf; leaf = leaf->next, ++n)
+  {
+    level[n] = leaf;
+    lows[n] = _cc_btree_map_key(self, leaf, 0);
+  }
+
+  // Each pass groups the nodes of one level as evenly as possible under new
+  // branches, whose separators are the lowest keys of their children.
+  size_t height = 1;
+  while (count > 1)
+  {
+    size_t groups = (count + fanout - 1) / fanout;
+    size_t source = 0;
+    for (size_t g = 0; g < groups; ++g)
+    {
+      size_t children = count / groups + (g < count % groups ? 1 : 0);
+      struct cc_btree_node* branch = *branches++;
+      struct cc_btree_node** slots = _cc_btree_map_children(self, branch);
+      for (size_t c = 0; c < children; ++c, ++source)
+      {
+        slots[c] = level[source];
+        if (c > 0)
+        {
+          self->key_functions.copier(
+              _cc_btree_map_key(self, branch, c - 1),
+              lows[source],
+              self->key_size
+            );
+        }
+      }
+      branch->count = children - 1;
+      lows[g] = lows[source - children];
+      level[g] = branch;
+    }
+    count = groups;
+    ++height;
+  }
+
+  self->root = level[0];
+  self->height = height;
+
+  free(level);
+  free(lows);
+
+  return true;
+}
+
+uint64_t
+cc_btree_map_hasher(const void* buffer, size_t size)
+{
+  const struct cc_btree_map* self = (const struct cc_btree_map*) buffer;
+
+  uint64_t hash = 0;
+  for (struct cc_btree_node* leaf = self->first; leaf; leaf = leaf->next)
+  {
+    for (size_t n = 0; n < leaf->count; ++n)
+    {
+      cc_hash_combine(&hash, self->key_functions.hasher(
+          _cc_btree_map_key(self, leaf, n),
+          self->key_size
+        ));
+      if (self->value_size > 0)
+      {
+        cc_hash_combine(&hash, self->value_functions.hasher(
+            _cc_btree_map_value(self, leaf, n),
+            self->value_size
+          ));
+      }
+    }
+  }
+
+  return hash;
+}
+
+void*
+cc_btree_map_copier(void* dest, const void* src, size_t size)
+{
+  if (dest && src)
+  {
+    struct cc_btree_map* self = (struct cc_btree_map*) dest;
+    const struct cc_btree_map* other = (const struct cc_btree_map*) src;
+
+    if (!_cc_btree_map_init(
+        self,
+        other->key_size,
+        other->value_size,
+        other->compare,
+        other->key_functions,
+        other->value_functions
+      ))
+    {
+      return NULL;
+    }
+
+    struct cc_btree_node* last = self->first;
+    for (struct cc_btree_node* leaf = other->first; leaf; leaf = leaf->next)
+    {
+      for (size_t n = 0; n < leaf->count; ++n)
+      {
+        if (!_cc_btree_map_append(
+            self,
+            &last,
+            _cc_btree_map_key(other, leaf, n),
+            _cc_btree_map_value(other, leaf, n)
+          ))
+        {
+          _cc_btree_map_chain_free(self, self->first);
+          return NULL;
+        }
+      }
+    }
+
+    if (!_cc_btree_map_build(self))
+    {
+      _cc_btree_map_chain_free(self, self->first);
+      return NULL;
+    }
+
+    return self;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void
+cc_btree_map_deleter(void* ptr)
+{
+  if (ptr)
+  {
+    struct cc_btree_map* self = (struct cc_btree_map*) ptr;
+
+    if (self->root)
+    {
+      _cc_btree_map_node_free(self, self->root, NULL);
+    }
+
+    self->size = 0;
+    self->height = 0;
+    self->order = 0;
+    self->key_size = 0;
+    self->value_size = 0;
+    self->compare = NULL;
+    self->key_functions = cc_default_functions;
+    self->value_functions = cc_default_functions;
+    self->root = NULL;
+    self->first = NULL;
+  }
+}
+
+bool
+cc_btree_map_equality(const void* left, const void* right, size_t size)
+{
+  if (left && right)
+  {
+    const struct cc_btree_map* self = (const struct cc_btree_map*) left;
+    const struct cc_btree_map* other = (const struct cc_btree_map*) right;
+
+    if (self->size != other->size
+        || self->key_size != other->key_size
+        || self->value_size != other->value_size)
+    {
+      return false;
+    }
+
+    // Both maps are sorted, so compare them in a single parallel pass.
+    struct cc_btree_node* a = self->first;
+    struct cc_btree_node* b = other->first;
+    size_t i = 0;
+    size_t j = 0;
+    for (size_t n = 0; n < self->size; ++n)
+    {
+      if (i == a->count)
+      {
+        a = a->next;
+        i = 0;
+      }
+      if (j == b->count)
+      {
+        b = b->next;
+        j = 0;
+      }
+      if (self->compare(
+              _cc_btree_map_key(self, a, i),
+              _cc_btree_map_key(other, b, j),
+              self->key_size
+            ) != 0
+          || (self->value_size > 0
+              && !self->value_functions.equality(
+                  _cc_btree_map_value(self, a, i),
+                  _cc_btree_map_value(other, b, j),
+                  self->value_size
+                )))
+      {
+        return false;
+      }
+      ++i;
+      ++j;
+    }
+
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+struct cc_btree_map*
+cc_btree_map_new(size_t key_size, size_t value_size, cc_compare_fn compare)
+{
+  return cc_btree_map_new_f(
+      key_size,
+      value_size,
+      compare,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_btree_map*
+cc_btree_map_from_sorted_arrays(const void* keys,
+                                const void* values,
+                                size_t count,
+                                size_t key_size,
+                                size_t value_size,
+                                cc_compare_fn compare)
+{
+  return cc_btree_map_from_sorted_arrays_f(
+      keys,
+      values,
+      count,
+      key_size,
+      value_size,
+      compare,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_btree_map*
+cc_btree_map_new_f(size_t key_size,
+                   size_t value_size,
+                   cc_compare_fn compare,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_btree_map));
+  struct cc_btree_map* self = (struct cc_btree_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  if (!_cc_btree_map_init(
+      self,
+      key_size,
+      value_size,
+      compare,
+      key_functions,
+      value_functions
+    ))
+  {
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_btree_map*
+cc_btree_map_from_sorted_arrays_f(const void* keys,
+                                  const void* values,
+                                  size_t count,
+                                  size_t key_size,
+                                  size_t value_size,
+                                  cc_compare_fn compare,
+                                  const struct cc_functions key_functions,
+                                  const struct cc_functions value_functions)
+{
+  struct cc_btree_map* self = cc_btree_map_new_f(
+      key_size,
+      value_size,
+      compare,
+      key_functions,
+      value_functions
+    );
+  if (!self)
+  {
+    return NULL;
+  }
+
+  const char* key = (const char*) keys;
+  const char* value = (const char*) values;
+
+  bool sorted = true;
+  for (size_t n = 1; n < count && sorted; ++n)
+  {
+    sorted = self->compare(
+        key + (n - 1) * key_size,
+        key + n * key_size,
+        key_size
+      ) <= 0;
+  }
+
+  if (!sorted)
+  {
+    for (size_t n = 0; n < count; ++n, key += key_size, value += value_size)
+    {
+      cc_btree_map_insert(self, key, value);
+    }
+    return self;
+  }
+
+  // Sorted input fills the leaves left to right and then builds the
+  // branches bottom up, with no searching or splitting.
+  // Duplicate keys merge, so the size cannot tell a failed append apart.
+  struct cc_btree_node* last = self->first;
+  bool appended = true;
+  for (size_t n = 0; n < count && appended; ++n)
+  {
+    appended = _cc_btree_map_append(self, &last, key, value);
+    key += key_size;
+    value += value_size;
+  }
+
+  if (!appended || !_cc_btree_map_build(self))
+  {
+    _cc_btree_map_chain_free(self, self->first);
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_btree_map*
+cc_btree_map_copy(const struct cc_btree_map* other)
+{
+  void* buffer = malloc(sizeof(struct cc_btree_map));
+  struct cc_btree_map* self = (struct cc_btree_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  if (!cc_btree_map_copier(self, other, sizeof(struct cc_btree_map)))
+  {
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+void
+cc_btree_map_delete(struct cc_btree_map* self)
+{
+  cc_btree_map_deleter(self);
+  free(self);
+}
+
+struct cc_btree_map_iterator
+cc_btree_map_begin(struct cc_btree_map* self)
+{
+  struct cc_btree_node* node = self->first;
+  if (node->count == 0)
+  {
+    node = NULL;
+  }
+
+  return (struct cc_btree_map_iterator){
+    .map = self,
+    .node = node,
+    .position = 0
+  };
+}
+
+struct cc_btree_map_iterator
+cc_btree_map_end(struct cc_btree_map* self)
+{
+  return (struct cc_btree_map_iterator){
+    .map = self,
+    .node = NULL,
+    .position = 0
+  };
+}
+
+struct cc_btree_map_iterator
+cc_btree_map_lower_bound(struct cc_btree_map* self, const void* key)
+{
+  return _cc_btree_map_bound(self, key, false);
+}
+
+struct cc_btree_map_iterator
+cc_btree_map_upper_bound(struct cc_btree_map* self, const void* key)
+{
+  return _cc_btree_map_bound(self, key, true);
+}
+
+bool
+cc_btree_map_empty(const struct cc_btree_map* self)
+{
+  if (self)
+  {
+    return self->size == 0;
+  }
+  else
+  {
+    return true;
+  }
+}
+
+size_t
+cc_btree_map_size(const struct cc_btree_map* self)
+{
+  if (self)
+  {
+    return self->size;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_btree_map_height(const struct cc_btree_map* self)
+{
+  if (self)
+  {
+    return self->height;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_btree_map_clear(struct cc_btree_map* self)
+{
+  if (self)
+  {
+    // Keep the leftmost leaf as the new, empty root.
+    struct cc_btree_node* leaf = self->first;
+    _cc_btree_map_node_free(self, self->root, leaf);
+    leaf->prev = NULL;
+    leaf->next = NULL;
+
+    self->size = 0;
+    self->height = 1;
+    self->root = leaf;
+  }
+}
+
+void
+cc_btree_map_insert(struct cc_btree_map* self,
+                    const void* key,
+                    const void* value)
+{
+  if (!self || !key || (!value && self->value_size > 0))
+  {
+    return;
+  }
+
+  struct cc_btree_node* path[CC_BTREE_MAP_MAX_HEIGHT];
+  size_t slots[CC_BTREE_MAP_MAX_HEIGHT];
+  size_t depth = 0;
+
+  struct cc_btree_node* node = self->root;
+  while (!node->leaf)
+  {
+    size_t slot = _cc_btree_map_search(self, node, key, true);
+    path[depth] = node;
+    slots[depth] = slot;
+    ++depth;
+    node = _cc_btree_map_children(self, node)[slot];
+  }
+
+  size_t position = _cc_btree_map_search(self, node, key, false);
+  if (position < node->count
+      && self->compare(
+          _cc_btree_map_key(self, node, position),
+          key,
+          self->key_size
+        ) == 0)
+  {
+    if (self->value_size > 0)
+    {
+      void* existing = _cc_btree_map_value(self, node, position);
+      self->value_functions.deleter(existing);
+      self->value_functions.copier(existing, value, self->value_size);
+    }
+    return;
+  }
+
+  // Allocate every node that the splits could need before touching the tree,
+  // so that running out of memory leaves it unchanged.
+  struct cc_btree_node* spares[CC_BTREE_MAP_MAX_HEIGHT + 1];
+  size_t needed = 0;
+  if (node->count == self->order)
+  {
+    size_t d = depth;
+    needed = 1;
+    while (d > 0 && path[d - 1]->count == self->order)
+    {
+      ++needed;
+      --d;
+    }
+    if (d == 0)
+    {
+      ++needed;
+    }
+  }
+  for (size_t n = 0; n < needed; ++n)
+  {
+    spares[n] = _cc_btree_map_node_new(self, true);
+    if (!spares[n])
+    {
+      while (n > 0)
+      {
+        free(spares[--n]);
+      }
+      return;
+    }
+  }
+
+  size_t tail = node->count - position;
+  cc_relocate_range(
+      &self->key_functions,
+      _cc_btree_map_key(self, node, position + 1),
+      _cc_btree_map_key(self, node, position),
+      tail,
+      self->key_size
+    );
+  self->key_functions.copier(
+      _cc_btree_map_key(self, node, position),
+      key,
+      self->key_size
+    );
+  if (self->value_size > 0)
+  {
+    cc_relocate_range(
+        &self->value_functions,
+        _cc_btree_map_value(self, node, position + 1),
+        _cc_btree_map_value(self, node, position),
+        tail,
+        self->value_size
+      );
+    self->value_functions.copier(
+        _cc_btree_map_value(self, node, position),
+        value,
+        self->value_size
+      );
+  }
+  ++node->count;
+  ++self->size;
+
+  while (node->count > self->order)
+  {
+    struct cc_btree_node* right = spares[--needed];
+    size_t mid = node->count / 2;
+    void* separator;
+    bool copy_separator = node->leaf;
+
+    right->leaf = node->leaf;
+    if (node->leaf)
+    {
+      // Leaf separators are copies of the right half's first key.
+      right->count = node->count - mid;
+      cc_relocate_range(
+          &self->key_functions,
+          _cc_btree_map_key(self, right, 0),
+          _cc_btree_map_key(self, node, mid),
+          right->count,
+          self->key_size
+        );
+      if (self->value_size > 0)
+      {
+        cc_relocate_range(
+            &self->value_functions,
+            _cc_btree_map_value(self, right, 0),
+            _cc_btree_map_value(self, node, mid),
+            right->count,
+            self->value_size
+          );
+      }
+      node->count = mid;
+
+      right->prev = node;
+      right->next = node->next;
+      if (node->next)
+      {
+        node->next->prev = right;
+      }
+      node->next = right;
+
+      separator = _cc_btree_map_key(self, right, 0);
+    }
+    else
+    {
+      // Branch separators move up; the middle key is left behind unused.
+      right->count = node->count - mid - 1;
+      cc_relocate_range(
+          &self->key_functions,
+          _cc_btree_map_key(self, right, 0),
+          _cc_btree_map_key(self, node, mid + 1),
+          right->count,
+          self->key_size
+        );
+      memcpy(
+          _cc_btree_map_children(self, right),
+          _cc_btree_map_children(self, node) + mid + 1,
+          (right->count + 1) * sizeof(struct cc_btree_node*)
+        );
+      node->count = mid;
+
+      separator = _cc_btree_map_key(self, node, mid);
+    }
+
+    struct cc_btree_node* parent;
+    size_t slot;
+    if (depth == 0)
+    {
+      parent = spares[--needed];
+      parent->leaf = false;
+      _cc_btree_map_children(self, parent)[0] = node;
+      self->root = parent;
+      ++self->height;
+      slot = 0;
+    }
+    else
+    {
+      --depth;
+      parent = path[depth];
+      slot = slots[depth];
+    }
+
+    struct cc_btree_node** children = _cc_btree_map_children(self, parent);
+    tail = parent->count - slot;
+    cc_relocate_range(
+        &self->key_functions,
+        _cc_btree_map_key(self, parent, slot + 1),
+        _cc_btree_map_key(self, parent, slot),
+        tail,
+        self->key_size
+      );
+    memmove(
+        children + slot + 2,
+        children + slot + 1,
+        tail * sizeof(struct cc_btree_node*)
+      );
+    if (copy_separator)
+    {
+      self->key_functions.copier(
+          _cc_btree_map_key(self, parent, slot),
+          separator,
+          self->key_size
+        );
+    }
+    else
+    {
+      cc_relocate(
+          &self->key_functions,
+          _cc_btree_map_key(self, parent, slot),
+          separator,
+          self->key_size
+        );
+    }
+    children[slot + 1] = right;
+    ++parent->count;
+
+    node = parent;
+  }
+}
+
+void
+cc_btree_map_erase(struct cc_btree_map* self, const void* key)
+{
+  if (!self || !key)
+  {
+    return;
+  }
+
+  struct cc_btree_node* path[CC_BTREE_MAP_MAX_HEIGHT];
+  size_t slots[CC_BTREE_MAP_MAX_HEIGHT];
+  size_t depth = 0;
+
+  struct cc_btree_node* node = self->root;
+  while (!node->leaf)
+  {
+    size_t slot = _cc_btree_map_search(self, node, key, true);
+    path[depth] = node;
+    slots[depth] = slot;
+    ++depth;
+    node = _cc_btree_map_children(self, node)[slot];
+  }
+
+  size_t position = _cc_btree_map_search(self, node, key, false);
+  if (position == node->count
+      || self->compare(
+          _cc_btree_map_key(self, node, position),
+          key,
+          self->key_size
+        ) != 0)
+  {
+    return;
+  }
+
+  size_t tail = node->count - position - 1;
+  self->key_functions.deleter(_cc_btree_map_key(self, node, position));
+  cc_relocate_range(
+      &self->key_functions,
+      _cc_btree_map_key(self, node, position),
+      _cc_btree_map_key(self, node, position + 1),
+      tail,
+      self->key_size
+    );
+  if (self->value_size > 0)
+  {
+    self->value_functions.deleter(_cc_btree_map_value(self, node, position));
+    cc_relocate_range(
+        &self->value_functions,
+        _cc_btree_map_value(self, node, position),
+        _cc_btree_map_value(self, node, position + 1),
+        tail,
+        self->value_size
+      );
+  }
+  --node->count;
+  --self->size;
+
+  // Nodes are not merged when they run low; only empty leaves are removed,
+  // along with any branches they leave without children.
+  if (node->count > 0 || depth == 0)
+  {
+    return;
+  }
+
+  if (self->size == 0)
+  {
+    // Every other leaf is already gone, so the path is a chain of branches
+    // with a single child each.
+    for (size_t d = 0; d < depth; ++d)
+    {
+      free(path[d]);
+    }
+    node->prev = NULL;
+    node->next = NULL;
+    self->root = node;
+    self->first = node;
+    self->height = 1;
+    return;
+  }
+
+  if (node->prev)
+  {
+    node->prev->next = node->next;
+  }
+  else
+  {
+    self->first = node->next;
+  }
+  if (node->next)
+  {
+    node->next->prev = node->prev;
+  }
+  free(node);
+
+  while (depth > 0)
+  {
+    --depth;
+    struct cc_btree_node* parent = path[depth];
+    struct cc_btree_node** children = _cc_btree_map_children(self, parent);
+    size_t slot = slots[depth];
+
+    if (parent->count == 0)
+    {
+      free(parent);
+      continue;
+    }
+
+    size_t separator = slot > 0 ? slot - 1 : 0;
+    self->key_functions.deleter(_cc_btree_map_key(self, parent, separator));
+    cc_relocate_range(
+        &self->key_functions,
+        _cc_btree_map_key(self, parent, separator),
+        _cc_btree_map_key(self, parent, separator + 1),
+        (parent->count - separator - 1),
+        self->key_size
+      );
+    memmove(
+        children + slot,
+        children + slot + 1,
+        (parent->count - slot) * sizeof(struct cc_btree_node*)
+      );
+    --parent->count;
+    break;
+  }
+
+  while (!self->root->leaf && self->root->count == 0)
+  {
+    struct cc_btree_node* root = self->root;
+    self->root = _cc_btree_map_children(self, root)[0];
+    free(root);
+    --self->height;
+  }
+}
+
+void
+cc_btree_map_swap(struct cc_btree_map* self, struct cc_btree_map* other)
+{
+  if (self && other)
+  {
+    struct cc_btree_map temp = *self;
+    *self = *other;
+    *other = temp;
+  }
+}
+
+void*
+cc_btree_map_find(const struct cc_btree_map* self, const void* key)
+{
+  if (self && key)
+  {
+    struct cc_btree_node* leaf;
+    size_t position;
+    if (_cc_btree_map_get(self, key, &leaf, &position))
+    {
+      return _cc_btree_map_value(self, leaf, position);
+    }
+  }
+
+  return NULL;
+}
+
+bool
+cc_btree_map_contains(const struct cc_btree_map* self, const void* key)
+{
+  if (self && key)
+  {
+    struct cc_btree_node* leaf;
+    size_t position;
+    return _cc_btree_map_get(self, key, &leaf, &position);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+bool
+cc_btree_map_eq(const struct cc_btree_map* self,
+                const struct cc_btree_map* other)
+{
+  return cc_btree_map_equality(self, other, sizeof(struct cc_btree_map));
+}
+
+bool
+cc_btree_map_ne(const struct cc_btree_map* self,
+                const struct cc_btree_map* other)
+{
+  return !cc_btree_map_eq(self, other);
+}
+
+void
+cc_btree_map_iterator_increment(struct cc_btree_map_iterator* self)
+{
+  ++self->position;
+  if (self->position == self->node->count)
+  {
+    self->node = self->node->next;
+    self->position = 0;
+  }
+}
+
+void
+cc_btree_map_iterator_decrement(struct cc_btree_map_iterator* self)
+{
+  if (!self->node)
+  {
+    const struct cc_btree_map* map = self->map;
+    struct cc_btree_node* node = map->root;
+    while (!node->leaf)
+    {
+      node = _cc_btree_map_children(map, node)[node->count];
+    }
+    self->node = node;
+    self->position = node->count - 1;
+  }
+  else if (self->position == 0)
+  {
+    self->node = self->node->prev;
+    self->position = self->node->count - 1;
+  }
+  else
+  {
+    --self->position;
+  }
+}
+
+struct cc_btree_map_key_value
+cc_btree_map_iterator_dereference(const struct cc_btree_map_iterator self)
+{
+  return (struct cc_btree_map_key_value){
+    .key = _cc_btree_map_key(self.map, self.node, self.position),
+    .value = _cc_btree_map_value(self.map, self.node, self.position)
+  };
+}
+
+bool
+cc_btree_map_iterator_eq(const struct cc_btree_map_iterator self,
+                         const struct cc_btree_map_iterator other)
+{
+  return self.map == other.map
+      && self.node == other.node
+      && self.position == other.position;
+}
+
+bool
+cc_btree_map_iterator_ne(const struct cc_btree_map_iterator self,
+                         const struct cc_btree_map_iterator other)
+{
+  return !cc_btree_map_iterator_eq(self, other);
+}
@@ -0,0 +1,186 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_BTREE_MAP_H
+#define CC_BTREE_MAP_H
+
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// An ordered map kept in a B+tree.  Every entry lives in a leaf, the leaves
+// are linked in key order, and branch nodes hold copies of separator keys.
+// Nodes are cache-line aligned and hold about 256 bytes of keys.  Keys are
+// ordered by a cc_compare_fn; the cc_functions tables are still used to copy,
+// delete, hash and compare values.
+struct cc_btree_node
+{
+  struct cc_btree_node* prev;
+  struct cc_btree_node* next;
+  uint16_t count;
+  bool leaf;
+};
+
+struct cc_btree_map
+{
+  size_t size;
+  size_t height;
+  size_t order;
+  size_t key_size;
+  size_t value_size;
+  cc_compare_fn compare;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  struct cc_btree_node* root;
+  struct cc_btree_node* first;
+};
+
+struct cc_btree_map_iterator
+{
+  struct cc_btree_map* map;
+  struct cc_btree_node* node;
+  size_t position;
+};
+
+struct cc_btree_map_key_value
+{
+  void* key;
+  void* value;
+};
+
+typedef struct cc_btree_map* cc_btree_map_t;
+
+typedef struct cc_btree_map_iterator cc_btree_map_iterator_t;
+
+typedef struct cc_btree_map_key_value cc_btree_map_key_value_t;
+
+extern const size_t cc_btree_map_sizeof;
+
+extern const struct cc_functions cc_btree_map_functions;
+
+uint64_t
+cc_btree_map_hasher(const void* buffer, size_t size);
+
+void*
+cc_btree_map_copier(void* dest, const void* src, size_t size);
+
+void
+cc_btree_map_deleter(void* ptr);
+
+bool
+cc_btree_map_equality(const void* left, const void* right, size_t size);
+
+struct cc_btree_map*
+cc_btree_map_new(size_t key_size, size_t value_size, cc_compare_fn compare);
+
+struct cc_btree_map*
+cc_btree_map_from_sorted_arrays(const void* keys,
+                                const void* values,
+                                size_t count,
+                                size_t key_size,
+                                size_t value_size,
+                                cc_compare_fn compare);
+
+struct cc_btree_map*
+cc_btree_map_new_f(size_t key_size,
+                   size_t value_size,
+                   cc_compare_fn compare,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions);
+
+struct cc_btree_map*
+cc_btree_map_from_sorted_arrays_f(const void* keys,
+                                  const void* values,
+                                  size_t count,
+                                  size_t key_size,
+                                  size_t value_size,
+                                  cc_compare_fn compare,
+                                  const struct cc_functions key_functions,
+                                  const struct cc_functions value_functions);
+
+struct cc_btree_map*
+cc_btree_map_copy(const struct cc_btree_map* other);
+
+void
+cc_btree_map_delete(struct cc_btree_map* self);
+
+struct cc_btree_map_iterator
+cc_btree_map_begin(struct cc_btree_map* self);
+
+struct cc_btree_map_iterator
+cc_btree_map_end(struct cc_btree_map* self);
+
+struct cc_btree_map_iterator
+cc_btree_map_lower_bound(struct cc_btree_map* self, const void* key);
+
+struct cc_btree_map_iterator
+cc_btree_map_upper_bound(struct cc_btree_map* self, const void* key);
+
+bool
+cc_btree_map_empty(const struct cc_btree_map* self);
+
+size_t
+cc_btree_map_size(const struct cc_btree_map* self);
+
+size_t
+cc_btree_map_height(const struct cc_btree_map* self);
+
+void
+cc_btree_map_clear(struct cc_btree_map* self);
+
+void
+cc_btree_map_insert(struct cc_btree_map* self,
+                    const void* key,
+                    const void* value);
+
+void
+cc_btree_map_erase(struct cc_btree_map* self, const void* key);
+
+void
+cc_btree_map_swap(struct cc_btree_map* self, struct cc_btree_map* other);
+
+void*
+cc_btree_map_find(const struct cc_btree_map* self, const void* key);
+
+bool
+cc_btree_map_contains(const struct cc_btree_map* self, const void* key);
+
+bool
+cc_btree_map_eq(const struct cc_btree_map* self,
+                const struct cc_btree_map* other);
+
+bool
+cc_btree_map_ne(const struct cc_btree_map* self,
+                const struct cc_btree_map* other);
+
+void
+cc_btree_map_iterator_increment(struct cc_btree_map_iterator* self);
+
+void
+cc_btree_map_iterator_decrement(struct cc_btree_map_iterator* self);
+
+struct cc_btree_map_key_value
+cc_btree_map_iterator_dereference(const struct cc_btree_map_iterator self);
+
+bool
+cc_btree_map_iterator_eq(const struct cc_btree_map_iterator self,
+                         const struct cc_btree_map_iterator other);
+
+bool
+cc_btree_map_iterator_ne(const struct cc_btree_map_iterator self,
+                         const struct cc_btree_map_iterator other);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_BTREE_MAP_H
@@ -0,0 +1,320 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cc_concurrent_map.h"
+
+struct cc_concurrent_map_shard
+{
+  // Keep each lock on its own cache line so that readers of one shard do not
+  // invalidate the lock word of a neighboring shard.
+  _Alignas(64) pthread_rwlock_t lock;
+  struct cc_map* map;
+};
+
+unsigned int
+_cc_concurrent_map_shard_bits(size_t shard_count)
+{
+  unsigned int bits = 0;
+  if (shard_count == 0)
+  {
+    shard_count = 64;
+  }
+  while (((size_t) 1 << bits) < shard_count && bits < 16)
+  {
+    ++bits;
+  }
+  return bits;
+}
+
+struct cc_concurrent_map_shard*
+_cc_concurrent_map_shard(const struct cc_concurrent_map* self, const void* key)
+{
+  if (self->shard_bits == 0)
+  {
+    return self->shards;
+  }
+
+  // The shard is selected with the high bits of a hash seeded per map, so
+  // keys cannot be chosen ahead of time to crowd into one shard.  Each cc_map
+  // places entries using the low bits of its own seeded hash.
+  uint64_t hash = cc_hash_seeded(
+      &self->key_functions,
+      key,
+      self->key_size,
+      self->seed
+    );
+  return self->shards + (size_t) (hash >> (64 - self->shard_bits));
+}
+
+struct cc_concurrent_map*
+cc_concurrent_map_new(size_t key_size, size_t value_size, size_t shard_count)
+{
+  return cc_concurrent_map_new_f(
+      key_size,
+      value_size,
+      shard_count,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_concurrent_map*
+cc_concurrent_map_new_f(size_t key_size,
+                        size_t value_size,
+                        size_t shard_count,
+                        const struct cc_functions key_functions,
+                        const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_concurrent_map));
+  struct cc_concurrent_map* self = (struct cc_concurrent_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  unsigned int bits = _cc_concurrent_map_shard_bits(shard_count);
+  size_t count = (size_t) 1 << bits;
+
+  buffer = aligned_alloc(
+      _Alignof(struct cc_concurrent_map_shard),
+      count * sizeof(struct cc_concurrent_map_shard)
+    );
+  if (!buffer)
+  {
+    free(self);
+    return NULL;
+  }
+  struct cc_concurrent_map_shard* shards;
+  shards = (struct cc_concurrent_map_shard*) buffer;
+
+  for (size_t n = 0; n < count; ++n)
+  {
+    shards[n].map = cc_map_new_f(
+        key_size,
+        value_size,
+        key_functions,
+        value_functions
+      );
+    if (!shards[n].map || pthread_rwlock_init(&shards[n].lock, NULL) != 0)
+    {
+      if (shards[n].map)
+      {
+        cc_map_delete(shards[n].map);
+      }
+      while (n > 0)
+      {
+        --n;
+        pthread_rwlock_destroy(&shards[n].lock);
+        cc_map_delete(shards[n].map);
+      }
+      free(shards);
+      free(self);
+      return NULL;
+    }
+  }
+
+  self->shard_count = count;
+  self->shard_bits = bits;
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->seed = cc_hash_seed();
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->shards = shards;
+
+  return self;
+}
+
+void
+cc_concurrent_map_delete(struct cc_concurrent_map* self)
+{
+  if (self)
+  {
+    for (size_t n = 0; n < self->shard_count; ++n)
+    {
+      pthread_rwlock_destroy(&self->shards[n].lock);
+      cc_map_delete(self->shards[n].map);
+    }
+    free(self->shards);
+    free(self);
+  }
+}
+
+bool
+cc_concurrent_map_empty(struct cc_concurrent_map* self)
+{
+  return cc_concurrent_map_size(self) == 0;
+}
+
+size_t
+cc_concurrent_map_size(struct cc_concurrent_map* self)
+{
+  size_t size = 0;
+  if (self)
+  {
+    for (size_t n = 0; n < self->shard_count; ++n)
+    {
+      pthread_rwlock_rdlock(&self->shards[n].lock);
+      size += cc_map_size(self->shards[n].map);
+      pthread_rwlock_unlock(&self->shards[n].lock);
+    }
+  }
+  return size;
+}
+
+size_t
+cc_concurrent_map_shard_count(const struct cc_concurrent_map* self)
+{
+  if (self)
+  {
+    return self->shard_count;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_concurrent_map_clear(struct cc_concurrent_map* self)
+{
+  if (self)
+  {
+    for (size_t n = 0; n < self->shard_count; ++n)
+    {
+      pthread_rwlock_wrlock(&self->shards[n].lock);
+      cc_map_clear(self->shards[n].map);
+      pthread_rwlock_unlock(&self->shards[n].lock);
+    }
+  }
+}
+
+void
+cc_concurrent_map_reserve(struct cc_concurrent_map* self, size_t count)
+{
+  if (self)
+  {
+    size_t per_shard = (count + self->shard_count - 1) / self->shard_count;
+    for (size_t n = 0; n < self->shard_count; ++n)
+    {
+      pthread_rwlock_wrlock(&self->shards[n].lock);
+      cc_map_reserve(self->shards[n].map, per_shard);
+      pthread_rwlock_unlock(&self->shards[n].lock);
+    }
+  }
+}
+
+void
+cc_concurrent_map_insert(struct cc_concurrent_map* self,
+                         const void* key,
+                         const void* value)
+{
+  if (self && key && value)
+  {
+    struct cc_concurrent_map_shard* shard = _cc_concurrent_map_shard(self, key);
+    pthread_rwlock_wrlock(&shard->lock);
+    cc_map_insert(shard->map, key, value);
+    pthread_rwlock_unlock(&shard->lock);
+  }
+}
+
+void
+cc_concurrent_map_upsert(struct cc_concurrent_map* self,
+                         const void* key,
+                         const void* value,
+                         cc_concurrent_map_update_fn update,
+                         void* arg)
+{
+  if (self && key && value)
+  {
+    struct cc_concurrent_map_shard* shard = _cc_concurrent_map_shard(self, key);
+    pthread_rwlock_wrlock(&shard->lock);
+    void* existing = cc_map_find(shard->map, key);
+    if (existing && update)
+    {
+      update(existing, value, arg);
+    }
+    else
+    {
+      cc_map_insert(shard->map, key, value);
+    }
+    pthread_rwlock_unlock(&shard->lock);
+  }
+}
+
+void
+cc_concurrent_map_erase(struct cc_concurrent_map* self, const void* key)
+{
+  if (self && key)
+  {
+    struct cc_concurrent_map_shard* shard = _cc_concurrent_map_shard(self, key);
+    pthread_rwlock_wrlock(&shard->lock);
+    cc_map_erase(shard->map, key);
+    pthread_rwlock_unlock(&shard->lock);
+  }
+}
+
+bool
+cc_concurrent_map_find(struct cc_concurrent_map* self,
+                       const void* key,
+                       void* value)
+{
+  bool found = false;
+  if (self && key)
+  {
+    struct cc_concurrent_map_shard* shard = _cc_concurrent_map_shard(self, key);
+    pthread_rwlock_rdlock(&shard->lock);
+    const void* existing = cc_map_find(shard->map, key);
+    if (existing)
+    {
+      // The value is copied out while the shard is still locked, because the
+      // slot may move as soon as a writer gets in.
+      if (value)
+      {
+        self->value_functions.copier(value, existing, self->value_size);
+      }
+      found = true;
+    }
+    pthread_rwlock_unlock(&shard->lock);
+  }
+  return found;
+}
+
+bool
+cc_concurrent_map_contains(struct cc_concurrent_map* self, const void* key)
+{
+  return cc_concurrent_map_find(self, key, NULL);
+}
+
+void
+cc_concurrent_map_for_each(struct cc_concurrent_map* self,
+                           cc_concurrent_map_visit_fn visit,
+                           void* arg)
+{
+  if (self && visit)
+  {
+    for (size_t n = 0; n < self->shard_count; ++n)
+    {
+      struct cc_concurrent_map_shard* shard = self->shards + n;
+      pthread_rwlock_rdlock(&shard->lock);
+      cc_map_iterator_t p = cc_map_begin(shard->map);
+      cc_map_iterator_t e = cc_map_end(shard->map);
+      for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+      {
+        cc_map_key_value_t kv = cc_map_iterator_dereference(p);
+        visit(kv.key, kv.value, arg);
+      }
+      pthread_rwlock_unlock(&shard->lock);
+    }
+  }
+}
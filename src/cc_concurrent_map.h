@@ -0,0 +1,108 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_CONCURRENT_MAP_H
+#define CC_CONCURRENT_MAP_H
+
+#include "cc_map.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// Each shard pairs a reader-writer lock with a cc_map.  The shard layout is
+// private so that the lock type does not leak into this header.
+struct cc_concurrent_map_shard;
+
+struct cc_concurrent_map
+{
+  size_t shard_count;
+  unsigned int shard_bits;
+  size_t key_size;
+  size_t value_size;
+  uint64_t seed;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  struct cc_concurrent_map_shard* shards;
+};
+
+typedef struct cc_concurrent_map* cc_concurrent_map_t;
+
+typedef void (*cc_concurrent_map_update_fn)(void* existing,
+                                            const void* value,
+                                            void* arg);
+
+// Visitors run under a shard's read lock, alongside other readers, so they
+// see values read-only; use cc_concurrent_map_upsert to change them.
+typedef void (*cc_concurrent_map_visit_fn)(const void* key,
+                                           const void* value,
+                                           void* arg);
+
+struct cc_concurrent_map*
+cc_concurrent_map_new(size_t key_size, size_t value_size, size_t shard_count);
+
+struct cc_concurrent_map*
+cc_concurrent_map_new_f(size_t key_size,
+                        size_t value_size,
+                        size_t shard_count,
+                        const struct cc_functions key_functions,
+                        const struct cc_functions value_functions);
+
+void
+cc_concurrent_map_delete(struct cc_concurrent_map* self);
+
+bool
+cc_concurrent_map_empty(struct cc_concurrent_map* self);
+
+size_t
+cc_concurrent_map_size(struct cc_concurrent_map* self);
+
+size_t
+cc_concurrent_map_shard_count(const struct cc_concurrent_map* self);
+
+void
+cc_concurrent_map_clear(struct cc_concurrent_map* self);
+
+void
+cc_concurrent_map_reserve(struct cc_concurrent_map* self, size_t count);
+
+void
+cc_concurrent_map_insert(struct cc_concurrent_map* self,
+                         const void* key,
+                         const void* value);
+
+void
+cc_concurrent_map_upsert(struct cc_concurrent_map* self,
+                         const void* key,
+                         const void* value,
+                         cc_concurrent_map_update_fn update,
+                         void* arg);
+
+void
+cc_concurrent_map_erase(struct cc_concurrent_map* self, const void* key);
+
+bool
+cc_concurrent_map_find(struct cc_concurrent_map* self,
+                       const void* key,
+                       void* value);
+
+bool
+cc_concurrent_map_contains(struct cc_concurrent_map* self, const void* key);
+
+void
+cc_concurrent_map_for_each(struct cc_concurrent_map* self,
+                           cc_concurrent_map_visit_fn visit,
+                           void* arg);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_CONCURRENT_MAP_H
@@ -0,0 +1,254 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_count_min.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+size_t
+_cc_count_min_column(const struct cc_count_min* self,
+                     uint64_t hash,
+                     size_t row)
+{
+  // Rows use the double hashing scheme h1 + row * h2, with h2 odd so that
+  // it is invertible modulo the power-of-two width.
+  uint64_t step = ((hash >> 32) | (hash << 32)) | 1;
+  return (size_t) (hash + row * step) & (self->width - 1);
+}
+
+struct cc_count_min*
+cc_count_min_new(double epsilon, double delta)
+{
+  // The width is e / epsilon, rounded up to a power of two, and the depth is
+  // ln(1 / delta), rounded up.
+  const double e = 2.718281828459045;
+  double width = epsilon > 0.0 ? e / epsilon : 1.0;
+  double rows = delta <= 0.0 ? 32.0 : delta < 1.0 ? cc_log(1.0 / delta) : 1.0;
+  size_t depth = 1;
+  while ((double) depth < rows && depth < 32)
+  {
+    ++depth;
+  }
+  return cc_count_min_new_f(
+      width < (double) ((size_t) 1 << 40) ? (size_t) width + 1 : 0,
+      depth,
+      cc_default_hasher
+    );
+}
+
+struct cc_count_min*
+cc_count_min_new_f(size_t width, size_t depth, cc_hash_fn hasher)
+{
+  if (width == 0 || width > ((size_t) 1 << 40) || depth == 0 || depth > 64)
+  {
+    return NULL;
+  }
+
+  void* buffer = malloc(sizeof(struct cc_count_min));
+  struct cc_count_min* self = (struct cc_count_min*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->width = 2;
+  while (self->width < width)
+  {
+    self->width <<= 1;
+  }
+  self->depth = depth;
+  self->total = 0;
+  self->hasher = hasher ? hasher : cc_default_hasher;
+  self->counters = (uint64_t*) aligned_alloc(
+      16,
+      self->width * self->depth * sizeof(uint64_t)
+    );
+  if (!self->counters)
+  {
+    free(self);
+    return NULL;
+  }
+  memset(self->counters, 0, self->width * self->depth * sizeof(uint64_t));
+
+  return self;
+}
+
+struct cc_count_min*
+cc_count_min_copy(const struct cc_count_min* other)
+{
+  struct cc_count_min* self = cc_count_min_new_f(
+      other->width,
+      other->depth,
+      other->hasher
+    );
+  if (self)
+  {
+    memcpy(
+        self->counters,
+        other->counters,
+        other->width * other->depth * sizeof(uint64_t)
+      );
+    self->total = other->total;
+  }
+  return self;
+}
+
+void
+cc_count_min_delete(struct cc_count_min* self)
+{
+  if (self)
+  {
+    free(self->counters);
+    free(self);
+  }
+}
+
+size_t
+cc_count_min_width(const struct cc_count_min* self)
+{
+  if (self)
+  {
+    return self->width;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_count_min_depth(const struct cc_count_min* self)
+{
+  if (self)
+  {
+    return self->depth;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+uint64_t
+cc_count_min_total(const struct cc_count_min* self)
+{
+  if (self)
+  {
+    return self->total;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_count_min_clear(struct cc_count_min* self)
+{
+  if (self)
+  {
+    memset(self->counters, 0, self->width * self->depth * sizeof(uint64_t));
+    self->total = 0;
+  }
+}
+
+void
+cc_count_min_add(struct cc_count_min* self,
+                 const void* key,
+                 size_t size,
+                 uint64_t count)
+{
+  if (self && key)
+  {
+    cc_count_min_add_hash(self, self->hasher(key, size), count);
+  }
+}
+
+void
+cc_count_min_add_hash(struct cc_count_min* self, uint64_t hash, uint64_t count)
+{
+  if (self)
+  {
+    uint64_t* row = self->counters;
+    for (size_t n = 0; n < self->depth; ++n, row += self->width)
+    {
+      row[_cc_count_min_column(self, hash, n)] += count;
+    }
+    self->total += count;
+  }
+}
+
+bool
+cc_count_min_merge(struct cc_count_min* self, const struct cc_count_min* other)
+{
+  if (self && other && self->width == other->width
+      && self->depth == other->depth)
+  {
+    size_t count = self->width * self->depth;
+    size_t n = 0;
+#if defined(__SSE2__)
+    for (; n + 2 <= count; n += 2)
+    {
+      __m128i* dest = (__m128i*) (self->counters + n);
+      __m128i src = _mm_load_si128((const __m128i*) (other->counters + n));
+      _mm_store_si128(dest, _mm_add_epi64(_mm_load_si128(dest), src));
+    }
+#endif
+    for (; n < count; ++n)
+    {
+      self->counters[n] += other->counters[n];
+    }
+    self->total += other->total;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+uint64_t
+cc_count_min_estimate(const struct cc_count_min* self,
+                      const void* key,
+                      size_t size)
+{
+  if (self && key)
+  {
+    return cc_count_min_estimate_hash(self, self->hasher(key, size));
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+uint64_t
+cc_count_min_estimate_hash(const struct cc_count_min* self, uint64_t hash)
+{
+  if (self)
+  {
+    uint64_t estimate = UINT64_MAX;
+    const uint64_t* row = self->counters;
+    for (size_t n = 0; n < self->depth; ++n, row += self->width)
+    {
+      uint64_t count = row[_cc_count_min_column(self, hash, n)];
+      estimate = count < estimate ? count : estimate;
+    }
+    return estimate;
+  }
+  else
+  {
+    return 0;
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_COUNT_MIN_H
+#define CC_COUNT_MIN_H
+
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A count-min sketch of how often each key was added.  Every key increments
+// one counter in each of depth rows of width counters; its estimate is the
+// smallest of those counters, which never undercounts and, with probability
+// 1 - delta, overcounts by at most epsilon times the total of all counts.
+// Sketches of the same shape merge by adding their counters.
+struct cc_count_min
+{
+  size_t width;
+  size_t depth;
+  uint64_t total;
+  cc_hash_fn hasher;
+  uint64_t* counters;
+};
+
+typedef struct cc_count_min* cc_count_min_t;
+
+struct cc_count_min*
+cc_count_min_new(double epsilon, double delta);
+
+struct cc_count_min*
+cc_count_min_new_f(size_t width, size_t depth, cc_hash_fn hasher);
+
+struct cc_count_min*
+cc_count_min_copy(const struct cc_count_min* other);
+
+void
+cc_count_min_delete(struct cc_count_min* self);
+
+size_t
+cc_count_min_width(const struct cc_count_min* self);
+
+size_t
+cc_count_min_depth(const struct cc_count_min* self);
+
+uint64_t
+cc_count_min_total(const struct cc_count_min* self);
+
+void
+cc_count_min_clear(struct cc_count_min* self);
+
+void
+cc_count_min_add(struct cc_count_min* self,
+                 const void* key,
+                 size_t size,
+                 uint64_t count);
+
+void
+cc_count_min_add_hash(struct cc_count_min* self, uint64_t hash, uint64_t count);
+
+bool
+cc_count_min_merge(struct cc_count_min* self, const struct cc_count_min* other);
+
+uint64_t
+cc_count_min_estimate(const struct cc_count_min* self,
+                      const void* key,
+                      size_t size);
+
+uint64_t
+cc_count_min_estimate_hash(const struct cc_count_min* self, uint64_t hash);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_COUNT_MIN_H
@@ -0,0 +1,694 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_flat_map.h"
+
+const size_t cc_flat_map_sizeof = sizeof(struct cc_flat_map);
+
+const struct cc_functions cc_flat_map_functions = (struct cc_functions){
+  .hasher = cc_flat_map_hasher,
+  .copier = cc_flat_map_copier,
+  .deleter = cc_flat_map_deleter,
+  .equality = cc_flat_map_equality,
+  .relocator = cc_default_relocator
+};
+
+void*
+_cc_flat_map_key(const struct cc_flat_map* self, size_t n)
+{
+  return (char*) self->keys->data + n * self->keys->element_size;
+}
+
+void*
+_cc_flat_map_value(const struct cc_flat_map* self, size_t n)
+{
+  return (char*) self->values->data + n * self->values->element_size;
+}
+
+size_t
+_cc_flat_map_search(const struct cc_flat_map* self,
+                    const void* key,
+                    bool upper)
+{
+  size_t low = 0;
+  size_t high = self->keys->size;
+  size_t key_size = self->keys->element_size;
+  while (low < high)
+  {
+    size_t mid = low + (high - low) / 2;
+    int result = self->compare(_cc_flat_map_key(self, mid), key, key_size);
+    if (result < 0 || (upper && result == 0))
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+bool
+_cc_flat_map_get(const struct cc_flat_map* self,
+                 const void* key,
+                 size_t* position)
+{
+  size_t n = _cc_flat_map_search(self, key, false);
+  *position = n;
+  return n < self->keys->size
+      && self->compare(
+          _cc_flat_map_key(self, n),
+          key,
+          self->keys->element_size
+        ) == 0;
+}
+
+// Sorts batch positions by key with a bottom-up merge sort.  The sort is
+// stable, so among equal keys the last one in the batch ends up last.
+size_t*
+_cc_flat_map_sort(const struct cc_flat_map* self,
+                  const char* keys,
+                  size_t* order,
+                  size_t* scratch,
+                  size_t count)
+{
+  size_t key_size = self->keys->element_size;
+  for (size_t width = 1; width < count; width *= 2)
+  {
+    for (size_t first = 0; first < count; first += 2 * width)
+    {
+      size_t mid = first + width < count ? first + width : count;
+      size_t last = mid + width < count ? mid + width : count;
+      size_t i = first;
+      size_t j = mid;
+      size_t k = first;
+      while (i < mid && j < last)
+      {
+        if (self->compare(
+                keys + order[j] * key_size,
+                keys + order[i] * key_size,
+                key_size
+              ) < 0)
+        {
+          scratch[k++] = order[j++];
+        }
+        else
+        {
+          scratch[k++] = order[i++];
+        }
+      }
+      while (i < mid)
+      {
+        scratch[k++] = order[i++];
+      }
+      while (j < last)
+      {
+        scratch[k++] = order[j++];
+      }
+    }
+
+    size_t* temp = order;
+    order = scratch;
+    scratch = temp;
+  }
+  return order;
+}
+
+uint64_t
+cc_flat_map_hasher(const void* buffer, size_t size)
+{
+  const struct cc_flat_map* self = (const struct cc_flat_map*) buffer;
+
+  size_t vector_size = sizeof(struct cc_vector);
+  uint64_t hash = cc_vector_hasher(self->keys, vector_size);
+  cc_hash_combine(&hash, cc_vector_hasher(self->values, vector_size));
+  return hash;
+}
+
+void*
+cc_flat_map_copier(void* dest, const void* src, size_t size)
+{
+  if (dest && src)
+  {
+    struct cc_flat_map* self = (struct cc_flat_map*) dest;
+    const struct cc_flat_map* other = (const struct cc_flat_map*) src;
+
+    self->compare = other->compare;
+    self->keys = cc_vector_copy(other->keys);
+    self->values = cc_vector_copy(other->values);
+    if (!self->keys || !self->values)
+    {
+      cc_vector_delete(self->keys);
+      cc_vector_delete(self->values);
+      return NULL;
+    }
+
+    return self;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void
+cc_flat_map_deleter(void* ptr)
+{
+  if (ptr)
+  {
+    struct cc_flat_map* self = (struct cc_flat_map*) ptr;
+
+    cc_vector_delete(self->keys);
+    cc_vector_delete(self->values);
+
+    self->compare = NULL;
+    self->keys = NULL;
+    self->values = NULL;
+  }
+}
+
+bool
+cc_flat_map_equality(const void* left, const void* right, size_t size)
+{
+  if (left && right)
+  {
+    const struct cc_flat_map* self = (const struct cc_flat_map*) left;
+    const struct cc_flat_map* other = (const struct cc_flat_map*) right;
+
+    size_t key_size = self->keys->element_size;
+    if (self->keys->size != other->keys->size
+        || key_size != other->keys->element_size)
+    {
+      return false;
+    }
+
+    for (size_t n = 0; n < self->keys->size; ++n)
+    {
+      if (self->compare(
+              _cc_flat_map_key(self, n),
+              _cc_flat_map_key(other, n),
+              key_size
+            ) != 0)
+      {
+        return false;
+      }
+    }
+
+    return cc_vector_equality(
+        self->values,
+        other->values,
+        sizeof(struct cc_vector)
+      );
+  }
+  else
+  {
+    return false;
+  }
+}
+
+struct cc_flat_map*
+cc_flat_map_new(size_t key_size, size_t value_size, cc_compare_fn compare)
+{
+  return cc_flat_map_new_f(
+      key_size,
+      value_size,
+      compare,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_flat_map*
+cc_flat_map_from_arrays(const void* keys,
+                        const void* values,
+                        size_t count,
+                        size_t key_size,
+                        size_t value_size,
+                        cc_compare_fn compare)
+{
+  return cc_flat_map_from_arrays_f(
+      keys,
+      values,
+      count,
+      key_size,
+      value_size,
+      compare,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_flat_map*
+cc_flat_map_new_f(size_t key_size,
+                  size_t value_size,
+                  cc_compare_fn compare,
+                  const struct cc_functions key_functions,
+                  const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_flat_map));
+  struct cc_flat_map* self = (struct cc_flat_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->compare = compare ? compare : cc_default_comparator;
+  self->keys = cc_vector_new_f(key_size, key_functions);
+  self->values = cc_vector_new_f(value_size, value_functions);
+  if (!self->keys || !self->values)
+  {
+    cc_flat_map_delete(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_flat_map*
+cc_flat_map_from_arrays_f(const void* keys,
+                          const void* values,
+                          size_t count,
+                          size_t key_size,
+                          size_t value_size,
+                          cc_compare_fn compare,
+                          const struct cc_functions key_functions,
+                          const struct cc_functions value_functions)
+{
+  struct cc_flat_map* self = cc_flat_map_new_f(
+      key_size,
+      value_size,
+      compare,
+      key_functions,
+      value_functions
+    );
+
+  cc_flat_map_insert_batch(self, keys, values, count);
+
+  return self;
+}
+
+struct cc_flat_map*
+cc_flat_map_copy(const struct cc_flat_map* other)
+{
+  void* buffer = malloc(sizeof(struct cc_flat_map));
+  struct cc_flat_map* self = (struct cc_flat_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  if (!cc_flat_map_copier(self, other, sizeof(struct cc_flat_map)))
+  {
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+void
+cc_flat_map_delete(struct cc_flat_map* self)
+{
+  cc_flat_map_deleter(self);
+  free(self);
+}
+
+struct cc_flat_map_iterator
+cc_flat_map_begin(struct cc_flat_map* self)
+{
+  return (struct cc_flat_map_iterator){
+    .map = self,
+    .position = 0
+  };
+}
+
+struct cc_flat_map_iterator
+cc_flat_map_end(struct cc_flat_map* self)
+{
+  return (struct cc_flat_map_iterator){
+    .map = self,
+    .position = self->keys->size
+  };
+}
+
+struct cc_flat_map_iterator
+cc_flat_map_lower_bound(struct cc_flat_map* self, const void* key)
+{
+  return (struct cc_flat_map_iterator){
+    .map = self,
+    .position = _cc_flat_map_search(self, key, false)
+  };
+}
+
+struct cc_flat_map_iterator
+cc_flat_map_upper_bound(struct cc_flat_map* self, const void* key)
+{
+  return (struct cc_flat_map_iterator){
+    .map = self,
+    .position = _cc_flat_map_search(self, key, true)
+  };
+}
+
+bool
+cc_flat_map_empty(const struct cc_flat_map* self)
+{
+  if (self)
+  {
+    return self->keys->size == 0;
+  }
+  else
+  {
+    return true;
+  }
+}
+
+size_t
+cc_flat_map_size(const struct cc_flat_map* self)
+{
+  if (self)
+  {
+    return self->keys->size;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_flat_map_capacity(const struct cc_flat_map* self)
+{
+  if (self)
+  {
+    return self->keys->capacity;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_flat_map_reserve(struct cc_flat_map* self, size_t count)
+{
+  if (self)
+  {
+    cc_vector_reserve(self->keys, count);
+    cc_vector_reserve(self->values, count);
+  }
+}
+
+void
+cc_flat_map_shrink_to_fit(struct cc_flat_map* self)
+{
+  if (self)
+  {
+    cc_vector_shrink_to_fit(self->keys);
+    cc_vector_shrink_to_fit(self->values);
+  }
+}
+
+void
+cc_flat_map_clear(struct cc_flat_map* self)
+{
+  if (self)
+  {
+    cc_vector_erase(self->keys, 0, self->keys->size);
+    cc_vector_erase(self->values, 0, self->values->size);
+  }
+}
+
+void
+cc_flat_map_insert(struct cc_flat_map* self,
+                   const void* key,
+                   const void* value)
+{
+  if (self && key && value)
+  {
+    size_t position;
+    if (_cc_flat_map_get(self, key, &position))
+    {
+      cc_vector_set(self->values, position, value);
+    }
+    else
+    {
+      cc_vector_insert(self->keys, position, key);
+      cc_vector_insert(self->values, position, value);
+    }
+  }
+}
+
+void
+cc_flat_map_insert_batch(struct cc_flat_map* self,
+                         const void* keys,
+                         const void* values,
+                         size_t count)
+{
+  if (!self || !keys || !values || count == 0)
+  {
+    return;
+  }
+
+  size_t* buffer = (size_t*) malloc(2 * count * sizeof(size_t));
+  if (!buffer)
+  {
+    return;
+  }
+
+  const char* batch_keys = (const char*) keys;
+  const char* batch_values = (const char*) values;
+  size_t key_size = self->keys->element_size;
+  size_t value_size = self->values->element_size;
+  size_t size = self->keys->size;
+
+  for (size_t n = 0; n < count; ++n)
+  {
+    buffer[n] = n;
+  }
+  size_t* order = _cc_flat_map_sort(
+      self,
+      batch_keys,
+      buffer,
+      buffer + count,
+      count
+    );
+
+  // Keep only the last of each run of equal keys, then replace the values
+  // of keys that are already present and count the rest.
+  size_t unique = 0;
+  for (size_t n = 0; n < count; ++n)
+  {
+    if (n + 1 < count
+        && self->compare(
+            batch_keys + order[n] * key_size,
+            batch_keys + order[n + 1] * key_size,
+            key_size
+          ) == 0)
+    {
+      continue;
+    }
+    order[unique++] = order[n];
+  }
+
+  size_t added = 0;
+  size_t i = 0;
+  for (size_t n = 0; n < unique; ++n)
+  {
+    const void* key = batch_keys + order[n] * key_size;
+    int result = -1;
+    while (i < size)
+    {
+      result = self->compare(_cc_flat_map_key(self, i), key, key_size);
+      if (result >= 0)
+      {
+        break;
+      }
+      ++i;
+    }
+    if (i < size && result == 0)
+    {
+      cc_vector_set(self->values, i, batch_values + order[n] * value_size);
+      order[n] = SIZE_MAX;
+    }
+    else
+    {
+      ++added;
+    }
+  }
+
+  if (added > 0)
+  {
+    cc_flat_map_reserve(self, size + added);
+    if (self->keys->capacity < size + added
+        || self->values->capacity < size + added)
+    {
+      free(buffer);
+      return;
+    }
+
+    // Merge from the back so that every existing entry moves at most once.
+    size_t k = size + added;
+    size_t n = unique;
+    i = size;
+    while (n > 0)
+    {
+      if (order[n - 1] == SIZE_MAX)
+      {
+        --n;
+        continue;
+      }
+
+      const void* key = batch_keys + order[n - 1] * key_size;
+      --k;
+      if (i > 0
+          && self->compare(_cc_flat_map_key(self, i - 1), key, key_size) > 0)
+      {
+        --i;
+        cc_relocate(
+            &self->keys->functions,
+            _cc_flat_map_key(self, k),
+            _cc_flat_map_key(self, i),
+            key_size
+          );
+        cc_relocate(
+            &self->values->functions,
+            _cc_flat_map_value(self, k),
+            _cc_flat_map_value(self, i),
+            value_size
+          );
+      }
+      else
+      {
+        self->keys->functions.copier(
+            _cc_flat_map_key(self, k),
+            key,
+            key_size
+          );
+        self->values->functions.copier(
+            _cc_flat_map_value(self, k),
+            batch_values + order[n - 1] * value_size,
+            value_size
+          );
+        --n;
+      }
+    }
+
+    self->keys->size = size + added;
+    self->values->size = size + added;
+  }
+
+  free(buffer);
+}
+
+void
+cc_flat_map_erase(struct cc_flat_map* self, const void* key)
+{
+  if (self && key)
+  {
+    size_t position;
+    if (_cc_flat_map_get(self, key, &position))
+    {
+      cc_vector_erase(self->keys, position, position + 1);
+      cc_vector_erase(self->values, position, position + 1);
+    }
+  }
+}
+
+void
+cc_flat_map_swap(struct cc_flat_map* self, struct cc_flat_map* other)
+{
+  if (self && other)
+  {
+    struct cc_flat_map temp = *self;
+    *self = *other;
+    *other = temp;
+  }
+}
+
+void*
+cc_flat_map_find(const struct cc_flat_map* self, const void* key)
+{
+  if (self && key)
+  {
+    size_t position;
+    if (_cc_flat_map_get(self, key, &position))
+    {
+      return _cc_flat_map_value(self, position);
+    }
+  }
+
+  return NULL;
+}
+
+bool
+cc_flat_map_contains(const struct cc_flat_map* self, const void* key)
+{
+  if (self && key)
+  {
+    size_t position;
+    return _cc_flat_map_get(self, key, &position);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+bool
+cc_flat_map_eq(const struct cc_flat_map* self,
+               const struct cc_flat_map* other)
+{
+  return cc_flat_map_equality(self, other, sizeof(struct cc_flat_map));
+}
+
+bool
+cc_flat_map_ne(const struct cc_flat_map* self,
+               const struct cc_flat_map* other)
+{
+  return !cc_flat_map_eq(self, other);
+}
+
+void
+cc_flat_map_iterator_increment(struct cc_flat_map_iterator* self)
+{
+  ++self->position;
+}
+
+void
+cc_flat_map_iterator_decrement(struct cc_flat_map_iterator* self)
+{
+  --self->position;
+}
+
+struct cc_flat_map_key_value
+cc_flat_map_iterator_dereference(const struct cc_flat_map_iterator self)
+{
+  return (struct cc_flat_map_key_value){
+    .key = _cc_flat_map_key(self.map, self.position),
+    .value = _cc_flat_map_value(self.map, self.position)
+  };
+}
+
+bool
+cc_flat_map_iterator_eq(const struct cc_flat_map_iterator self,
+                        const struct cc_flat_map_iterator other)
+{
+  return self.map == other.map && self.position == other.position;
+}
+
+bool
+cc_flat_map_iterator_ne(const struct cc_flat_map_iterator self,
+                        const struct cc_flat_map_iterator other)
+{
+  return self.map != other.map || self.position != other.position;
+}
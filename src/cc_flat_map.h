@@ -0,0 +1,182 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_FLAT_MAP_H
+#define CC_FLAT_MAP_H
+
+#include "cc_vector.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// An ordered map stored as two parallel vectors, keys and values, sorted by
+// a cc_compare_fn.  Lookups are binary searches and iteration walks
+// contiguous memory.  Single inserts and erases shift the tail of both
+// vectors, so bulk updates should go through cc_flat_map_insert_batch(),
+// which sorts the batch and merges it in one pass.
+struct cc_flat_map
+{
+  cc_compare_fn compare;
+  struct cc_vector* keys;
+  struct cc_vector* values;
+};
+
+struct cc_flat_map_iterator
+{
+  struct cc_flat_map* map;
+  size_t position;
+};
+
+struct cc_flat_map_key_value
+{
+  void* key;
+  void* value;
+};
+
+typedef struct cc_flat_map* cc_flat_map_t;
+
+typedef struct cc_flat_map_iterator cc_flat_map_iterator_t;
+
+typedef struct cc_flat_map_key_value cc_flat_map_key_value_t;
+
+extern const size_t cc_flat_map_sizeof;
+
+extern const struct cc_functions cc_flat_map_functions;
+
+uint64_t
+cc_flat_map_hasher(const void* buffer, size_t size);
+
+void*
+cc_flat_map_copier(void* dest, const void* src, size_t size);
+
+void
+cc_flat_map_deleter(void* ptr);
+
+bool
+cc_flat_map_equality(const void* left, const void* right, size_t size);
+
+struct cc_flat_map*
+cc_flat_map_new(size_t key_size, size_t value_size, cc_compare_fn compare);
+
+struct cc_flat_map*
+cc_flat_map_from_arrays(const void* keys,
+                        const void* values,
+                        size_t count,
+                        size_t key_size,
+                        size_t value_size,
+                        cc_compare_fn compare);
+
+struct cc_flat_map*
+cc_flat_map_new_f(size_t key_size,
+                  size_t value_size,
+                  cc_compare_fn compare,
+                  const struct cc_functions key_functions,
+                  const struct cc_functions value_functions);
+
+struct cc_flat_map*
+cc_flat_map_from_arrays_f(const void* keys,
+                          const void* values,
+                          size_t count,
+                          size_t key_size,
+                          size_t value_size,
+                          cc_compare_fn compare,
+                          const struct cc_functions key_functions,
+                          const struct cc_functions value_functions);
+
+struct cc_flat_map*
+cc_flat_map_copy(const struct cc_flat_map* other);
+
+void
+cc_flat_map_delete(struct cc_flat_map* self);
+
+struct cc_flat_map_iterator
+cc_flat_map_begin(struct cc_flat_map* self);
+
+struct cc_flat_map_iterator
+cc_flat_map_end(struct cc_flat_map* self);
+
+struct cc_flat_map_iterator
+cc_flat_map_lower_bound(struct cc_flat_map* self, const void* key);
+
+struct cc_flat_map_iterator
+cc_flat_map_upper_bound(struct cc_flat_map* self, const void* key);
+
+bool
+cc_flat_map_empty(const struct cc_flat_map* self);
+
+size_t
+cc_flat_map_size(const struct cc_flat_map* self);
+
+size_t
+cc_flat_map_capacity(const struct cc_flat_map* self);
+
+void
+cc_flat_map_reserve(struct cc_flat_map* self, size_t count);
+
+void
+cc_flat_map_shrink_to_fit(struct cc_flat_map* self);
+
+void
+cc_flat_map_clear(struct cc_flat_map* self);
+
+void
+cc_flat_map_insert(struct cc_flat_map* self,
+                   const void* key,
+                   const void* value);
+
+void
+cc_flat_map_insert_batch(struct cc_flat_map* self,
+                         const void* keys,
+                         const void* values,
+                         size_t count);
+
+void
+cc_flat_map_erase(struct cc_flat_map* self, const void* key);
+
+void
+cc_flat_map_swap(struct cc_flat_map* self, struct cc_flat_map* other);
+
+void*
+cc_flat_map_find(const struct cc_flat_map* self, const void* key);
+
+bool
+cc_flat_map_contains(const struct cc_flat_map* self, const void* key);
+
+bool
+cc_flat_map_eq(const struct cc_flat_map* self,
+               const struct cc_flat_map* other);
+
+bool
+cc_flat_map_ne(const struct cc_flat_map* self,
+               const struct cc_flat_map* other);
+
+void
+cc_flat_map_iterator_increment(struct cc_flat_map_iterator* self);
+
+void
+cc_flat_map_iterator_decrement(struct cc_flat_map_iterator* self);
+
+struct cc_flat_map_key_value
+cc_flat_map_iterator_dereference(const struct cc_flat_map_iterator self);
+
+bool
+cc_flat_map_iterator_eq(const struct cc_flat_map_iterator self,
+                        const struct cc_flat_map_iterator other);
+
+bool
+cc_flat_map_iterator_ne(const struct cc_flat_map_iterator self,
+                        const struct cc_flat_map_iterator other);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_FLAT_MAP_H
@@ -0,0 +1,790 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cc_hamt.h"
+
+// Entries are either child nodes or leaves, told apart by the low bit of the
+// pointer.  Nodes below the last level of hash bits hold colliding leaves.
+struct cc_hamt_node
+{
+  atomic_size_t references;
+  uint32_t bitmap;
+  uint32_t count;
+  bool collision;
+  struct cc_hamt_node* entries[];
+};
+
+struct cc_hamt_leaf
+{
+  atomic_size_t references;
+  uint64_t hash;
+  void* key;
+  void* value;
+};
+
+const unsigned int _cc_hamt_bits = 5;
+
+bool
+_cc_hamt_is_leaf(const struct cc_hamt_node* entry)
+{
+  return ((uintptr_t) entry & 1) != 0;
+}
+
+struct cc_hamt_leaf*
+_cc_hamt_as_leaf(const struct cc_hamt_node* entry)
+{
+  return (struct cc_hamt_leaf*) ((uintptr_t) entry & ~(uintptr_t) 1);
+}
+
+struct cc_hamt_node*
+_cc_hamt_tag(const struct cc_hamt_leaf* leaf)
+{
+  return (struct cc_hamt_node*) ((uintptr_t) leaf | 1);
+}
+
+uint64_t
+_cc_hamt_hash(const struct cc_hamt* self, const void* key)
+{
+  return cc_hash_seeded(&self->key_functions, key, self->key_size, self->seed);
+}
+
+uint32_t
+_cc_hamt_slot(uint64_t hash, unsigned int shift)
+{
+  return (uint32_t) 1 << ((hash >> shift) & 31);
+}
+
+uint32_t
+_cc_hamt_index(uint32_t bitmap, uint32_t slot)
+{
+  return (uint32_t) __builtin_popcount(bitmap & (slot - 1));
+}
+
+bool
+_cc_hamt_matches(const struct cc_hamt* self,
+                 const struct cc_hamt_leaf* leaf,
+                 uint64_t hash,
+                 const void* key)
+{
+  return leaf->hash == hash
+      && self->key_functions.equality(leaf->key, key, self->key_size);
+}
+
+struct cc_hamt_leaf*
+_cc_hamt_new_leaf(const struct cc_hamt* self,
+                  uint64_t hash,
+                  const void* key,
+                  const void* value)
+{
+  size_t header = (sizeof(struct cc_hamt_leaf) + 15) & ~(size_t) 15;
+  void* buffer = malloc(header + self->value_size + self->key_size);
+  struct cc_hamt_leaf* leaf = (struct cc_hamt_leaf*) buffer;
+  if (!leaf)
+  {
+    return NULL;
+  }
+
+  atomic_init(&leaf->references, 1);
+  leaf->hash = hash;
+  leaf->value = buffer + header;
+  leaf->key = leaf->value + self->value_size;
+  self->key_functions.copier(leaf->key, key, self->key_size);
+  if (self->value_size > 0)
+  {
+    self->value_functions.copier(leaf->value, value, self->value_size);
+  }
+  return leaf;
+}
+
+struct cc_hamt_node*
+_cc_hamt_new_node(uint32_t count)
+{
+  size_t size = sizeof(struct cc_hamt_node)
+              + count * sizeof(struct cc_hamt_node*);
+  struct cc_hamt_node* node = (struct cc_hamt_node*) malloc(size);
+  if (node)
+  {
+    atomic_init(&node->references, 1);
+    node->bitmap = 0;
+    node->count = count;
+    node->collision = false;
+  }
+  return node;
+}
+
+void
+_cc_hamt_retain(struct cc_hamt_node* entry)
+{
+  if (_cc_hamt_is_leaf(entry))
+  {
+    atomic_fetch_add(&_cc_hamt_as_leaf(entry)->references, 1);
+  }
+  else if (entry)
+  {
+    atomic_fetch_add(&entry->references, 1);
+  }
+}
+
+void
+_cc_hamt_release(const struct cc_hamt* self, struct cc_hamt_node* entry)
+{
+  if (_cc_hamt_is_leaf(entry))
+  {
+    struct cc_hamt_leaf* leaf = _cc_hamt_as_leaf(entry);
+    if (atomic_fetch_sub(&leaf->references, 1) == 1)
+    {
+      self->key_functions.deleter(leaf->key);
+      if (self->value_size > 0)
+      {
+        self->value_functions.deleter(leaf->value);
+      }
+      free(leaf);
+    }
+  }
+  else if (entry)
+  {
+    if (atomic_fetch_sub(&entry->references, 1) == 1)
+    {
+      for (uint32_t n = 0; n < entry->count; ++n)
+      {
+        _cc_hamt_release(self, entry->entries[n]);
+      }
+      free(entry);
+    }
+  }
+}
+
+struct cc_hamt_node*
+_cc_hamt_clone(const struct cc_hamt_node* node,
+               uint32_t count,
+               uint32_t skip)
+{
+  // Copy a node into one with room for count entries, leaving out the entry
+  // at position skip (if any) and taking a reference to the others.
+  struct cc_hamt_node* copy = _cc_hamt_new_node(count);
+  if (!copy)
+  {
+    return NULL;
+  }
+  copy->bitmap = node->bitmap;
+  copy->collision = node->collision;
+  for (uint32_t n = 0; n < node->count && n < count; ++n)
+  {
+    copy->entries[n] = node->entries[n];
+    if (n != skip)
+    {
+      _cc_hamt_retain(copy->entries[n]);
+    }
+  }
+  return copy;
+}
+
+void
+_cc_hamt_unmerge(struct cc_hamt_node* node)
+{
+  // Free a subtree built by _cc_hamt_merge() without releasing its leaves.
+  for (uint32_t n = 0; n < node->count; ++n)
+  {
+    if (!_cc_hamt_is_leaf(node->entries[n]))
+    {
+      _cc_hamt_unmerge(node->entries[n]);
+    }
+  }
+  free(node);
+}
+
+struct cc_hamt_node*
+_cc_hamt_merge(struct cc_hamt_leaf* a,
+               struct cc_hamt_leaf* b,
+               unsigned int shift)
+{
+  // Build the smallest subtree holding two leaves whose hashes agree on all
+  // bits below shift.  The leaves' references pass to the subtree, or stay
+  // with the caller if an allocation fails and NULL is returned.
+  struct cc_hamt_node* node;
+  if (shift >= 64)
+  {
+    node = _cc_hamt_new_node(2);
+    if (node)
+    {
+      node->collision = true;
+      node->entries[0] = _cc_hamt_tag(a);
+      node->entries[1] = _cc_hamt_tag(b);
+    }
+    return node;
+  }
+
+  uint32_t slot_a = _cc_hamt_slot(a->hash, shift);
+  uint32_t slot_b = _cc_hamt_slot(b->hash, shift);
+  if (slot_a == slot_b)
+  {
+    struct cc_hamt_node* child = _cc_hamt_merge(a, b, shift + _cc_hamt_bits);
+    node = child ? _cc_hamt_new_node(1) : NULL;
+    if (node)
+    {
+      node->bitmap = slot_a;
+      node->entries[0] = child;
+    }
+    else if (child)
+    {
+      _cc_hamt_unmerge(child);
+    }
+    return node;
+  }
+
+  node = _cc_hamt_new_node(2);
+  if (node)
+  {
+    node->bitmap = slot_a | slot_b;
+    node->entries[slot_a < slot_b ? 0 : 1] = _cc_hamt_tag(a);
+    node->entries[slot_a < slot_b ? 1 : 0] = _cc_hamt_tag(b);
+  }
+  return node;
+}
+
+struct cc_hamt_node*
+_cc_hamt_put(const struct cc_hamt* self,
+             const struct cc_hamt_node* node,
+             unsigned int shift,
+             struct cc_hamt_leaf* leaf,
+             bool* added)
+{
+  // Return a copy of node with the leaf stored in it, sharing everything off
+  // the path to the leaf.  The copy takes the caller's reference to the leaf;
+  // on failure the reference is released and NULL is returned.
+  struct cc_hamt_node* copy;
+  if (node->collision)
+  {
+    for (uint32_t n = 0; n < node->count; ++n)
+    {
+      const struct cc_hamt_leaf* other = _cc_hamt_as_leaf(node->entries[n]);
+      if (_cc_hamt_matches(self, other, leaf->hash, leaf->key))
+      {
+        copy = _cc_hamt_clone(node, node->count, n);
+        if (copy)
+        {
+          copy->entries[n] = _cc_hamt_tag(leaf);
+        }
+        else
+        {
+          _cc_hamt_release(self, _cc_hamt_tag(leaf));
+        }
+        return copy;
+      }
+    }
+    copy = _cc_hamt_clone(node, node->count + 1, node->count);
+    if (copy)
+    {
+      copy->entries[node->count] = _cc_hamt_tag(leaf);
+      *added = true;
+    }
+    else
+    {
+      _cc_hamt_release(self, _cc_hamt_tag(leaf));
+    }
+    return copy;
+  }
+
+  uint32_t slot = _cc_hamt_slot(leaf->hash, shift);
+  uint32_t index = _cc_hamt_index(node->bitmap, slot);
+  if (!(node->bitmap & slot))
+  {
+    copy = _cc_hamt_new_node(node->count + 1);
+    if (copy)
+    {
+      copy->bitmap = node->bitmap | slot;
+      for (uint32_t n = 0; n < node->count; ++n)
+      {
+        copy->entries[n < index ? n : n + 1] = node->entries[n];
+        _cc_hamt_retain(node->entries[n]);
+      }
+      copy->entries[index] = _cc_hamt_tag(leaf);
+      *added = true;
+    }
+    else
+    {
+      _cc_hamt_release(self, _cc_hamt_tag(leaf));
+    }
+    return copy;
+  }
+
+  struct cc_hamt_node* entry = node->entries[index];
+  struct cc_hamt_node* replacement;
+  if (_cc_hamt_is_leaf(entry))
+  {
+    struct cc_hamt_leaf* existing = _cc_hamt_as_leaf(entry);
+    if (_cc_hamt_matches(self, existing, leaf->hash, leaf->key))
+    {
+      replacement = _cc_hamt_tag(leaf);
+    }
+    else
+    {
+      _cc_hamt_retain(entry);
+      replacement = _cc_hamt_merge(existing, leaf, shift + _cc_hamt_bits);
+      if (!replacement)
+      {
+        _cc_hamt_release(self, entry);
+        _cc_hamt_release(self, _cc_hamt_tag(leaf));
+        return NULL;
+      }
+      *added = true;
+    }
+  }
+  else
+  {
+    replacement = _cc_hamt_put(
+        self,
+        entry,
+        shift + _cc_hamt_bits,
+        leaf,
+        added
+      );
+    if (!replacement)
+    {
+      return NULL;
+    }
+  }
+
+  copy = _cc_hamt_clone(node, node->count, index);
+  if (!copy)
+  {
+    _cc_hamt_release(self, replacement);
+    return NULL;
+  }
+  copy->entries[index] = replacement;
+  return copy;
+}
+
+struct cc_hamt_node*
+_cc_hamt_without(const struct cc_hamt_node* node,
+                 uint32_t index,
+                 uint32_t slot)
+{
+  struct cc_hamt_node* copy = _cc_hamt_new_node(node->count - 1);
+  if (copy)
+  {
+    copy->bitmap = node->bitmap & ~slot;
+    copy->collision = node->collision;
+    for (uint32_t n = 0; n < node->count; ++n)
+    {
+      if (n != index)
+      {
+        copy->entries[n < index ? n : n - 1] = node->entries[n];
+        _cc_hamt_retain(node->entries[n]);
+      }
+    }
+  }
+  return copy;
+}
+
+struct cc_hamt_node*
+_cc_hamt_remove(const struct cc_hamt* self,
+                const struct cc_hamt_node* node,
+                unsigned int shift,
+                uint64_t hash,
+                const void* key,
+                bool* found)
+{
+  // Return the entry that replaces node once the key is removed: NULL when
+  // nothing is left, or a lone leaf, which the parent stores inline so that
+  // every version has the same shape for the same keys.
+  if (node->collision)
+  {
+    for (uint32_t n = 0; n < node->count; ++n)
+    {
+      if (_cc_hamt_matches(self, _cc_hamt_as_leaf(node->entries[n]), hash, key))
+      {
+        *found = true;
+        if (node->count == 2)
+        {
+          _cc_hamt_retain(node->entries[1 - n]);
+          return node->entries[1 - n];
+        }
+        return _cc_hamt_without(node, n, 0);
+      }
+    }
+    return NULL;
+  }
+
+  uint32_t slot = _cc_hamt_slot(hash, shift);
+  if (!(node->bitmap & slot))
+  {
+    return NULL;
+  }
+  uint32_t index = _cc_hamt_index(node->bitmap, slot);
+  struct cc_hamt_node* entry = node->entries[index];
+
+  struct cc_hamt_node* replacement = NULL;
+  if (_cc_hamt_is_leaf(entry))
+  {
+    if (!_cc_hamt_matches(self, _cc_hamt_as_leaf(entry), hash, key))
+    {
+      return NULL;
+    }
+    *found = true;
+  }
+  else
+  {
+    replacement = _cc_hamt_remove(
+        self,
+        entry,
+        shift + _cc_hamt_bits,
+        hash,
+        key,
+        found
+      );
+    if (!*found)
+    {
+      return NULL;
+    }
+  }
+
+  if (!replacement)
+  {
+    if (node->count == 1)
+    {
+      return NULL;
+    }
+    if (node->count == 2 && shift > 0
+        && _cc_hamt_is_leaf(node->entries[1 - index]))
+    {
+      _cc_hamt_retain(node->entries[1 - index]);
+      return node->entries[1 - index];
+    }
+    return _cc_hamt_without(node, index, slot);
+  }
+
+  if (node->count == 1 && shift > 0 && _cc_hamt_is_leaf(replacement))
+  {
+    return replacement;
+  }
+  struct cc_hamt_node* copy = _cc_hamt_clone(node, node->count, index);
+  if (!copy)
+  {
+    _cc_hamt_release(self, replacement);
+    return NULL;
+  }
+  copy->entries[index] = replacement;
+  return copy;
+}
+
+void
+_cc_hamt_visit(const struct cc_hamt_node* entry,
+               cc_hamt_visit_fn visit,
+               void* arg)
+{
+  if (_cc_hamt_is_leaf(entry))
+  {
+    const struct cc_hamt_leaf* leaf = _cc_hamt_as_leaf(entry);
+    visit(leaf->key, leaf->value, arg);
+  }
+  else
+  {
+    for (uint32_t n = 0; n < entry->count; ++n)
+    {
+      _cc_hamt_visit(entry->entries[n], visit, arg);
+    }
+  }
+}
+
+bool
+_cc_hamt_subset(const struct cc_hamt* self,
+                const struct cc_hamt_node* entry,
+                const struct cc_hamt* other)
+{
+  if (_cc_hamt_is_leaf(entry))
+  {
+    const struct cc_hamt_leaf* leaf = _cc_hamt_as_leaf(entry);
+    const void* value = cc_hamt_find(other, leaf->key);
+    return value && (self->value_size == 0
+                     || self->value_functions.equality(
+                         leaf->value,
+                         value,
+                         self->value_size
+                       ));
+  }
+  for (uint32_t n = 0; n < entry->count; ++n)
+  {
+    if (!_cc_hamt_subset(self, entry->entries[n], other))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct cc_hamt*
+_cc_hamt_version(const struct cc_hamt* self,
+                 struct cc_hamt_node* root,
+                 size_t size)
+{
+  void* buffer = malloc(sizeof(struct cc_hamt));
+  struct cc_hamt* version = (struct cc_hamt*) buffer;
+  if (!version)
+  {
+    _cc_hamt_release(self, root);
+    return NULL;
+  }
+  *version = *self;
+  version->root = root;
+  version->size = size;
+  return version;
+}
+
+struct cc_hamt*
+cc_hamt_new(size_t key_size, size_t value_size)
+{
+  return cc_hamt_new_f(
+      key_size,
+      value_size,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_hamt*
+cc_hamt_new_f(size_t key_size,
+              size_t value_size,
+              const struct cc_functions key_functions,
+              const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_hamt));
+  struct cc_hamt* self = (struct cc_hamt*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->size = 0;
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->seed = cc_hash_seed();
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->root = NULL;
+
+  return self;
+}
+
+struct cc_hamt*
+cc_hamt_copy(const struct cc_hamt* other)
+{
+  if (other)
+  {
+    _cc_hamt_retain(other->root);
+    return _cc_hamt_version(other, other->root, other->size);
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void
+cc_hamt_delete(struct cc_hamt* self)
+{
+  if (self)
+  {
+    _cc_hamt_release(self, self->root);
+    free(self);
+  }
+}
+
+bool
+cc_hamt_empty(const struct cc_hamt* self)
+{
+  if (self)
+  {
+    return self->size == 0;
+  }
+  else
+  {
+    return true;
+  }
+}
+
+size_t
+cc_hamt_size(const struct cc_hamt* self)
+{
+  if (self)
+  {
+    return self->size;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+struct cc_hamt*
+cc_hamt_insert(const struct cc_hamt* self,
+               const void* key,
+               const void* value)
+{
+  if (!self || !key || (!value && self->value_size > 0))
+  {
+    return NULL;
+  }
+
+  uint64_t hash = _cc_hamt_hash(self, key);
+  struct cc_hamt_leaf* leaf = _cc_hamt_new_leaf(self, hash, key, value);
+  if (!leaf)
+  {
+    return NULL;
+  }
+
+  // The new root takes the leaf's reference, or releases it on failure, so
+  // hold a second one until the root is built.
+  bool added = false;
+  struct cc_hamt_node* root;
+  _cc_hamt_retain(_cc_hamt_tag(leaf));
+  if (self->root)
+  {
+    root = _cc_hamt_put(self, self->root, 0, leaf, &added);
+  }
+  else
+  {
+    root = _cc_hamt_new_node(1);
+    if (root)
+    {
+      root->bitmap = _cc_hamt_slot(hash, 0);
+      root->entries[0] = _cc_hamt_tag(leaf);
+      added = true;
+    }
+    else
+    {
+      _cc_hamt_release(self, _cc_hamt_tag(leaf));
+    }
+  }
+  _cc_hamt_release(self, _cc_hamt_tag(leaf));
+  if (!root)
+  {
+    return NULL;
+  }
+
+  return _cc_hamt_version(self, root, self->size + (added ? 1 : 0));
+}
+
+struct cc_hamt*
+cc_hamt_erase(const struct cc_hamt* self, const void* key)
+{
+  if (!self || !key)
+  {
+    return NULL;
+  }
+
+  bool found = false;
+  struct cc_hamt_node* root = NULL;
+  if (self->root)
+  {
+    root = _cc_hamt_remove(
+        self,
+        self->root,
+        0,
+        _cc_hamt_hash(self, key),
+        key,
+        &found
+      );
+  }
+  if (!found)
+  {
+    return cc_hamt_copy(self);
+  }
+
+  return _cc_hamt_version(self, root, self->size - 1);
+}
+
+const void*
+cc_hamt_find(const struct cc_hamt* self, const void* key)
+{
+  if (!self || !key || !self->root)
+  {
+    return NULL;
+  }
+
+  uint64_t hash = _cc_hamt_hash(self, key);
+  const struct cc_hamt_node* node = self->root;
+  unsigned int shift = 0;
+  while (true)
+  {
+    if (node->collision)
+    {
+      for (uint32_t n = 0; n < node->count; ++n)
+      {
+        const struct cc_hamt_leaf* leaf = _cc_hamt_as_leaf(node->entries[n]);
+        if (_cc_hamt_matches(self, leaf, hash, key))
+        {
+          return leaf->value;
+        }
+      }
+      return NULL;
+    }
+
+    uint32_t slot = _cc_hamt_slot(hash, shift);
+    if (!(node->bitmap & slot))
+    {
+      return NULL;
+    }
+    node = node->entries[_cc_hamt_index(node->bitmap, slot)];
+    if (_cc_hamt_is_leaf(node))
+    {
+      const struct cc_hamt_leaf* leaf = _cc_hamt_as_leaf(node);
+      return _cc_hamt_matches(self, leaf, hash, key) ? leaf->value : NULL;
+    }
+    shift += _cc_hamt_bits;
+  }
+}
+
+bool
+cc_hamt_contains(const struct cc_hamt* self, const void* key)
+{
+  return cc_hamt_find(self, key) != NULL;
+}
+
+void
+cc_hamt_for_each(const struct cc_hamt* self,
+                 cc_hamt_visit_fn visit,
+                 void* arg)
+{
+  if (self && self->root && visit)
+  {
+    _cc_hamt_visit(self->root, visit, arg);
+  }
+}
+
+bool
+cc_hamt_eq(const struct cc_hamt* self, const struct cc_hamt* other)
+{
+  if (self && other)
+  {
+    if (self->size != other->size)
+    {
+      return false;
+    }
+    if (self->root == other->root)
+    {
+      return true;
+    }
+    return _cc_hamt_subset(self, self->root, other);
+  }
+  else
+  {
+    return self == other;
+  }
+}
+
+bool
+cc_hamt_ne(const struct cc_hamt* self, const struct cc_hamt* other)
+{
+  return !cc_hamt_eq(self, other);
+}
@@ -0,0 +1,99 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_HAMT_H
+#define CC_HAMT_H
+
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A persistent hash map built as a hash array mapped trie.  Each level of the
+// trie consumes five bits of a key's hash and stores only the slots in use,
+// found through a 32-bit bitmap.  Maps are immutable: insert and erase return
+// a new map that shares every untouched node with the original, so a copy
+// costs one reference count increment and an update copies one path of at
+// most thirteen nodes.  Nodes and entries are reference counted atomically,
+// and each map must be deleted on its own, so versions may be handed to
+// other threads freely.
+struct cc_hamt_node;
+
+struct cc_hamt
+{
+  size_t size;
+  size_t key_size;
+  size_t value_size;
+  uint64_t seed;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  struct cc_hamt_node* root;
+};
+
+typedef struct cc_hamt* cc_hamt_t;
+
+typedef void (*cc_hamt_visit_fn)(const void* key,
+                                 const void* value,
+                                 void* arg);
+
+struct cc_hamt*
+cc_hamt_new(size_t key_size, size_t value_size);
+
+struct cc_hamt*
+cc_hamt_new_f(size_t key_size,
+              size_t value_size,
+              const struct cc_functions key_functions,
+              const struct cc_functions value_functions);
+
+struct cc_hamt*
+cc_hamt_copy(const struct cc_hamt* other);
+
+void
+cc_hamt_delete(struct cc_hamt* self);
+
+bool
+cc_hamt_empty(const struct cc_hamt* self);
+
+size_t
+cc_hamt_size(const struct cc_hamt* self);
+
+// Insert and erase return NULL if an allocation fails, in which case self
+// and every other version are left as they were.
+struct cc_hamt*
+cc_hamt_insert(const struct cc_hamt* self,
+               const void* key,
+               const void* value);
+
+struct cc_hamt*
+cc_hamt_erase(const struct cc_hamt* self, const void* key);
+
+const void*
+cc_hamt_find(const struct cc_hamt* self, const void* key);
+
+bool
+cc_hamt_contains(const struct cc_hamt* self, const void* key);
+
+void
+cc_hamt_for_each(const struct cc_hamt* self,
+                 cc_hamt_visit_fn visit,
+                 void* arg);
+
+bool
+cc_hamt_eq(const struct cc_hamt* self, const struct cc_hamt* other);
+
+bool
+cc_hamt_ne(const struct cc_hamt* self, const struct cc_hamt* other);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_HAMT_H
@@ -0,0 +1,216 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_hll.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+const uint32_t _cc_hll_min_precision = 4;
+
+const uint32_t _cc_hll_max_precision = 18;
+
+uint8_t
+_cc_hll_rank(uint64_t bits)
+{
+#if defined(__GNUC__)
+  return (uint8_t) (__builtin_clzll(bits) + 1);
+#else
+  uint8_t rank = 1;
+  while (!(bits & ((uint64_t) 1 << 63)))
+  {
+    bits <<= 1;
+    ++rank;
+  }
+  return rank;
+#endif
+}
+
+struct cc_hll*
+cc_hll_new(uint32_t precision)
+{
+  return cc_hll_new_f(precision, cc_default_hasher);
+}
+
+struct cc_hll*
+cc_hll_new_f(uint32_t precision, cc_hash_fn hasher)
+{
+  void* buffer = malloc(sizeof(struct cc_hll));
+  struct cc_hll* self = (struct cc_hll*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  if (precision < _cc_hll_min_precision)
+  {
+    precision = _cc_hll_min_precision;
+  }
+  if (precision > _cc_hll_max_precision)
+  {
+    precision = _cc_hll_max_precision;
+  }
+
+  self->precision = precision;
+  self->register_count = (size_t) 1 << precision;
+  self->hasher = hasher ? hasher : cc_default_hasher;
+  self->registers = (uint8_t*) aligned_alloc(16, self->register_count);
+  if (!self->registers)
+  {
+    free(self);
+    return NULL;
+  }
+  memset(self->registers, 0, self->register_count);
+
+  return self;
+}
+
+struct cc_hll*
+cc_hll_copy(const struct cc_hll* other)
+{
+  struct cc_hll* self = cc_hll_new_f(other->precision, other->hasher);
+  if (self)
+  {
+    memcpy(self->registers, other->registers, other->register_count);
+  }
+  return self;
+}
+
+void
+cc_hll_delete(struct cc_hll* self)
+{
+  if (self)
+  {
+    free(self->registers);
+    free(self);
+  }
+}
+
+uint32_t
+cc_hll_precision(const struct cc_hll* self)
+{
+  if (self)
+  {
+    return self->precision;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_hll_clear(struct cc_hll* self)
+{
+  if (self)
+  {
+    memset(self->registers, 0, self->register_count);
+  }
+}
+
+void
+cc_hll_add(struct cc_hll* self, const void* key, size_t size)
+{
+  if (self && key)
+  {
+    cc_hll_add_hash(self, self->hasher(key, size));
+  }
+}
+
+void
+cc_hll_add_hash(struct cc_hll* self, uint64_t hash)
+{
+  if (self)
+  {
+    // A guard bit below the shifted hash bounds the rank when the remaining
+    // bits are all zero.
+    size_t index = (size_t) (hash >> (64 - self->precision));
+    uint64_t bits = (hash << self->precision)
+                  | ((uint64_t) 1 << (self->precision - 1));
+    uint8_t rank = _cc_hll_rank(bits);
+    if (rank > self->registers[index])
+    {
+      self->registers[index] = rank;
+    }
+  }
+}
+
+bool
+cc_hll_merge(struct cc_hll* self, const struct cc_hll* other)
+{
+  if (self && other && self->precision == other->precision)
+  {
+    size_t n = 0;
+#if defined(__SSE2__)
+    for (; n + 16 <= self->register_count; n += 16)
+    {
+      __m128i* dest = (__m128i*) (self->registers + n);
+      __m128i src = _mm_load_si128((const __m128i*) (other->registers + n));
+      _mm_store_si128(dest, _mm_max_epu8(_mm_load_si128(dest), src));
+    }
+#endif
+    for (; n < self->register_count; ++n)
+    {
+      if (other->registers[n] > self->registers[n])
+      {
+        self->registers[n] = other->registers[n];
+      }
+    }
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+double
+cc_hll_estimate(const struct cc_hll* self)
+{
+  if (!self)
+  {
+    return 0.0;
+  }
+
+  // Summing a histogram of the register values needs one power of two per
+  // distinct rank rather than one per register.
+  size_t histogram[66] = { 0 };
+  for (size_t n = 0; n < self->register_count; ++n)
+  {
+    ++histogram[self->registers[n]];
+  }
+  double sum = 0.0;
+  double power = 1.0;
+  for (size_t rank = 0; rank < 66; ++rank, power /= 2.0)
+  {
+    sum += (double) histogram[rank] * power;
+  }
+
+  double m = (double) self->register_count;
+  double alpha = self->precision == 4 ? 0.673
+               : self->precision == 5 ? 0.697
+               : self->precision == 6 ? 0.709
+               : 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+
+  // Small cardinalities are estimated better by linear counting.
+  if (estimate <= 2.5 * m)
+  {
+    size_t zeros = histogram[0];
+    if (zeros > 0)
+    {
+      estimate = m * cc_log(m / (double) zeros);
+    }
+  }
+  return estimate;
+}
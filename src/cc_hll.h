@@ -0,0 +1,70 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_HLL_H
+#define CC_HLL_H
+
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A HyperLogLog sketch of the number of distinct keys added to it.  The top
+// precision bits of a key's 64-bit hash pick one of 2^precision byte-sized
+// registers, which keeps the longest run of leading zeros seen in the rest of
+// the hash.  The standard error is about 1.04 / sqrt(2^precision), and
+// sketches built separately, for instance one per thread, merge into the
+// sketch of the union of their keys.
+struct cc_hll
+{
+  uint32_t precision;
+  size_t register_count;
+  cc_hash_fn hasher;
+  uint8_t* registers;
+};
+
+typedef struct cc_hll* cc_hll_t;
+
+struct cc_hll*
+cc_hll_new(uint32_t precision);
+
+struct cc_hll*
+cc_hll_new_f(uint32_t precision, cc_hash_fn hasher);
+
+struct cc_hll*
+cc_hll_copy(const struct cc_hll* other);
+
+void
+cc_hll_delete(struct cc_hll* self);
+
+uint32_t
+cc_hll_precision(const struct cc_hll* self);
+
+void
+cc_hll_clear(struct cc_hll* self);
+
+void
+cc_hll_add(struct cc_hll* self, const void* key, size_t size);
+
+void
+cc_hll_add_hash(struct cc_hll* self, uint64_t hash);
+
+bool
+cc_hll_merge(struct cc_hll* self, const struct cc_hll* other);
+
+double
+cc_hll_estimate(const struct cc_hll* self);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_HLL_H
@@ -18,7 +18,8 @@ const struct cc_functions cc_list_functions = (struct cc_functions){
   .hasher = cc_list_hasher,
   .copier = cc_list_copier,
   .deleter = cc_list_deleter,
-  .equality = cc_list_equality
+  .equality = cc_list_equality,
+  .relocator = cc_default_relocator
 };
 
 void
@@ -519,21 +520,33 @@ void
 cc_list_push_back(struct cc_list* self, const void* value)
 {
   if (self && value)
+  {
+    void* data = cc_list_emplace_back(self);
+    if (data)
+    {
+      self->functions.copier(data, value, self->element_size);
+    }
+  }
+}
+
+void*
+cc_list_emplace_back(struct cc_list* self)
+{
+  if (self)
   {
     void* buffer = malloc(sizeof(struct cc_list_node));
     struct cc_list_node* node = (struct cc_list_node*) buffer;
     if (!node)
     {
-      return;
+      return NULL;
     }
 
     void* data = malloc(self->element_size);
     if (!data)
     {
       free(node);
-      return;
+      return NULL;
     }
-    self->functions.copier(data, value, self->element_size);
 
     node->prev = self->back;
     node->next = NULL;
@@ -555,6 +568,11 @@ cc_list_push_back(struct cc_list* self, const void* value)
     }
 
     ++self->size;
+    return data;
+  }
+  else
+  {
+    return NULL;
   }
 }
 
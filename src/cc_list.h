@@ -119,6 +119,9 @@ cc_list_erase(struct cc_list* self,
 void
 cc_list_push_back(struct cc_list* self, const void* value);
 
+void*
+cc_list_emplace_back(struct cc_list* self);
+
 void
 cc_list_pop_back(struct cc_list* self);
 
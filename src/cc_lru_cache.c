@@ -0,0 +1,487 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_lru_cache.h"
+
+const uint32_t _cc_lru_cache_none = UINT32_MAX;
+
+uint64_t
+_cc_lru_cache_hash(const struct cc_lru_cache* self, const void* key)
+{
+  return cc_hash_seeded(&self->key_functions, key, self->key_size, self->seed);
+}
+
+void*
+_cc_lru_cache_key(const struct cc_lru_cache* self, uint32_t entry)
+{
+  return self->keys + entry * self->key_size;
+}
+
+void*
+_cc_lru_cache_value(const struct cc_lru_cache* self, uint32_t entry)
+{
+  return self->values + entry * self->value_size;
+}
+
+uint32_t
+_cc_lru_cache_lookup(const struct cc_lru_cache* self,
+                     const void* key,
+                     uint64_t hash,
+                     size_t* slot)
+{
+  size_t mask = self->index_capacity - 1;
+  size_t pos = (size_t) hash & mask;
+  while (self->index[pos] != 0)
+  {
+    uint32_t entry = self->index[pos] - 1;
+    if (self->hashes[entry] == hash
+        && self->key_functions.equality(
+            key,
+            _cc_lru_cache_key(self, entry),
+            self->key_size
+          ))
+    {
+      *slot = pos;
+      return entry;
+    }
+    pos = (pos + 1) & mask;
+  }
+
+  *slot = pos;
+  return _cc_lru_cache_none;
+}
+
+void
+_cc_lru_cache_remove_slot(struct cc_lru_cache* self, size_t pos)
+{
+  // Backward-shift deletion: later members of the probe run move into the
+  // hole unless their home slot lies after it, so no tombstones are needed.
+  size_t mask = self->index_capacity - 1;
+  size_t next = pos;
+  self->index[pos] = 0;
+  while (true)
+  {
+    next = (next + 1) & mask;
+    if (self->index[next] == 0)
+    {
+      break;
+    }
+    size_t home = (size_t) self->hashes[self->index[next] - 1] & mask;
+    if (((next - home) & mask) >= ((next - pos) & mask))
+    {
+      self->index[pos] = self->index[next];
+      self->index[next] = 0;
+      pos = next;
+    }
+  }
+}
+
+void
+_cc_lru_cache_unlink(struct cc_lru_cache* self, uint32_t entry)
+{
+  struct cc_lru_cache_link* link = self->links + entry;
+  if (link->prev != _cc_lru_cache_none)
+  {
+    self->links[link->prev].next = link->next;
+  }
+  else
+  {
+    self->head = link->next;
+  }
+  if (link->next != _cc_lru_cache_none)
+  {
+    self->links[link->next].prev = link->prev;
+  }
+  else
+  {
+    self->tail = link->prev;
+  }
+}
+
+void
+_cc_lru_cache_push_front(struct cc_lru_cache* self, uint32_t entry)
+{
+  struct cc_lru_cache_link* link = self->links + entry;
+  link->prev = _cc_lru_cache_none;
+  link->next = self->head;
+  if (self->head != _cc_lru_cache_none)
+  {
+    self->links[self->head].prev = entry;
+  }
+  else
+  {
+    self->tail = entry;
+  }
+  self->head = entry;
+}
+
+void
+_cc_lru_cache_touch(struct cc_lru_cache* self, uint32_t entry)
+{
+  if (self->policy == CC_LRU_CACHE_CLOCK)
+  {
+    if (!self->links[entry].referenced)
+    {
+      self->links[entry].referenced = true;
+    }
+  }
+  else if (self->head != entry)
+  {
+    _cc_lru_cache_unlink(self, entry);
+    _cc_lru_cache_push_front(self, entry);
+  }
+}
+
+void
+_cc_lru_cache_release(struct cc_lru_cache* self, uint32_t entry, size_t slot)
+{
+  _cc_lru_cache_remove_slot(self, slot);
+  _cc_lru_cache_unlink(self, entry);
+  self->key_functions.deleter(_cc_lru_cache_key(self, entry));
+  self->value_functions.deleter(_cc_lru_cache_value(self, entry));
+  --(self->size);
+}
+
+uint32_t
+_cc_lru_cache_evict(struct cc_lru_cache* self)
+{
+  // Only a full cache evicts, so the CLOCK hand always points at a live
+  // entry and the sweep ends within two revolutions.
+  uint32_t victim;
+  if (self->policy == CC_LRU_CACHE_CLOCK)
+  {
+    while (self->links[self->hand].referenced)
+    {
+      self->links[self->hand].referenced = false;
+      self->hand = (uint32_t) ((self->hand + 1) % self->capacity);
+    }
+    victim = self->hand;
+    self->hand = (uint32_t) ((self->hand + 1) % self->capacity);
+  }
+  else
+  {
+    victim = self->tail;
+  }
+
+  void* key = _cc_lru_cache_key(self, victim);
+  size_t slot;
+  _cc_lru_cache_lookup(self, key, self->hashes[victim], &slot);
+  if (self->evict)
+  {
+    self->evict(key, _cc_lru_cache_value(self, victim), self->evict_arg);
+  }
+  _cc_lru_cache_release(self, victim, slot);
+  return victim;
+}
+
+void
+_cc_lru_cache_reset(struct cc_lru_cache* self)
+{
+  self->size = 0;
+  self->head = _cc_lru_cache_none;
+  self->tail = _cc_lru_cache_none;
+  self->hand = 0;
+  self->spare = self->capacity > 0 ? 0 : _cc_lru_cache_none;
+  for (size_t n = 0; n < self->capacity; ++n)
+  {
+    self->links[n].prev = _cc_lru_cache_none;
+    self->links[n].next = n + 1 < self->capacity
+                        ? (uint32_t) (n + 1)
+                        : _cc_lru_cache_none;
+    self->links[n].referenced = false;
+  }
+  memset(self->index, 0, self->index_capacity * sizeof(uint32_t));
+}
+
+struct cc_lru_cache*
+cc_lru_cache_new(size_t key_size, size_t value_size, size_t capacity)
+{
+  return cc_lru_cache_new_f(
+      key_size,
+      value_size,
+      capacity,
+      CC_LRU_CACHE_LRU,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_lru_cache*
+cc_lru_cache_new_f(size_t key_size,
+                   size_t value_size,
+                   size_t capacity,
+                   enum cc_lru_cache_policy policy,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions)
+{
+  if (capacity >= UINT32_MAX / 2)
+  {
+    return NULL;
+  }
+
+  void* buffer = malloc(sizeof(struct cc_lru_cache));
+  struct cc_lru_cache* self = (struct cc_lru_cache*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  // The index is kept at most half full, which keeps probe runs short.
+  size_t index_capacity = 8;
+  while (index_capacity < 2 * capacity)
+  {
+    index_capacity <<= 1;
+  }
+
+  self->capacity = capacity;
+  self->index_capacity = index_capacity;
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->policy = policy;
+  self->seed = cc_hash_seed();
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->evict = NULL;
+  self->evict_arg = NULL;
+
+  size_t links_size = capacity * sizeof(struct cc_lru_cache_link);
+  self->index = (uint32_t*) cc_large_alloc(index_capacity * sizeof(uint32_t));
+  self->hashes = (uint64_t*) cc_large_alloc(capacity * sizeof(uint64_t) + 1);
+  self->links = (struct cc_lru_cache_link*) cc_large_alloc(links_size + 1);
+  self->keys = cc_large_alloc(capacity * key_size + 1);
+  self->values = cc_large_alloc(capacity * value_size + 1);
+  if (!self->index || !self->hashes || !self->links || !self->keys
+      || !self->values)
+  {
+    cc_large_free(self->values);
+    cc_large_free(self->keys);
+    cc_large_free(self->links);
+    cc_large_free(self->hashes);
+    cc_large_free(self->index);
+    free(self);
+    return NULL;
+  }
+
+  _cc_lru_cache_reset(self);
+  return self;
+}
+
+void
+cc_lru_cache_delete(struct cc_lru_cache* self)
+{
+  if (self)
+  {
+    cc_lru_cache_clear(self);
+    cc_large_free(self->values);
+    cc_large_free(self->keys);
+    cc_large_free(self->links);
+    cc_large_free(self->hashes);
+    cc_large_free(self->index);
+    free(self);
+  }
+}
+
+void
+cc_lru_cache_set_eviction_callback(struct cc_lru_cache* self,
+                                   cc_lru_cache_evict_fn evict,
+                                   void* arg)
+{
+  if (self)
+  {
+    self->evict = evict;
+    self->evict_arg = arg;
+  }
+}
+
+enum cc_lru_cache_policy
+cc_lru_cache_policy(const struct cc_lru_cache* self)
+{
+  if (self)
+  {
+    return self->policy;
+  }
+  else
+  {
+    return CC_LRU_CACHE_LRU;
+  }
+}
+
+bool
+cc_lru_cache_empty(const struct cc_lru_cache* self)
+{
+  if (self)
+  {
+    return self->size == 0;
+  }
+  else
+  {
+    return true;
+  }
+}
+
+size_t
+cc_lru_cache_size(const struct cc_lru_cache* self)
+{
+  if (self)
+  {
+    return self->size;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_lru_cache_capacity(const struct cc_lru_cache* self)
+{
+  if (self)
+  {
+    return self->capacity;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_lru_cache_clear(struct cc_lru_cache* self)
+{
+  if (self)
+  {
+    for (uint32_t entry = self->head; entry != _cc_lru_cache_none;)
+    {
+      self->key_functions.deleter(_cc_lru_cache_key(self, entry));
+      self->value_functions.deleter(_cc_lru_cache_value(self, entry));
+      entry = self->links[entry].next;
+    }
+    _cc_lru_cache_reset(self);
+  }
+}
+
+void
+cc_lru_cache_put(struct cc_lru_cache* self,
+                 const void* key,
+                 const void* value)
+{
+  if (self && key && value && self->capacity > 0)
+  {
+    uint64_t hash = _cc_lru_cache_hash(self, key);
+    size_t slot;
+    uint32_t entry = _cc_lru_cache_lookup(self, key, hash, &slot);
+    if (entry != _cc_lru_cache_none)
+    {
+      void* dest = _cc_lru_cache_value(self, entry);
+      self->value_functions.deleter(dest);
+      self->value_functions.copier(dest, value, self->value_size);
+      _cc_lru_cache_touch(self, entry);
+      return;
+    }
+
+    if (self->spare != _cc_lru_cache_none)
+    {
+      entry = self->spare;
+      self->spare = self->links[entry].next;
+    }
+    else
+    {
+      // Evicting may shift the probe run that ends in the empty slot.
+      entry = _cc_lru_cache_evict(self);
+      _cc_lru_cache_lookup(self, key, hash, &slot);
+    }
+
+    self->key_functions.copier(
+        _cc_lru_cache_key(self, entry),
+        key,
+        self->key_size
+      );
+    self->value_functions.copier(
+        _cc_lru_cache_value(self, entry),
+        value,
+        self->value_size
+      );
+    self->hashes[entry] = hash;
+    self->links[entry].referenced = false;
+    self->index[slot] = entry + 1;
+    _cc_lru_cache_push_front(self, entry);
+    ++(self->size);
+  }
+}
+
+void*
+cc_lru_cache_get(struct cc_lru_cache* self, const void* key)
+{
+  if (self && key && self->size > 0)
+  {
+    size_t slot;
+    uint32_t entry = _cc_lru_cache_lookup(
+        self,
+        key,
+        _cc_lru_cache_hash(self, key),
+        &slot
+      );
+    if (entry != _cc_lru_cache_none)
+    {
+      _cc_lru_cache_touch(self, entry);
+      return _cc_lru_cache_value(self, entry);
+    }
+  }
+  return NULL;
+}
+
+void*
+cc_lru_cache_peek(const struct cc_lru_cache* self, const void* key)
+{
+  if (self && key && self->size > 0)
+  {
+    size_t slot;
+    uint32_t entry = _cc_lru_cache_lookup(
+        self,
+        key,
+        _cc_lru_cache_hash(self, key),
+        &slot
+      );
+    if (entry != _cc_lru_cache_none)
+    {
+      return _cc_lru_cache_value(self, entry);
+    }
+  }
+  return NULL;
+}
+
+bool
+cc_lru_cache_contains(const struct cc_lru_cache* self, const void* key)
+{
+  return cc_lru_cache_peek(self, key) != NULL;
+}
+
+void
+cc_lru_cache_erase(struct cc_lru_cache* self, const void* key)
+{
+  if (self && key && self->size > 0)
+  {
+    size_t slot;
+    uint32_t entry = _cc_lru_cache_lookup(
+        self,
+        key,
+        _cc_lru_cache_hash(self, key),
+        &slot
+      );
+    if (entry != _cc_lru_cache_none)
+    {
+      _cc_lru_cache_release(self, entry, slot);
+      self->links[entry].next = self->spare;
+      self->spare = entry;
+    }
+  }
+}
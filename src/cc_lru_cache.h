@@ -0,0 +1,128 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_LRU_CACHE_H
+#define CC_LRU_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A fixed-capacity cache.  Entries live in preallocated arrays and are found
+// through an open-addressed index of entry numbers; the recency list is
+// threaded through the entries themselves, so nothing is allocated after
+// construction.  Once the cache is full, every insert of a new key evicts
+// one entry: the least recently used one under CC_LRU_CACHE_LRU, or the
+// first unreferenced one under the CLOCK sweep of CC_LRU_CACHE_CLOCK.  A
+// CLOCK hit only sets the entry's reference bit.
+enum cc_lru_cache_policy
+{
+  CC_LRU_CACHE_LRU,
+  CC_LRU_CACHE_CLOCK
+};
+
+struct cc_lru_cache_link
+{
+  uint32_t prev;
+  uint32_t next;
+  bool referenced;
+};
+
+typedef void (*cc_lru_cache_evict_fn)(const void* key,
+                                      void* value,
+                                      void* arg);
+
+struct cc_lru_cache
+{
+  size_t size;
+  size_t capacity;
+  size_t index_capacity;
+  size_t key_size;
+  size_t value_size;
+  enum cc_lru_cache_policy policy;
+  uint64_t seed;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  cc_lru_cache_evict_fn evict;
+  void* evict_arg;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t hand;
+  uint32_t spare;
+  uint32_t* index;
+  uint64_t* hashes;
+  struct cc_lru_cache_link* links;
+  void* keys;
+  void* values;
+};
+
+typedef struct cc_lru_cache* cc_lru_cache_t;
+
+struct cc_lru_cache*
+cc_lru_cache_new(size_t key_size, size_t value_size, size_t capacity);
+
+struct cc_lru_cache*
+cc_lru_cache_new_f(size_t key_size,
+                   size_t value_size,
+                   size_t capacity,
+                   enum cc_lru_cache_policy policy,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions);
+
+void
+cc_lru_cache_delete(struct cc_lru_cache* self);
+
+void
+cc_lru_cache_set_eviction_callback(struct cc_lru_cache* self,
+                                   cc_lru_cache_evict_fn evict,
+                                   void* arg);
+
+enum cc_lru_cache_policy
+cc_lru_cache_policy(const struct cc_lru_cache* self);
+
+bool
+cc_lru_cache_empty(const struct cc_lru_cache* self);
+
+size_t
+cc_lru_cache_size(const struct cc_lru_cache* self);
+
+size_t
+cc_lru_cache_capacity(const struct cc_lru_cache* self);
+
+void
+cc_lru_cache_clear(struct cc_lru_cache* self);
+
+void
+cc_lru_cache_put(struct cc_lru_cache* self,
+                 const void* key,
+                 const void* value);
+
+void*
+cc_lru_cache_get(struct cc_lru_cache* self, const void* key);
+
+void*
+cc_lru_cache_peek(const struct cc_lru_cache* self, const void* key);
+
+bool
+cc_lru_cache_contains(const struct cc_lru_cache* self, const void* key);
+
+void
+cc_lru_cache_erase(struct cc_lru_cache* self, const void* key);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_LRU_CACHE_H
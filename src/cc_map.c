@@ -8,45 +8,46 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include "cc_map.h"
 
 const size_t cc_map_sizeof = sizeof(struct cc_map);
 
+const uint32_t _cc_map_default_probe_limit = 128;
+
 const struct cc_functions cc_map_functions = (struct cc_functions){
   .hasher = cc_map_hasher,
   .copier = cc_map_copier,
   .deleter = cc_map_deleter,
-  .equality = cc_map_equality
+  .equality = cc_map_equality,
+  .relocator = cc_default_relocator
 };
 
-void
-_cc_map_node_init(struct cc_map* self,
-                     struct cc_map_node* node,
-                     const void* key,
-                     const void* value)
+uint64_t
+_cc_map_hash(const struct cc_map* self, const void* key)
 {
-  self->key_functions.deleter(node->key);
-  self->value_functions.deleter(node->value);
-  self->key_functions.copier(node->key, key, self->key_size);
-  self->value_functions.copier(node->value, value, self->value_size);
-  node->hash = self->key_functions.hasher(key, self->key_size);
-  node->length = 1;
+  return cc_hash_seeded(&self->key_functions, key, self->key_size, self->seed);
 }
 
 void
-_cc_map_node_copy(struct cc_map* self,
-                     struct cc_map_node* node,
-                     const struct cc_map_node* other)
-{
-  self->key_functions.deleter(node->key);
-  self->value_functions.deleter(node->value);
-  self->key_functions.copier(node->key, other->key, self->key_size);
-  self->value_functions.copier(node->value, other->value, self->value_size);
+_cc_map_node_move(struct cc_map* self,
+                  struct cc_map_node* node,
+                  struct cc_map_node* other)
+{
+  cc_relocate(&self->key_functions, node->key, other->key, self->key_size);
+  if (self->value_size > 0)
+  {
+    cc_relocate(
+        &self->value_functions,
+        node->value,
+        other->value,
+        self->value_size
+      );
+  }
   node->hash = other->hash;
   node->length = other->length;
+  other->length = 0;
 }
 
 void
@@ -55,7 +56,10 @@ _cc_map_node_free(struct cc_map* self, struct cc_map_node* node)
   if (node->length > 0)
   {
     self->key_functions.deleter(node->key);
-    self->value_functions.deleter(node->value);
+    if (self->value_size > 0)
+    {
+      self->value_functions.deleter(node->value);
+    }
     node->length = 0;
   }
 }
@@ -63,7 +67,12 @@ _cc_map_node_free(struct cc_map* self, struct cc_map_node* node)
 struct cc_map_node*
 _cc_map_get(const struct cc_map* self, const void* key)
 {
-  uint64_t hash = self->key_functions.hasher(key, self->key_size);
+  uint64_t hash = _cc_map_hash(self, key);
+  if (self->bloom && !cc_bloom_contains_hash(self->bloom, hash))
+  {
+    return NULL;
+  }
+
   size_t pos = ((size_t) hash + self->max_length / 2) % self->capacity;
   struct cc_map_node* node;
 
@@ -71,7 +80,8 @@ _cc_map_get(const struct cc_map* self, const void* key)
   for (size_t n = 1; n <= self->max_length; ++n)
   {
     node = self->nodes + (pos % self->capacity);
-    if (hash == node->hash
+    if (node->length > 0
+        && hash == node->hash
         && self->key_functions.equality(key, node->key, self->key_size))
     {
       return node;
@@ -83,44 +93,162 @@ _cc_map_get(const struct cc_map* self, const void* key)
   return NULL;
 }
 
+void
+_cc_map_displace(struct cc_map* self, size_t pos)
+{
+  // Move the entry at pos, and any entries it displaces in turn, further
+  // along the probe sequence so that pos becomes free.  The two spare nodes
+  // past the end of the table hold entries in transit.
+  struct cc_map_node* current = self->nodes + self->capacity;
+  struct cc_map_node* swap = current + 1;
+  struct cc_map_node* existing = self->nodes + pos;
+
+  _cc_map_node_move(self, current, existing);
+  while (true)
+  {
+    ++current->length;
+    pos = (pos + 1) % self->capacity;
+    existing = self->nodes + pos;
+    if (existing->length == 0)
+    {
+      _cc_map_node_move(self, existing, current);
+      break;
+    }
+    if (current->length > existing->length)
+    {
+      _cc_map_node_move(self, swap, existing);
+      _cc_map_node_move(self, existing, current);
+      _cc_map_node_move(self, current, swap);
+    }
+    if (existing->length > self->max_length)
+    {
+      self->max_length = existing->length;
+    }
+  }
+  if (existing->length > self->max_length)
+  {
+    self->max_length = existing->length;
+  }
+}
+
+struct cc_map_node*
+_cc_map_claim(struct cc_map* self,
+              const void* key,
+              uint64_t hash,
+              bool* inserted)
+{
+  // Find the node that holds the key or, failing that, free the node where
+  // Robin Hood placement puts it.  The key and value of a new node are left
+  // for the caller to initialize.
+  size_t pos = ((size_t) hash) % self->capacity;
+  struct cc_map_node* node = self->nodes + pos;
+  cc_equal_fn equality = self->key_functions.equality;
+  uint32_t length = 1;
+
+  while (node->length > 0)
+  {
+    if (hash == node->hash && equality(node->key, key, self->key_size))
+    {
+      *inserted = false;
+      return node;
+    }
+    if (length > node->length)
+    {
+      _cc_map_displace(self, pos);
+      break;
+    }
+    ++length;
+    pos = (pos + 1) % self->capacity;
+    node = self->nodes + pos;
+  }
+
+  if (self->bloom)
+  {
+    cc_bloom_add_hash(self->bloom, hash);
+  }
+  if (length > self->max_length)
+  {
+    self->max_length = length;
+  }
+  node->hash = hash;
+  node->length = length;
+  ++self->size;
+  *inserted = true;
+  return node;
+}
+
+bool
+_cc_map_place(struct cc_map* self,
+              const void* key,
+              const void* value,
+              uint64_t hash)
+{
+  bool inserted;
+  struct cc_map_node* node = _cc_map_claim(self, key, hash, &inserted);
+  if (inserted)
+  {
+    self->key_functions.copier(node->key, key, self->key_size);
+  }
+  if (self->value_size > 0)
+  {
+    if (!inserted)
+    {
+      self->value_functions.deleter(node->value);
+    }
+    self->value_functions.copier(node->value, value, self->value_size);
+  }
+  return inserted;
+}
+
 size_t
 _cc_map_capacity(const struct cc_map* self, size_t count)
 {
   size_t size = self->size > count ? self->size : count > 0 ? count : 1;
-  size_t exponent = lround(ceil(log2((1.0 / self->max_load_factor) * size)));
-  return 1 << (exponent > 4 ? exponent : 4);
+  double minimum = size / self->max_load_factor;
+  size_t capacity = 16;
+  while ((double) capacity < minimum && capacity <= SIZE_MAX / 4)
+  {
+    capacity <<= 1;
+  }
+  return capacity;
 }
 
-void
+size_t
+_cc_map_bloom_count(const struct cc_map* self)
+{
+  return (size_t) ((double) self->capacity * self->max_load_factor) + 1;
+}
+
+bool
 _cc_map_resize(struct cc_map* self, size_t new_capacity)
 {
-  size_t size;
   size_t length = new_capacity + 2;
-  void* buffer = malloc(length * sizeof(struct cc_map_node));
+  void* buffer = cc_large_alloc(length * sizeof(struct cc_map_node));
   if (!buffer)
   {
-    return;
+    return false;
   }
   struct cc_map_node* nodes = (struct cc_map_node*) buffer;
 
-  size = length * self->key_size;
-  void* keys = malloc(size);
+  void* keys = cc_large_alloc(length * self->key_size);
   if (!keys)
   {
-    free(nodes);
-    return;
+    cc_large_free(nodes);
+    return false;
   }
-  memset(keys, 0, size);
 
-  size = length * self->value_size;
-  void* values = malloc(size);
-  if (!values)
+  // Maps used as sets store no values at all.
+  void* values = NULL;
+  if (self->value_size > 0)
   {
-    free(keys);
-    free(nodes);
-    return;
+    values = cc_large_alloc(length * self->value_size);
+    if (!values)
+    {
+      cc_large_free(keys);
+      cc_large_free(nodes);
+      return false;
+    }
   }
-  memset(values, 0, size);
 
   void* key = keys;
   void* value = values;
@@ -132,7 +260,10 @@ _cc_map_resize(struct cc_map* self, size_t new_capacity)
     node->hash = 0;
     node->length = 0;
     key += self->key_size;
-    value += self->value_size;
+    if (values)
+    {
+      value += self->value_size;
+    }
   }
 
   size_t old_capacity = self->capacity;
@@ -142,22 +273,82 @@ _cc_map_resize(struct cc_map* self, size_t new_capacity)
 
   self->size = 0;
   self->capacity = new_capacity;
+  self->max_length = 0;
   self->nodes = node;
 
+  // Erased keys leave their bits behind, so the filter is rebuilt from the
+  // surviving nodes whenever the table is.
+  if (self->bloom)
+  {
+    cc_bloom_reset(self->bloom, _cc_map_bloom_count(self));
+  }
+
   if (nodes)
   {
+    bool inserted;
+    struct cc_map_node* slot;
     node = nodes;
     for (size_t n = 0; n < old_capacity; ++n, ++node)
     {
       if (node->length > 0)
       {
-        cc_map_insert(self, node->key, node->value);
+        slot = _cc_map_claim(self, node->key, node->hash, &inserted);
+        uint32_t length = slot->length;
+        _cc_map_node_move(self, slot, node);
+        slot->length = length;
       }
     }
 
-    free(nodes->key);
-    free(nodes->value);
-    free(nodes);
+    cc_large_free(nodes->key);
+    cc_large_free(nodes->value);
+    cc_large_free(nodes);
+  }
+  return true;
+}
+
+void
+_cc_map_set_hashes(struct cc_map* self, uint64_t seed)
+{
+  self->seed = seed;
+
+  struct cc_map_node* node = self->nodes;
+  for (size_t n = 0; n < self->capacity; ++n, ++node)
+  {
+    if (node->length > 0)
+    {
+      node->hash = _cc_map_hash(self, node->key);
+    }
+  }
+}
+
+void
+_cc_map_rehash(struct cc_map* self, uint64_t seed)
+{
+  // If the table cannot be rebuilt, the nodes stay where the old hashes put
+  // them, so the old hashes have to come back too.
+  uint64_t old_seed = self->seed;
+  _cc_map_set_hashes(self, seed);
+  if (!_cc_map_resize(self, self->capacity))
+  {
+    _cc_map_set_hashes(self, old_seed);
+  }
+}
+
+void
+_cc_map_limit_probe_length(struct cc_map* self)
+{
+  if (self->max_length > self->probe_limit)
+  {
+    // Long probe sequences at a bounded load factor point to keys chosen to
+    // collide under the current seed.  Pick a new seed and rebuild the table;
+    // if that does not help, the keys collide under every seed, so stop
+    // trying until the clusters grow further.
+    _cc_map_rehash(self, cc_hash_mix(cc_hash_seed(), self->seed + 1));
+    if (self->max_length > self->probe_limit)
+    {
+      uint64_t limit = 2 * (uint64_t) self->max_length;
+      self->probe_limit = limit < UINT32_MAX ? limit : UINT32_MAX;
+    }
   }
 }
 
@@ -173,12 +364,17 @@ cc_map_hasher(const void* buffer, size_t size)
   cc_hash_fn value_hasher = self->value_functions.hasher;
   const struct cc_map_node* node = self->nodes;
 
+  // Slot order depends on the seed, so combine entries order-independently.
   for (size_t n = 0; n < self->capacity; ++n, ++node)
   {
     if (node->length > 0)
     {
-      cc_hash_combine(&hash, key_hasher(node->key, key_size));
-      cc_hash_combine(&hash, value_hasher(node->value, value_size));
+      uint64_t entry = key_hasher(node->key, key_size);
+      if (value_size > 0)
+      {
+        cc_hash_combine(&entry, value_hasher(node->value, value_size));
+      }
+      hash += entry;
     }
   }
 
@@ -198,19 +394,26 @@ cc_map_copier(void* dest, const void* src, size_t size)
     self->key_size = other->key_size;
     self->value_size = other->value_size;
     self->max_length = other->max_length;
+    self->probe_limit = other->probe_limit;
+    self->seed = other->seed;
     self->max_load_factor = other->max_load_factor;
     self->key_functions = other->key_functions;
     self->value_functions = other->value_functions;
     self->nodes = NULL;
+    self->bloom = NULL;
 
     _cc_map_resize(self, other->capacity);
+    if (other->bloom)
+    {
+      cc_map_attach_bloom(self, other->bloom->false_positive_rate);
+    }
 
     const struct cc_map_node* node = other->nodes;
     for (size_t n = 0; n < other->capacity; ++n, ++node)
     {
       if (node->length > 0)
       {
-        cc_map_insert(self, node->key, node->value);
+        _cc_map_place(self, node->key, node->value, node->hash);
       }
     }
 
@@ -235,19 +438,28 @@ cc_map_deleter(void* ptr)
      _cc_map_node_free(self, node);
    }
 
-   free(self->nodes->value);
-   free(self->nodes->key);
-   free(self->nodes);
+   // A zero-filled map (for instance an unused slot in a container of maps)
+   // has no table to free.
+   if (self->nodes)
+   {
+     cc_large_free(self->nodes->value);
+     cc_large_free(self->nodes->key);
+     cc_large_free(self->nodes);
+   }
+   cc_bloom_delete(self->bloom);
 
    self->size = 0;
    self->capacity = 0;
    self->key_size = 0;
    self->value_size = 0;
    self->max_length = 0;
+   self->probe_limit = 0;
+   self->seed = 0;
    self->max_load_factor = 0.0;
    self->key_functions = cc_default_functions;
    self->value_functions = cc_default_functions;
    self->nodes = NULL;
+   self->bloom = NULL;
  }
 }
 
@@ -278,9 +490,10 @@ cc_map_equality(const void* left, const void* right, size_t size)
       if (a->length > 0)
       {
         b = _cc_map_get(other, a->key);
-        if (a->hash != b->hash
+        if (!b
             || !key_equality(a->key, b->key, key_size)
-            || !value_equality(a->value, b->value, value_size))
+            || (value_size > 0
+                && !value_equality(a->value, b->value, value_size)))
         {
           return false;
         }
@@ -342,11 +555,14 @@ cc_map_new_f(size_t key_size,
   self->key_size = key_size;
   self->value_size = value_size;
   self->max_length = 0;
+  self->probe_limit = _cc_map_default_probe_limit;
+  self->seed = cc_hash_seed();
   self->max_load_factor = 0.8;
   self->key_functions = key_functions;
   self->value_functions = value_functions;
 
   self->nodes = NULL;
+  self->bloom = NULL;
 
   _cc_map_resize(self, _cc_map_capacity(self, 0));
 
@@ -480,59 +696,57 @@ cc_map_clear(struct cc_map* self)
       _cc_map_node_free(self, node);
     }
     self->size = 0;
+    cc_bloom_clear(self->bloom);
   }
 }
 
 void
 cc_map_insert(struct cc_map* self, const void* key, const void* value)
 {
-  if (self && key && value)
+  if (self && key && (value || self->value_size == 0))
   {
-    struct cc_map_node* current = self->nodes + self->capacity;
-    struct cc_map_node* swap = current + 1;
-
-    _cc_map_node_init(self, current, key, value);
-
-    size_t pos = ((size_t) current->hash) % self->capacity;
-    struct cc_map_node* existing = self->nodes + pos;
-    cc_copy_fn copier = self->value_functions.copier;
-
-    while (true)
+    if (_cc_map_place(self, key, value, _cc_map_hash(self, key)))
     {
-      if (existing->length == 0)
+      double load_factor = (double) self->size / (double) self->capacity;
+      if (load_factor > self->max_load_factor)
       {
-        _cc_map_node_copy(self, existing, current);
-        if (current->length > self->max_length)
-        {
-          self->max_length = current->length;
-        }
-
-        ++self->size;
-
-        double load_factor = (double) self->size / (double) self->capacity;
-        if (load_factor > self->max_load_factor)
-        {
-          _cc_map_resize(self, _cc_map_capacity(self, self->size));
-        }
-
-        break;
-      }
-      if (current->hash == existing->hash)
-      {
-        copier(existing->value, current->value, self->value_size);
-        break;
-      }
-      if (current->length > existing->length)
-      {
-        _cc_map_node_copy(self, swap, existing);
-        _cc_map_node_copy(self, existing, current);
-        _cc_map_node_copy(self, current, swap);
+        _cc_map_resize(self, _cc_map_capacity(self, self->size));
       }
+      _cc_map_limit_probe_length(self);
+    }
+  }
+}
 
-      ++current->length;
-      pos = (pos + 1) % self->capacity;
-      existing = self->nodes + pos;
+void*
+cc_map_emplace(struct cc_map* self, const void* key)
+{
+  if (self && key)
+  {
+    // Make room first: resizing once the value has been handed out would
+    // move it before the caller has initialized it.
+    double load_factor = (double) (self->size + 1) / (double) self->capacity;
+    if (load_factor > self->max_load_factor)
+    {
+      _cc_map_resize(self, _cc_map_capacity(self, self->size + 1));
     }
+    _cc_map_limit_probe_length(self);
+
+    bool inserted;
+    uint64_t hash = _cc_map_hash(self, key);
+    struct cc_map_node* node = _cc_map_claim(self, key, hash, &inserted);
+    if (inserted)
+    {
+      self->key_functions.copier(node->key, key, self->key_size);
+    }
+    else if (self->value_size > 0)
+    {
+      self->value_functions.deleter(node->value);
+    }
+    return node->value;
+  }
+  else
+  {
+    return NULL;
   }
 }
 
@@ -542,6 +756,10 @@ cc_map_erase(struct cc_map* self, const void* key)
   if (self && key)
   {
     struct cc_map_node* node = _cc_map_get(self, key);
+    if (!node)
+    {
+      return;
+    }
     _cc_map_node_free(self, node);
 
     size_t pos = (node - self->nodes + 1) % self->capacity;
@@ -549,8 +767,7 @@ cc_map_erase(struct cc_map* self, const void* key)
     while (next->length > 1)
     {
       next->length -= 1;
-      _cc_map_node_copy(self, node, next);
-      _cc_map_node_free(self, next);
+      _cc_map_node_move(self, node, next);
 
       node = next;
       pos = (pos + 1) % self->capacity;
@@ -570,31 +787,40 @@ cc_map_swap(struct cc_map* self, struct cc_map* other)
     size_t capacity = self->capacity;
     size_t key_size = self->key_size;
     size_t value_size = self->value_size;
-    uint16_t max_length = self->max_length;
+    uint32_t max_length = self->max_length;
+    uint32_t probe_limit = self->probe_limit;
+    uint64_t seed = self->seed;
     double max_load_factor = self->max_load_factor;
     struct cc_functions key_functions = self->key_functions;
     struct cc_functions value_functions = self->value_functions;
     struct cc_map_node* nodes = self->nodes;
+    struct cc_bloom* bloom = self->bloom;
 
     self->size = other->size;
     self->capacity = other->capacity;
     self->key_size = other->key_size;
     self->value_size = other->value_size;
     self->max_length = other->max_length;
+    self->probe_limit = other->probe_limit;
+    self->seed = other->seed;
     self->max_load_factor = other->max_load_factor;
     self->key_functions = other->key_functions;
     self->value_functions = other->value_functions;
     self->nodes = other->nodes;
+    self->bloom = other->bloom;
 
     other->size = size;
     other->capacity = capacity;
     other->key_size = key_size;
     other->value_size = value_size;
     other->max_length = max_length;
+    other->probe_limit = probe_limit;
+    other->seed = seed;
     other->max_load_factor = max_load_factor;
     other->key_functions = key_functions;
     other->value_functions = value_functions;
     other->nodes = nodes;
+    other->bloom = bloom;
   }
 }
 
@@ -603,17 +829,21 @@ cc_map_merge(struct cc_map* self, struct cc_map* other)
 {
   if (self && other)
   {
+    size_t n = 0;
     struct cc_map_node* node = other->nodes;
-    for (size_t n = 0; n < other->capacity; ++n, ++node)
+    while (n < other->capacity)
     {
-      if (node->length > 0)
+      if (node->length > 0 && !_cc_map_get(self, node->key))
       {
-        if (!_cc_map_get(self, node->key))
-        {
-          cc_map_insert(self, node->key, node->value);
-          cc_map_erase(other, node->key);
-        }
+        cc_map_insert(self, node->key, node->value);
+        cc_map_erase(other, node->key);
+
+        // Erasing shifts the following entries back by one slot, so look at
+        // this slot again.
+        continue;
       }
+      ++n;
+      ++node;
     }
   }
 }
@@ -636,7 +866,14 @@ cc_map_find(const struct cc_map* self, const void* key)
 bool
 cc_map_contains(const struct cc_map* self, const void* key)
 {
-  return cc_map_find(self, key);
+  if (self && key)
+  {
+    return _cc_map_get(self, key) != NULL;
+  }
+  else
+  {
+    return false;
+  }
 }
 
 double
@@ -683,6 +920,72 @@ cc_map_reserve(struct cc_map* self, size_t count)
   }
 }
 
+uint64_t
+cc_map_seed(const struct cc_map* self)
+{
+  if (self)
+  {
+    return self->seed;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_map_set_seed(struct cc_map* self, uint64_t seed)
+{
+  if (self)
+  {
+    self->probe_limit = _cc_map_default_probe_limit;
+    _cc_map_rehash(self, seed);
+  }
+}
+
+bool
+cc_map_attach_bloom(struct cc_map* self, double false_positive_rate)
+{
+  if (self)
+  {
+    struct cc_bloom* bloom = cc_bloom_new(
+        _cc_map_bloom_count(self),
+        false_positive_rate
+      );
+    if (!bloom)
+    {
+      return false;
+    }
+
+    const struct cc_map_node* node = self->nodes;
+    for (size_t n = 0; n < self->capacity; ++n, ++node)
+    {
+      if (node->length > 0)
+      {
+        cc_bloom_add_hash(bloom, node->hash);
+      }
+    }
+
+    cc_bloom_delete(self->bloom);
+    self->bloom = bloom;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+void
+cc_map_detach_bloom(struct cc_map* self)
+{
+  if (self)
+  {
+    cc_bloom_delete(self->bloom);
+    self->bloom = NULL;
+  }
+}
+
 bool
 cc_map_eq(const struct cc_map* self, const struct cc_map* other)
 {
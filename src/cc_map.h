@@ -11,6 +11,7 @@
 #ifndef CC_MAP_H
 #define CC_MAP_H
 
+#include "cc_bloom.h"
 #include "cc_memory.h"
 
 #if defined (__cplusplus)
@@ -22,7 +23,7 @@ struct cc_map_node
   void* key;
   void* value;
   uint64_t hash;
-  uint16_t length;
+  uint32_t length;
 };
 
 struct cc_map
@@ -31,11 +32,14 @@ struct cc_map
   size_t capacity;
   size_t key_size;
   size_t value_size;
-  uint16_t max_length;
+  uint32_t max_length;
+  uint32_t probe_limit;
+  uint64_t seed;
   double max_load_factor;
   struct cc_functions key_functions;
   struct cc_functions value_functions;
   struct cc_map_node* nodes;
+  struct cc_bloom* bloom;
 };
 
 struct cc_map_iterator
@@ -56,7 +60,7 @@ typedef struct cc_map_iterator cc_map_iterator_t;
 
 typedef struct cc_map_key_value cc_map_key_value_t;
 
-extern const size_t cc_vector_sizeof;
+extern const size_t cc_map_sizeof;
 
 extern const struct cc_functions cc_map_functions;
 
@@ -124,6 +128,12 @@ cc_map_clear(struct cc_map* self);
 void
 cc_map_insert(struct cc_map* self, const void* key, const void* value);
 
+// Stores a copy of the key and returns the uninitialized storage for its
+// value, which the caller must initialize.  A value already stored under the
+// key is deleted first.
+void*
+cc_map_emplace(struct cc_map* self, const void* key);
+
 void
 cc_map_erase(struct cc_map* self, const void* key);
 
@@ -151,6 +161,18 @@ cc_map_set_max_load_factor(struct cc_map* self, double factor);
 void
 cc_map_reserve(struct cc_map* self, size_t count);
 
+uint64_t
+cc_map_seed(const struct cc_map* self);
+
+void
+cc_map_set_seed(struct cc_map* self, uint64_t seed);
+
+bool
+cc_map_attach_bloom(struct cc_map* self, double false_positive_rate);
+
+void
+cc_map_detach_bloom(struct cc_map* self);
+
 bool
 cc_map_eq(const struct cc_map* self, const struct cc_map* other);
 
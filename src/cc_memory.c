@@ -8,24 +8,82 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "cc_memory.h"
 #include "xxhash/xxhash.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CC_HAVE_MMAP 1
+#endif
+
 const struct cc_functions cc_default_functions = (struct cc_functions){
   .hasher = cc_default_hasher,
   .copier = cc_default_copier,
   .deleter = cc_default_deleter,
-  .equality = cc_default_equality
+  .equality = cc_default_equality,
+  .seeded_hasher = cc_default_seeded_hasher,
+  .relocator = cc_default_relocator
+};
+
+const size_t cc_huge_page_size = 2 * 1024 * 1024;
+
+// Large blocks are preceded by a header that records how they were obtained,
+// so that cc_large_free() does not need to be told the size.
+struct _cc_large_header
+{
+  _Alignas(64) size_t length;
+  bool mapped;
 };
 
+atomic_bool _cc_random_seeding = true;
+
+atomic_uint_fast64_t _cc_seed_state = 0;
+
+uint64_t
+_cc_seed_entropy()
+{
+  uint64_t entropy = 0;
+
+  FILE* random = fopen("/dev/urandom", "rb");
+  if (random)
+  {
+    if (fread(&entropy, sizeof(entropy), 1, random) != 1)
+    {
+      entropy = 0;
+    }
+    fclose(random);
+  }
+
+  if (entropy == 0)
+  {
+    // No entropy device; fall back to values that differ between runs.
+    entropy = (uint64_t) time(NULL);
+    cc_hash_combine(&entropy, (uint64_t) clock());
+    cc_hash_combine(&entropy, (uint64_t) (uintptr_t) &entropy);
+  }
+
+  return entropy | 1;
+}
+
 uint64_t
 cc_default_hasher(const void* buffer, size_t size)
 {
   return (uint64_t) XXH64(buffer, size, 0);
 }
 
+uint64_t
+cc_default_seeded_hasher(const void* buffer, size_t size, uint64_t seed)
+{
+  return (uint64_t) XXH64(buffer, size, seed);
+}
+
 void*
 cc_default_copier(void* dest, const void* src, size_t size)
 {
@@ -38,15 +96,308 @@ cc_default_deleter(void* ptr)
   // empty
 }
 
+void*
+cc_default_relocator(void* dest, void* src, size_t size)
+{
+  return memcpy(dest, src, size);
+}
+
+void*
+cc_relocate(const struct cc_functions* functions,
+            void* dest,
+            void* src,
+            size_t size)
+{
+  // Move an element into uninitialized storage, leaving the source dead.
+  // Types without a relocator are moved by copying and deleting the source.
+  if (functions->relocator)
+  {
+    return functions->relocator(dest, src, size);
+  }
+  else
+  {
+    void* result = functions->copier(dest, src, size);
+    functions->deleter(src);
+    return result;
+  }
+}
+
+void
+cc_relocate_range(const struct cc_functions* functions,
+                  void* dest,
+                  void* src,
+                  size_t count,
+                  size_t size)
+{
+  // Elements are moved starting from the end nearest the destination.
+  if (count == 0)
+  {
+    return;
+  }
+  else if (functions->relocator == cc_default_relocator)
+  {
+    memmove(dest, src, count * size);
+  }
+  else if (dest < src)
+  {
+    for (size_t n = 0; n < count; ++n)
+    {
+      cc_relocate(functions, dest + n * size, src + n * size, size);
+    }
+  }
+  else if (dest > src)
+  {
+    for (size_t n = count; n > 0; --n)
+    {
+      cc_relocate(
+          functions,
+          dest + (n - 1) * size,
+          src + (n - 1) * size,
+          size
+        );
+    }
+  }
+}
+
 bool
 cc_default_equality(const void* left, const void* right, size_t size)
 {
   return memcmp(left, right, size) == 0;
 }
 
+int
+cc_default_comparator(const void* left, const void* right, size_t size)
+{
+  // Orders bytes lexicographically, which suits character arrays and
+  // big-endian keys; numeric keys need one of the typed comparators.
+  return memcmp(left, right, size);
+}
+
+int
+cc_int_comparator(const void* left, const void* right, size_t size)
+{
+  int a = *(const int*) left;
+  int b = *(const int*) right;
+  return (a > b) - (a < b);
+}
+
+int
+cc_int64_comparator(const void* left, const void* right, size_t size)
+{
+  int64_t a = *(const int64_t*) left;
+  int64_t b = *(const int64_t*) right;
+  return (a > b) - (a < b);
+}
+
+int
+cc_uint32_comparator(const void* left, const void* right, size_t size)
+{
+  uint32_t a = *(const uint32_t*) left;
+  uint32_t b = *(const uint32_t*) right;
+  return (a > b) - (a < b);
+}
+
+int
+cc_uint64_comparator(const void* left, const void* right, size_t size)
+{
+  uint64_t a = *(const uint64_t*) left;
+  uint64_t b = *(const uint64_t*) right;
+  return (a > b) - (a < b);
+}
+
+int
+cc_double_comparator(const void* left, const void* right, size_t size)
+{
+  double a = *(const double*) left;
+  double b = *(const double*) right;
+  return (a > b) - (a < b);
+}
+
 void
 cc_hash_combine(uint64_t* seed, uint64_t value)
 {
   // C++ Boost hash combine function
   *seed ^= value + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
 }
+
+void*
+cc_large_alloc(size_t size)
+{
+  size_t header = sizeof(struct _cc_large_header);
+  if (size > SIZE_MAX - header - cc_huge_page_size)
+  {
+    return NULL;
+  }
+
+  size_t length = size + header;
+  struct _cc_large_header* block = NULL;
+
+#if defined(CC_HAVE_MMAP)
+  if (length >= cc_huge_page_size)
+  {
+    // Prefer explicitly reserved huge pages, then transparent huge pages.
+    void* p = MAP_FAILED;
+    length = (length + cc_huge_page_size - 1) & ~(cc_huge_page_size - 1);
+#if defined(MAP_HUGETLB)
+    p = mmap(
+        NULL,
+        length,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+        -1,
+        0
+      );
+#endif
+    if (p == MAP_FAILED)
+    {
+      p = mmap(
+          NULL,
+          length,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS,
+          -1,
+          0
+        );
+      if (p != MAP_FAILED)
+      {
+        cc_advise_huge_pages(p, length);
+      }
+    }
+    if (p != MAP_FAILED)
+    {
+      block = (struct _cc_large_header*) p;
+      block->length = length;
+      block->mapped = true;
+      return block + 1;
+    }
+    length = size + header;
+  }
+#endif
+
+  length = (length + header - 1) & ~(header - 1);
+  block = (struct _cc_large_header*) aligned_alloc(header, length);
+  if (!block)
+  {
+    return NULL;
+  }
+  memset(block, 0, length);
+  block->length = length;
+  block->mapped = false;
+  return block + 1;
+}
+
+void
+cc_large_free(void* ptr)
+{
+  if (ptr)
+  {
+    struct _cc_large_header* block = (struct _cc_large_header*) ptr - 1;
+#if defined(CC_HAVE_MMAP)
+    if (block->mapped)
+    {
+      munmap(block, block->length);
+      return;
+    }
+#endif
+    free(block);
+  }
+}
+
+void
+cc_advise_huge_pages(void* ptr, size_t size)
+{
+#if defined(CC_HAVE_MMAP) && defined(MADV_HUGEPAGE)
+  if (ptr && size >= cc_huge_page_size)
+  {
+    // madvise() needs page-aligned ranges; only whole pages are advised.
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    uintptr_t first = ((uintptr_t) ptr + page - 1) & ~(uintptr_t) (page - 1);
+    uintptr_t last = ((uintptr_t) ptr + size) & ~(uintptr_t) (page - 1);
+    if (last > first)
+    {
+      madvise((void*) first, last - first, MADV_HUGEPAGE);
+    }
+  }
+#endif
+}
+
+uint64_t
+cc_hash_mix(uint64_t hash, uint64_t seed)
+{
+  // SplitMix64 finalizer; a bijection, so distinct hashes stay distinct.
+  uint64_t z = hash ^ seed;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+double
+cc_log(double x)
+{
+  // Reduce to [1, 2) and sum the series for 2 atanh((x - 1) / (x + 1)).
+  double exponent = 0.0;
+  while (x >= 2.0)
+  {
+    x /= 2.0;
+    exponent += 1.0;
+  }
+  while (x < 1.0)
+  {
+    x *= 2.0;
+    exponent -= 1.0;
+  }
+
+  double z = (x - 1.0) / (x + 1.0);
+  double z2 = z * z;
+  double term = z;
+  double sum = 0.0;
+  for (int n = 1; n < 40; n += 2, term *= z2)
+  {
+    sum += term / n;
+  }
+  return 2.0 * sum + exponent * 0.6931471805599453;
+}
+
+uint64_t
+cc_hash_seeded(const struct cc_functions* functions,
+               const void* buffer,
+               size_t size,
+               uint64_t seed)
+{
+  // A replaced hasher has to agree with a replaced equality, so it wins over
+  // the seeded hasher that was copied along with the defaults.
+  if (functions->seeded_hasher
+      && (!functions->hasher || functions->hasher == cc_default_hasher))
+  {
+    return functions->seeded_hasher(buffer, size, seed);
+  }
+  else
+  {
+    return cc_hash_mix(functions->hasher(buffer, size), seed);
+  }
+}
+
+uint64_t
+cc_hash_seed()
+{
+  if (!atomic_load(&_cc_random_seeding))
+  {
+    return 0;
+  }
+
+  uint_fast64_t state = atomic_load(&_cc_seed_state);
+  if (state == 0)
+  {
+    uint_fast64_t expected = 0;
+    atomic_compare_exchange_strong(&_cc_seed_state, &expected, _cc_seed_entropy());
+  }
+
+  state = atomic_fetch_add(&_cc_seed_state, 0x9e3779b97f4a7c15);
+  return cc_hash_mix(state, 0);
+}
+
+void
+cc_hash_set_random_seeding(bool enabled)
+{
+  atomic_store(&_cc_random_seeding, enabled);
+}
@@ -21,37 +21,120 @@ extern "C" {
 
 typedef uint64_t (*cc_hash_fn)(const void* buffer, size_t size);
 
+typedef uint64_t (*cc_seeded_hash_fn)(const void* buffer,
+                                      size_t size,
+                                      uint64_t seed);
+
 typedef void* (*cc_copy_fn)(void* dest, const void* src, size_t size);
 
 typedef void (*cc_delete_fn)(void* ptr);
 
+typedef void* (*cc_relocate_fn)(void* dest, void* src, size_t size);
+
 typedef bool (*cc_equal_fn)(const void* left, const void* right, size_t size);
 
+typedef int (*cc_compare_fn)(const void* left, const void* right, size_t size);
+
 struct cc_functions
 {
   cc_hash_fn hasher;
   cc_copy_fn copier;
   cc_delete_fn deleter;
   cc_equal_fn equality;
+  cc_seeded_hash_fn seeded_hasher;
+  cc_relocate_fn relocator;
 };
 
 extern const struct cc_functions cc_default_functions;
 
+extern const size_t cc_huge_page_size;
+
 uint64_t
 cc_default_hasher(const void* buffer, size_t size);
 
+uint64_t
+cc_default_seeded_hasher(const void* buffer, size_t size, uint64_t seed);
+
 void*
 cc_default_copier(void* dest, const void* src, size_t size);
 
 void
 cc_default_deleter(void* ptr);
 
+void*
+cc_default_relocator(void* dest, void* src, size_t size);
+
+void*
+cc_relocate(const struct cc_functions* functions,
+            void* dest,
+            void* src,
+            size_t size);
+
+// Relocates count elements, which may overlap like the ranges of memmove().
+void
+cc_relocate_range(const struct cc_functions* functions,
+                  void* dest,
+                  void* src,
+                  size_t count,
+                  size_t size);
+
 bool
 cc_default_equality(const void* left, const void* right, size_t size);
 
+int
+cc_default_comparator(const void* left, const void* right, size_t size);
+
+int
+cc_int_comparator(const void* left, const void* right, size_t size);
+
+int
+cc_int64_comparator(const void* left, const void* right, size_t size);
+
+int
+cc_uint32_comparator(const void* left, const void* right, size_t size);
+
+int
+cc_uint64_comparator(const void* left, const void* right, size_t size);
+
+int
+cc_double_comparator(const void* left, const void* right, size_t size);
+
 void
 cc_hash_combine(uint64_t* seed, uint64_t value);
 
+void*
+cc_large_alloc(size_t size);
+
+void
+cc_large_free(void* ptr);
+
+void
+cc_advise_huge_pages(void* ptr, size_t size);
+
+uint64_t
+cc_hash_mix(uint64_t hash, uint64_t seed);
+
+// The natural logarithm of a positive x, to near double precision, for the
+// sketches to size themselves without linking the math library.
+double
+cc_log(double x);
+
+// Hashes with the seeded hasher when there is one and the hasher is NULL or
+// still cc_default_hasher; otherwise mixes the seed into the hasher's result.
+// Copying cc_default_functions and replacing only the hasher therefore keeps
+// the hash consistent with the replacement.
+uint64_t
+cc_hash_seeded(const struct cc_functions* functions,
+               const void* buffer,
+               size_t size,
+               uint64_t seed);
+
+uint64_t
+cc_hash_seed();
+
+void
+cc_hash_set_random_seeding(bool enabled);
+
 #if defined(__cplusplus)
 }
 #endif
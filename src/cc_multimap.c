@@ -0,0 +1,493 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_multimap.h"
+
+void
+_cc_multimap_drop_pending_keys(struct cc_multimap* self)
+{
+  cc_delete_fn deleter = self->key_functions.deleter;
+  size_t size = cc_vector_size(self->pending_keys);
+  for (size_t n = 0; n < size; ++n)
+  {
+    deleter(self->pending_keys->data + n * self->key_size);
+  }
+  cc_vector_clear(self->pending_keys);
+}
+
+void
+_cc_multimap_drop_values(struct cc_multimap* self)
+{
+  cc_delete_fn deleter = self->value_functions.deleter;
+  for (size_t n = 0; n < self->value_count; ++n)
+  {
+    deleter(self->values + n * self->value_size);
+  }
+  free(self->values);
+  self->values = NULL;
+  self->value_count = 0;
+}
+
+struct cc_multimap*
+cc_multimap_new(size_t key_size, size_t value_size)
+{
+  return cc_multimap_new_f(
+      key_size,
+      value_size,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_multimap*
+cc_multimap_new_f(size_t key_size,
+                  size_t value_size,
+                  const struct cc_functions key_functions,
+                  const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_multimap));
+  struct cc_multimap* self = (struct cc_multimap*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->value_count = 0;
+  self->group_count = 0;
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->offsets = (size_t*) calloc(1, sizeof(size_t));
+  self->values = NULL;
+
+  self->groups = cc_map_new_f(
+      key_size,
+      sizeof(size_t),
+      key_functions,
+      cc_default_functions
+    );
+  self->pending_keys = cc_vector_new_f(key_size, key_functions);
+  self->pending_values = cc_vector_new_f(value_size, value_functions);
+  if (!self->offsets || !self->groups || !self->pending_keys
+      || !self->pending_values)
+  {
+    cc_vector_delete(self->pending_values);
+    cc_vector_delete(self->pending_keys);
+    cc_map_delete(self->groups);
+    free(self->offsets);
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_multimap*
+cc_multimap_copy(const struct cc_multimap* other)
+{
+  struct cc_multimap* self = cc_multimap_new_f(
+      other->key_size,
+      other->value_size,
+      other->key_functions,
+      other->value_functions
+    );
+  if (!self)
+  {
+    return NULL;
+  }
+
+  size_t* offsets = (size_t*) malloc((other->group_count + 1) * sizeof(size_t));
+  void* values = malloc(other->value_count * other->value_size + 1);
+  if (!offsets || !values)
+  {
+    free(offsets);
+    free(values);
+    cc_multimap_delete(self);
+    return NULL;
+  }
+  memcpy(offsets, other->offsets, (other->group_count + 1) * sizeof(size_t));
+  free(self->offsets);
+  self->offsets = offsets;
+  self->values = values;
+
+  cc_copy_fn copier = other->value_functions.copier;
+  for (size_t n = 0; n < other->value_count; ++n)
+  {
+    size_t offset = n * other->value_size;
+    copier(self->values + offset, other->values + offset, other->value_size);
+  }
+  self->value_count = other->value_count;
+  self->group_count = other->group_count;
+
+  cc_map_deleter(self->groups);
+  cc_map_copier(self->groups, other->groups, sizeof(struct cc_map));
+  cc_vector_deleter(self->pending_keys);
+  cc_vector_copier(self->pending_keys, other->pending_keys, 0);
+  cc_vector_deleter(self->pending_values);
+  cc_vector_copier(self->pending_values, other->pending_values, 0);
+
+  return self;
+}
+
+void
+cc_multimap_delete(struct cc_multimap* self)
+{
+  if (self)
+  {
+    _cc_multimap_drop_values(self);
+    cc_map_delete(self->groups);
+    cc_vector_delete(self->pending_keys);
+    cc_vector_delete(self->pending_values);
+    free(self->offsets);
+    free(self);
+  }
+}
+
+bool
+cc_multimap_empty(const struct cc_multimap* self)
+{
+  return cc_multimap_size(self) == 0;
+}
+
+size_t
+cc_multimap_size(const struct cc_multimap* self)
+{
+  if (self)
+  {
+    return self->value_count + cc_vector_size(self->pending_values);
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_multimap_key_count(struct cc_multimap* self)
+{
+  if (self)
+  {
+    cc_multimap_freeze(self);
+    return cc_map_size(self->groups);
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+bool
+cc_multimap_frozen(const struct cc_multimap* self)
+{
+  if (self)
+  {
+    return cc_vector_empty(self->pending_values);
+  }
+  else
+  {
+    return true;
+  }
+}
+
+void
+cc_multimap_clear(struct cc_multimap* self)
+{
+  if (self)
+  {
+    _cc_multimap_drop_values(self);
+    _cc_multimap_drop_pending_keys(self);
+    cc_delete_fn deleter = self->value_functions.deleter;
+    size_t size = cc_vector_size(self->pending_values);
+    for (size_t n = 0; n < size; ++n)
+    {
+      deleter(self->pending_values->data + n * self->value_size);
+    }
+    cc_vector_clear(self->pending_values);
+    cc_map_clear(self->groups);
+    self->group_count = 0;
+    self->offsets[0] = 0;
+  }
+}
+
+void
+cc_multimap_reserve(struct cc_multimap* self, size_t count)
+{
+  if (self)
+  {
+    cc_vector_reserve(self->pending_keys, count);
+    cc_vector_reserve(self->pending_values, count);
+  }
+}
+
+void
+cc_multimap_insert(struct cc_multimap* self,
+                   const void* key,
+                   const void* value)
+{
+  if (self && key && value)
+  {
+    cc_vector_push_back(self->pending_keys, key);
+    cc_vector_push_back(self->pending_values, value);
+  }
+}
+
+void
+cc_multimap_erase(struct cc_multimap* self, const void* key)
+{
+  if (self && key)
+  {
+    cc_multimap_freeze(self);
+    size_t* group = (size_t*) cc_map_find(self->groups, key);
+    if (!group)
+    {
+      return;
+    }
+
+    // The group keeps its slot in the offsets array as an empty range, so
+    // the indices held by the other keys stay valid until the next freeze
+    // compacts them.
+    size_t first = self->offsets[*group];
+    size_t last = self->offsets[*group + 1];
+    size_t value_size = self->value_size;
+    for (size_t n = first; n < last; ++n)
+    {
+      self->value_functions.deleter(self->values + n * value_size);
+    }
+    cc_relocate_range(
+        &self->value_functions,
+        self->values + first * value_size,
+        self->values + last * value_size,
+        self->value_count - last,
+        value_size
+      );
+    for (size_t g = *group + 1; g <= self->group_count; ++g)
+    {
+      self->offsets[g] -= last - first;
+    }
+    self->value_count -= last - first;
+    cc_map_erase(self->groups, key);
+  }
+}
+
+void
+_cc_multimap_forget_new_keys(struct cc_multimap* self,
+                             const size_t* assigned,
+                             size_t count,
+                             size_t kept)
+{
+  for (size_t n = 0; n < count; ++n)
+  {
+    if (assigned[n] >= kept)
+    {
+      cc_map_erase(self->groups, cc_vector_get(self->pending_keys, n));
+    }
+  }
+}
+
+void
+cc_multimap_freeze(struct cc_multimap* self)
+{
+  if (!self)
+  {
+    return;
+  }
+  size_t pending = cc_vector_size(self->pending_values);
+  size_t old_count = self->group_count;
+  if (pending == 0 && cc_map_size(self->groups) == old_count)
+  {
+    return;
+  }
+
+  // Everything is allocated before the groups are touched, so a failure
+  // leaves the map exactly as it was.
+  size_t value_count = self->value_count + pending;
+  size_t value_size = self->value_size;
+  size_t limit = cc_map_size(self->groups) + pending;
+  size_t* assigned = (size_t*) malloc(pending * sizeof(size_t) + 1);
+  size_t* renumber = (size_t*) malloc(
+      (old_count + pending) * sizeof(size_t) + 1
+    );
+  size_t* counts = (size_t*) calloc(limit + 1, sizeof(size_t));
+  size_t* offsets = (size_t*) malloc((limit + 1) * sizeof(size_t));
+  void* values = malloc(value_count * value_size + 1);
+  if (!assigned || !renumber || !counts || !offsets || !values)
+  {
+    free(assigned);
+    free(renumber);
+    free(counts);
+    free(offsets);
+    free(values);
+    return;
+  }
+
+  // Erased keys leave empty groups behind, so the surviving groups are
+  // numbered again from zero.
+  size_t group_count = 0;
+  for (size_t g = 0; g < old_count; ++g)
+  {
+    size_t size = self->offsets[g + 1] - self->offsets[g];
+    if (size > 0)
+    {
+      counts[group_count] = size;
+      renumber[g] = group_count++;
+    }
+  }
+
+  // New keys are stored under indices past the old ones until every key is
+  // in, so that a failed insertion can be undone.
+  size_t kept = group_count;
+  size_t next = old_count;
+  for (size_t n = 0; n < pending; ++n)
+  {
+    const void* key = cc_vector_get(self->pending_keys, n);
+    size_t* group = (size_t*) cc_map_find(self->groups, key);
+    if (!group)
+    {
+      group = (size_t*) cc_map_emplace(self->groups, key);
+      if (!group)
+      {
+        _cc_multimap_forget_new_keys(self, assigned, n, kept);
+        free(assigned);
+        free(renumber);
+        free(counts);
+        free(offsets);
+        free(values);
+        return;
+      }
+      *group = next;
+      renumber[next++] = group_count++;
+    }
+    assigned[n] = renumber[*group];
+    counts[assigned[n]] += 1;
+  }
+
+  cc_map_iterator_t p = cc_map_begin(self->groups);
+  cc_map_iterator_t e = cc_map_end(self->groups);
+  for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+  {
+    size_t* group = (size_t*) cc_map_iterator_dereference(p).value;
+    *group = renumber[*group];
+  }
+
+  // Prefix sums give the offsets; counts is reused as each group's cursor.
+  offsets[0] = 0;
+  for (size_t g = 0; g < group_count; ++g)
+  {
+    offsets[g + 1] = offsets[g] + counts[g];
+    counts[g] = offsets[g];
+  }
+
+  // Frozen values are relocated first so that every group keeps its
+  // insertion order.
+  for (size_t g = 0; g < old_count; ++g)
+  {
+    size_t first = self->offsets[g];
+    size_t size = self->offsets[g + 1] - first;
+    if (size > 0)
+    {
+      cc_relocate_range(
+          &self->value_functions,
+          values + counts[renumber[g]] * value_size,
+          self->values + first * value_size,
+          size,
+          value_size
+        );
+      counts[renumber[g]] += size;
+    }
+  }
+  void* src = self->pending_values->data;
+  for (size_t n = 0; n < pending; ++n)
+  {
+    cc_relocate(
+        &self->value_functions,
+        values + counts[assigned[n]]++ * value_size,
+        src + n * value_size,
+        value_size
+      );
+  }
+  cc_vector_clear(self->pending_values);
+  _cc_multimap_drop_pending_keys(self);
+
+  free(self->values);
+  free(self->offsets);
+  free(assigned);
+  free(renumber);
+  free(counts);
+  self->values = values;
+  self->offsets = offsets;
+  self->value_count = value_count;
+  self->group_count = group_count;
+}
+
+const void*
+cc_multimap_find(struct cc_multimap* self, const void* key, size_t* count)
+{
+  const void* values = NULL;
+  size_t size = 0;
+  if (self && key)
+  {
+    cc_multimap_freeze(self);
+    size_t* group = (size_t*) cc_map_find(self->groups, key);
+    if (group)
+    {
+      size_t first = self->offsets[*group];
+      values = self->values + first * self->value_size;
+      size = self->offsets[*group + 1] - first;
+    }
+  }
+
+  if (count)
+  {
+    *count = size;
+  }
+  return values;
+}
+
+size_t
+cc_multimap_count(struct cc_multimap* self, const void* key)
+{
+  size_t count;
+  cc_multimap_find(self, key, &count);
+  return count;
+}
+
+bool
+cc_multimap_contains(struct cc_multimap* self, const void* key)
+{
+  return cc_multimap_find(self, key, NULL) != NULL;
+}
+
+void
+cc_multimap_for_each(struct cc_multimap* self,
+                     cc_multimap_visit_fn visit,
+                     void* arg)
+{
+  if (self && visit)
+  {
+    cc_multimap_freeze(self);
+    cc_map_iterator_t p = cc_map_begin(self->groups);
+    cc_map_iterator_t e = cc_map_end(self->groups);
+    for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+    {
+      cc_map_key_value_t kv = cc_map_iterator_dereference(p);
+      size_t group = *(size_t*) kv.value;
+      size_t first = self->offsets[group];
+      visit(
+          kv.key,
+          self->values + first * self->value_size,
+          self->offsets[group + 1] - first,
+          arg
+        );
+    }
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_MULTIMAP_H
+#define CC_MULTIMAP_H
+
+#include "cc_map.h"
+#include "cc_vector.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A map from each key to any number of values.  New pairs are appended to a
+// pending list; freezing groups them into a compressed sparse row layout in
+// which every key maps to a range of one shared values array.  Lookups
+// freeze the map first if pairs are pending, and the values of a key are
+// returned as a contiguous array in insertion order.
+struct cc_multimap
+{
+  size_t key_size;
+  size_t value_size;
+  size_t value_count;
+  size_t group_count;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  struct cc_map* groups;
+  size_t* offsets;
+  void* values;
+  struct cc_vector* pending_keys;
+  struct cc_vector* pending_values;
+};
+
+typedef struct cc_multimap* cc_multimap_t;
+
+typedef void (*cc_multimap_visit_fn)(const void* key,
+                                     const void* values,
+                                     size_t count,
+                                     void* arg);
+
+struct cc_multimap*
+cc_multimap_new(size_t key_size, size_t value_size);
+
+struct cc_multimap*
+cc_multimap_new_f(size_t key_size,
+                  size_t value_size,
+                  const struct cc_functions key_functions,
+                  const struct cc_functions value_functions);
+
+struct cc_multimap*
+cc_multimap_copy(const struct cc_multimap* other);
+
+void
+cc_multimap_delete(struct cc_multimap* self);
+
+bool
+cc_multimap_empty(const struct cc_multimap* self);
+
+size_t
+cc_multimap_size(const struct cc_multimap* self);
+
+size_t
+cc_multimap_key_count(struct cc_multimap* self);
+
+bool
+cc_multimap_frozen(const struct cc_multimap* self);
+
+void
+cc_multimap_clear(struct cc_multimap* self);
+
+void
+cc_multimap_reserve(struct cc_multimap* self, size_t count);
+
+void
+cc_multimap_insert(struct cc_multimap* self,
+                   const void* key,
+                   const void* value);
+
+void
+cc_multimap_erase(struct cc_multimap* self, const void* key);
+
+void
+cc_multimap_freeze(struct cc_multimap* self);
+
+const void*
+cc_multimap_find(struct cc_multimap* self, const void* key, size_t* count);
+
+size_t
+cc_multimap_count(struct cc_multimap* self, const void* key);
+
+bool
+cc_multimap_contains(struct cc_multimap* self, const void* key);
+
+void
+cc_multimap_for_each(struct cc_multimap* self,
+                     cc_multimap_visit_fn visit,
+                     void* arg);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_MULTIMAP_H
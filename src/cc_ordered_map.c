@@ -0,0 +1,851 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "cc_ordered_map.h"
+
+const size_t cc_ordered_map_sizeof = sizeof(struct cc_ordered_map);
+
+// Index slots hold zero when empty, all ones after an erase, and otherwise
+// one more than the number of the entry they refer to.
+const size_t _cc_ordered_map_dummy = SIZE_MAX;
+
+const size_t _cc_ordered_map_missing = SIZE_MAX;
+
+const struct cc_functions cc_ordered_map_functions = (struct cc_functions){
+  .hasher = cc_ordered_map_hasher,
+  .copier = cc_ordered_map_copier,
+  .deleter = cc_ordered_map_deleter,
+  .equality = cc_ordered_map_equality,
+  .relocator = cc_default_relocator
+};
+
+uint64_t
+_cc_ordered_map_hash(const struct cc_ordered_map* self, const void* key)
+{
+  return cc_hash_seeded(&self->key_functions, key, self->key_size, self->seed);
+}
+
+void*
+_cc_ordered_map_key(const struct cc_ordered_map* self, size_t entry)
+{
+  return (char*) self->keys + entry * self->key_size;
+}
+
+void*
+_cc_ordered_map_value(const struct cc_ordered_map* self, size_t entry)
+{
+  if (self->value_size > 0)
+  {
+    return (char*) self->values + entry * self->value_size;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+size_t
+_cc_ordered_map_slot(const struct cc_ordered_map* self, size_t slot)
+{
+  switch (self->index_width)
+  {
+    case 1:
+    {
+      uint8_t ix = ((const uint8_t*) self->index)[slot];
+      return ix == UINT8_MAX ? _cc_ordered_map_dummy : ix;
+    }
+    case 2:
+    {
+      uint16_t ix = ((const uint16_t*) self->index)[slot];
+      return ix == UINT16_MAX ? _cc_ordered_map_dummy : ix;
+    }
+    case 4:
+    {
+      uint32_t ix = ((const uint32_t*) self->index)[slot];
+      return ix == UINT32_MAX ? _cc_ordered_map_dummy : ix;
+    }
+    default:
+    {
+      uint64_t ix = ((const uint64_t*) self->index)[slot];
+      return ix == UINT64_MAX ? _cc_ordered_map_dummy : (size_t) ix;
+    }
+  }
+}
+
+void
+_cc_ordered_map_set_slot(struct cc_ordered_map* self, size_t slot, size_t ix)
+{
+  switch (self->index_width)
+  {
+    case 1:
+      ((uint8_t*) self->index)[slot] = (uint8_t) ix;
+      break;
+    case 2:
+      ((uint16_t*) self->index)[slot] = (uint16_t) ix;
+      break;
+    case 4:
+      ((uint32_t*) self->index)[slot] = (uint32_t) ix;
+      break;
+    default:
+      ((uint64_t*) self->index)[slot] = (uint64_t) ix;
+      break;
+  }
+}
+
+size_t
+_cc_ordered_map_width(size_t capacity)
+{
+  // The largest stored value is the capacity itself, and all ones is
+  // reserved for erased slots.
+  if (capacity < UINT8_MAX)
+  {
+    return 1;
+  }
+  else if (capacity < UINT16_MAX)
+  {
+    return 2;
+  }
+  else if (capacity < UINT32_MAX)
+  {
+    return 4;
+  }
+  else
+  {
+    return 8;
+  }
+}
+
+size_t
+_cc_ordered_map_lookup(const struct cc_ordered_map* self,
+                       const void* key,
+                       uint64_t hash,
+                       size_t* slot)
+{
+  size_t mask = self->index_capacity - 1;
+  size_t pos = (size_t) hash & mask;
+  while (true)
+  {
+    size_t ix = _cc_ordered_map_slot(self, pos);
+    if (ix == 0)
+    {
+      *slot = pos;
+      return _cc_ordered_map_missing;
+    }
+    if (ix != _cc_ordered_map_dummy)
+    {
+      size_t entry = ix - 1;
+      if (self->hashes[entry] == hash
+          && self->key_functions.equality(
+              key,
+              _cc_ordered_map_key(self, entry),
+              self->key_size
+            ))
+      {
+        *slot = pos;
+        return entry;
+      }
+    }
+    pos = (pos + 1) & mask;
+  }
+}
+
+void
+_cc_ordered_map_build_index(struct cc_ordered_map* self)
+{
+  size_t mask = self->index_capacity - 1;
+  for (size_t entry = 0; entry < self->count; ++entry)
+  {
+    size_t pos = (size_t) self->hashes[entry] & mask;
+    while (_cc_ordered_map_slot(self, pos) != 0)
+    {
+      pos = (pos + 1) & mask;
+    }
+    _cc_ordered_map_set_slot(self, pos, entry + 1);
+  }
+}
+
+bool
+_cc_ordered_map_resize(struct cc_ordered_map* self, size_t minimum)
+{
+  if (minimum < self->size)
+  {
+    minimum = self->size;
+  }
+
+  // Two thirds of the index slots may be used, so every probe sequence is
+  // guaranteed to reach an empty slot.
+  size_t index_capacity = 8;
+  while ((index_capacity << 1) / 3 < minimum)
+  {
+    if (index_capacity > SIZE_MAX / 4)
+    {
+      return false;
+    }
+    index_capacity <<= 1;
+  }
+  size_t capacity = (index_capacity << 1) / 3;
+  size_t width = _cc_ordered_map_width(capacity);
+
+  void* index = cc_large_alloc(index_capacity * width);
+  uint64_t* hashes = (uint64_t*) cc_large_alloc(capacity * sizeof(uint64_t));
+  bool* live = (bool*) cc_large_alloc(capacity * sizeof(bool));
+  void* keys = cc_large_alloc(capacity * self->key_size);
+  void* values = NULL;
+  if (self->value_size > 0)
+  {
+    values = cc_large_alloc(capacity * self->value_size);
+  }
+  if (!index || !hashes || !live || !keys
+      || (self->value_size > 0 && !values))
+  {
+    cc_large_free(index);
+    cc_large_free(hashes);
+    cc_large_free(live);
+    cc_large_free(keys);
+    cc_large_free(values);
+    return false;
+  }
+
+  // Live entries are moved down over the tombstones, keeping their order.
+  size_t count = 0;
+  for (size_t n = 0; n < self->count; ++n)
+  {
+    if (self->live[n])
+    {
+      cc_relocate(
+          &self->key_functions,
+          (char*) keys + count * self->key_size,
+          _cc_ordered_map_key(self, n),
+          self->key_size
+        );
+      if (values)
+      {
+        cc_relocate(
+            &self->value_functions,
+            (char*) values + count * self->value_size,
+            _cc_ordered_map_value(self, n),
+            self->value_size
+          );
+      }
+      hashes[count] = self->hashes[n];
+      live[count] = true;
+      ++count;
+    }
+  }
+
+  cc_large_free(self->index);
+  cc_large_free(self->hashes);
+  cc_large_free(self->live);
+  cc_large_free(self->keys);
+  cc_large_free(self->values);
+
+  self->count = count;
+  self->capacity = capacity;
+  self->index_capacity = index_capacity;
+  self->index_width = width;
+  self->index = index;
+  self->hashes = hashes;
+  self->live = live;
+  self->keys = keys;
+  self->values = values;
+
+  _cc_ordered_map_build_index(self);
+
+  return true;
+}
+
+void
+_cc_ordered_map_init(struct cc_ordered_map* self,
+                     size_t key_size,
+                     size_t value_size,
+                     uint64_t seed,
+                     const struct cc_functions key_functions,
+                     const struct cc_functions value_functions)
+{
+  self->size = 0;
+  self->count = 0;
+  self->capacity = 0;
+  self->index_capacity = 0;
+  self->index_width = 0;
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->seed = seed;
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->index = NULL;
+  self->hashes = NULL;
+  self->live = NULL;
+  self->keys = NULL;
+  self->values = NULL;
+}
+
+uint64_t
+cc_ordered_map_hasher(const void* buffer, size_t size)
+{
+  const struct cc_ordered_map* self = (const struct cc_ordered_map*) buffer;
+
+  uint64_t hash = 0;
+  for (size_t n = 0; n < self->count; ++n)
+  {
+    if (self->live[n])
+    {
+      uint64_t entry = self->key_functions.hasher(
+          _cc_ordered_map_key(self, n),
+          self->key_size
+        );
+      if (self->value_size > 0)
+      {
+        cc_hash_combine(&entry, self->value_functions.hasher(
+            _cc_ordered_map_value(self, n),
+            self->value_size
+          ));
+      }
+      hash += entry;
+    }
+  }
+
+  return hash;
+}
+
+void*
+cc_ordered_map_copier(void* dest, const void* src, size_t size)
+{
+  if (dest && src)
+  {
+    struct cc_ordered_map* self = (struct cc_ordered_map*) dest;
+    const struct cc_ordered_map* other = (const struct cc_ordered_map*) src;
+
+    _cc_ordered_map_init(
+        self,
+        other->key_size,
+        other->value_size,
+        other->seed,
+        other->key_functions,
+        other->value_functions
+      );
+    if (!_cc_ordered_map_resize(self, other->size))
+    {
+      return NULL;
+    }
+
+    for (size_t n = 0; n < other->count; ++n)
+    {
+      if (other->live[n])
+      {
+        cc_ordered_map_insert(
+            self,
+            _cc_ordered_map_key(other, n),
+            _cc_ordered_map_value(other, n)
+          );
+      }
+    }
+
+    return self;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void
+cc_ordered_map_deleter(void* ptr)
+{
+  if (ptr)
+  {
+    struct cc_ordered_map* self = (struct cc_ordered_map*) ptr;
+
+    cc_ordered_map_clear(self);
+
+    cc_large_free(self->index);
+    cc_large_free(self->hashes);
+    cc_large_free(self->live);
+    cc_large_free(self->keys);
+    cc_large_free(self->values);
+
+    _cc_ordered_map_init(
+        self,
+        0,
+        0,
+        0,
+        cc_default_functions,
+        cc_default_functions
+      );
+  }
+}
+
+bool
+cc_ordered_map_equality(const void* left, const void* right, size_t size)
+{
+  if (left && right)
+  {
+    const struct cc_ordered_map* self = (const struct cc_ordered_map*) left;
+    const struct cc_ordered_map* other = (const struct cc_ordered_map*) right;
+
+    if (self->size != other->size
+        || self->key_size != other->key_size
+        || self->value_size != other->value_size)
+    {
+      return false;
+    }
+
+    // Like the unordered map, equality does not depend on insertion order.
+    for (size_t n = 0; n < self->count; ++n)
+    {
+      if (self->live[n])
+      {
+        const void* key = _cc_ordered_map_key(self, n);
+        size_t slot;
+        size_t entry = _cc_ordered_map_lookup(
+            other,
+            key,
+            _cc_ordered_map_hash(other, key),
+            &slot
+          );
+        if (entry == _cc_ordered_map_missing
+            || (self->value_size > 0
+                && !self->value_functions.equality(
+                    _cc_ordered_map_value(self, n),
+                    _cc_ordered_map_value(other, entry),
+                    self->value_size
+                  )))
+        {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+struct cc_ordered_map*
+cc_ordered_map_new(size_t key_size, size_t value_size)
+{
+  return cc_ordered_map_new_f(
+      key_size,
+      value_size,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_ordered_map*
+cc_ordered_map_from_arrays(const void* keys,
+                           const void* values,
+                           size_t count,
+                           size_t key_size,
+                           size_t value_size)
+{
+  return cc_ordered_map_from_arrays_f(
+      keys,
+      values,
+      count,
+      key_size,
+      value_size,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_ordered_map*
+cc_ordered_map_new_f(size_t key_size,
+                     size_t value_size,
+                     const struct cc_functions key_functions,
+                     const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_ordered_map));
+  struct cc_ordered_map* self = (struct cc_ordered_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  _cc_ordered_map_init(
+      self,
+      key_size,
+      value_size,
+      cc_hash_seed(),
+      key_functions,
+      value_functions
+    );
+  if (!_cc_ordered_map_resize(self, 0))
+  {
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_ordered_map*
+cc_ordered_map_from_arrays_f(const void* keys,
+                             const void* values,
+                             size_t count,
+                             size_t key_size,
+                             size_t value_size,
+                             const struct cc_functions key_functions,
+                             const struct cc_functions value_functions)
+{
+  struct cc_ordered_map* self = cc_ordered_map_new_f(
+      key_size,
+      value_size,
+      key_functions,
+      value_functions
+    );
+  if (!self)
+  {
+    return NULL;
+  }
+
+  cc_ordered_map_reserve(self, count);
+
+  const void* key = keys;
+  const void* value = values;
+  for (size_t n = 0; n < count; ++n, key += key_size, value += value_size)
+  {
+    cc_ordered_map_insert(self, key, value);
+  }
+
+  return self;
+}
+
+struct cc_ordered_map*
+cc_ordered_map_copy(const struct cc_ordered_map* other)
+{
+  void* buffer = malloc(sizeof(struct cc_ordered_map));
+  struct cc_ordered_map* self = (struct cc_ordered_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  if (!cc_ordered_map_copier(self, other, sizeof(struct cc_ordered_map)))
+  {
+    cc_ordered_map_deleter(self);
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+void
+cc_ordered_map_delete(struct cc_ordered_map* self)
+{
+  cc_ordered_map_deleter(self);
+  free(self);
+}
+
+struct cc_ordered_map_iterator
+cc_ordered_map_begin(struct cc_ordered_map* self)
+{
+  size_t position = 0;
+  while (position < self->count && !self->live[position])
+  {
+    ++position;
+  }
+
+  return (struct cc_ordered_map_iterator){
+    .map = self,
+    .position = position
+  };
+}
+
+struct cc_ordered_map_iterator
+cc_ordered_map_end(struct cc_ordered_map* self)
+{
+  return (struct cc_ordered_map_iterator){
+    .map = self,
+    .position = self->count
+  };
+}
+
+bool
+cc_ordered_map_empty(const struct cc_ordered_map* self)
+{
+  if (self)
+  {
+    return self->size == 0;
+  }
+  else
+  {
+    return true;
+  }
+}
+
+size_t
+cc_ordered_map_size(const struct cc_ordered_map* self)
+{
+  if (self)
+  {
+    return self->size;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_ordered_map_capacity(const struct cc_ordered_map* self)
+{
+  if (self)
+  {
+    return self->capacity;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_ordered_map_clear(struct cc_ordered_map* self)
+{
+  if (self)
+  {
+    for (size_t n = 0; n < self->count; ++n)
+    {
+      if (self->live[n])
+      {
+        self->key_functions.deleter(_cc_ordered_map_key(self, n));
+        if (self->value_size > 0)
+        {
+          self->value_functions.deleter(_cc_ordered_map_value(self, n));
+        }
+        self->live[n] = false;
+      }
+    }
+    if (self->index)
+    {
+      memset(self->index, 0, self->index_capacity * self->index_width);
+    }
+    self->size = 0;
+    self->count = 0;
+  }
+}
+
+void
+cc_ordered_map_insert(struct cc_ordered_map* self,
+                      const void* key,
+                      const void* value)
+{
+  if (self && key && (value || self->value_size == 0))
+  {
+    uint64_t hash = _cc_ordered_map_hash(self, key);
+    size_t slot;
+    size_t entry = _cc_ordered_map_lookup(self, key, hash, &slot);
+    if (entry != _cc_ordered_map_missing)
+    {
+      // Replacing a value keeps the entry's original position.
+      if (self->value_size > 0)
+      {
+        void* existing = _cc_ordered_map_value(self, entry);
+        self->value_functions.deleter(existing);
+        self->value_functions.copier(existing, value, self->value_size);
+      }
+      return;
+    }
+
+    if (self->count == self->capacity)
+    {
+      if (!_cc_ordered_map_resize(self, 2 * self->size + 1))
+      {
+        return;
+      }
+      _cc_ordered_map_lookup(self, key, hash, &slot);
+    }
+
+    entry = self->count;
+    self->key_functions.copier(
+        _cc_ordered_map_key(self, entry),
+        key,
+        self->key_size
+      );
+    if (self->value_size > 0)
+    {
+      self->value_functions.copier(
+          _cc_ordered_map_value(self, entry),
+          value,
+          self->value_size
+        );
+    }
+    self->hashes[entry] = hash;
+    self->live[entry] = true;
+    _cc_ordered_map_set_slot(self, slot, entry + 1);
+
+    ++self->count;
+    ++self->size;
+  }
+}
+
+void
+cc_ordered_map_erase(struct cc_ordered_map* self, const void* key)
+{
+  if (self && key)
+  {
+    size_t slot;
+    size_t entry = _cc_ordered_map_lookup(
+        self,
+        key,
+        _cc_ordered_map_hash(self, key),
+        &slot
+      );
+    if (entry == _cc_ordered_map_missing)
+    {
+      return;
+    }
+
+    _cc_ordered_map_set_slot(self, slot, _cc_ordered_map_dummy);
+    self->key_functions.deleter(_cc_ordered_map_key(self, entry));
+    if (self->value_size > 0)
+    {
+      self->value_functions.deleter(_cc_ordered_map_value(self, entry));
+    }
+    self->live[entry] = false;
+    --self->size;
+
+    if (self->size == 0)
+    {
+      cc_ordered_map_clear(self);
+    }
+    else if (self->count - self->size > self->count / 2)
+    {
+      _cc_ordered_map_resize(self, self->capacity);
+    }
+  }
+}
+
+void
+cc_ordered_map_swap(struct cc_ordered_map* self,
+                    struct cc_ordered_map* other)
+{
+  if (self && other)
+  {
+    struct cc_ordered_map temp = *self;
+    *self = *other;
+    *other = temp;
+  }
+}
+
+void*
+cc_ordered_map_find(const struct cc_ordered_map* self, const void* key)
+{
+  if (self && key)
+  {
+    size_t slot;
+    size_t entry = _cc_ordered_map_lookup(
+        self,
+        key,
+        _cc_ordered_map_hash(self, key),
+        &slot
+      );
+    if (entry != _cc_ordered_map_missing)
+    {
+      return _cc_ordered_map_value(self, entry);
+    }
+  }
+
+  return NULL;
+}
+
+bool
+cc_ordered_map_contains(const struct cc_ordered_map* self, const void* key)
+{
+  if (self && key)
+  {
+    size_t slot;
+    size_t entry = _cc_ordered_map_lookup(
+        self,
+        key,
+        _cc_ordered_map_hash(self, key),
+        &slot
+      );
+    return entry != _cc_ordered_map_missing;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+void
+cc_ordered_map_reserve(struct cc_ordered_map* self, size_t count)
+{
+  if (self && count > self->capacity)
+  {
+    _cc_ordered_map_resize(self, count);
+  }
+}
+
+bool
+cc_ordered_map_eq(const struct cc_ordered_map* self,
+                  const struct cc_ordered_map* other)
+{
+  return cc_ordered_map_equality(self, other, sizeof(struct cc_ordered_map));
+}
+
+bool
+cc_ordered_map_ne(const struct cc_ordered_map* self,
+                  const struct cc_ordered_map* other)
+{
+  return !cc_ordered_map_eq(self, other);
+}
+
+void
+cc_ordered_map_iterator_increment(struct cc_ordered_map_iterator* self)
+{
+  ++self->position;
+  while (self->position < self->map->count
+         && !self->map->live[self->position])
+  {
+    ++self->position;
+  }
+}
+
+void
+cc_ordered_map_iterator_decrement(struct cc_ordered_map_iterator* self)
+{
+  --self->position;
+  while (self->position > 0 && !self->map->live[self->position])
+  {
+    --self->position;
+  }
+}
+
+struct cc_ordered_map_key_value
+cc_ordered_map_iterator_dereference(const struct cc_ordered_map_iterator self)
+{
+  return (struct cc_ordered_map_key_value){
+    .key = _cc_ordered_map_key(self.map, self.position),
+    .value = _cc_ordered_map_value(self.map, self.position)
+  };
+}
+
+bool
+cc_ordered_map_iterator_eq(const struct cc_ordered_map_iterator self,
+                           const struct cc_ordered_map_iterator other)
+{
+  return self.map == other.map && self.position == other.position;
+}
+
+bool
+cc_ordered_map_iterator_ne(const struct cc_ordered_map_iterator self,
+                           const struct cc_ordered_map_iterator other)
+{
+  return self.map != other.map || self.position != other.position;
+}
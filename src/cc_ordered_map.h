@@ -0,0 +1,177 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_ORDERED_MAP_H
+#define CC_ORDERED_MAP_H
+
+#include "cc_memory.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A hash map that iterates in insertion order.  Entries are packed densely in
+// the order they were inserted; a separate open-addressed index of 1, 2, 4 or
+// 8 byte entry numbers (whichever is wide enough) is used for probing.  Erased
+// entries leave tombstones that are squeezed out once they make up half of
+// the entries.
+struct cc_ordered_map
+{
+  size_t size;
+  size_t count;
+  size_t capacity;
+  size_t index_capacity;
+  size_t index_width;
+  size_t key_size;
+  size_t value_size;
+  uint64_t seed;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  void* index;
+  uint64_t* hashes;
+  bool* live;
+  void* keys;
+  void* values;
+};
+
+struct cc_ordered_map_iterator
+{
+  struct cc_ordered_map* map;
+  size_t position;
+};
+
+struct cc_ordered_map_key_value
+{
+  void* key;
+  void* value;
+};
+
+typedef struct cc_ordered_map* cc_ordered_map_t;
+
+typedef struct cc_ordered_map_iterator cc_ordered_map_iterator_t;
+
+typedef struct cc_ordered_map_key_value cc_ordered_map_key_value_t;
+
+extern const size_t cc_ordered_map_sizeof;
+
+extern const struct cc_functions cc_ordered_map_functions;
+
+uint64_t
+cc_ordered_map_hasher(const void* buffer, size_t size);
+
+void*
+cc_ordered_map_copier(void* dest, const void* src, size_t size);
+
+void
+cc_ordered_map_deleter(void* ptr);
+
+bool
+cc_ordered_map_equality(const void* left, const void* right, size_t size);
+
+struct cc_ordered_map*
+cc_ordered_map_new(size_t key_size, size_t value_size);
+
+struct cc_ordered_map*
+cc_ordered_map_from_arrays(const void* keys,
+                           const void* values,
+                           size_t count,
+                           size_t key_size,
+                           size_t value_size);
+
+struct cc_ordered_map*
+cc_ordered_map_new_f(size_t key_size,
+                     size_t value_size,
+                     const struct cc_functions key_functions,
+                     const struct cc_functions value_functions);
+
+struct cc_ordered_map*
+cc_ordered_map_from_arrays_f(const void* keys,
+                             const void* values,
+                             size_t count,
+                             size_t key_size,
+                             size_t value_size,
+                             const struct cc_functions key_functions,
+                             const struct cc_functions value_functions);
+
+struct cc_ordered_map*
+cc_ordered_map_copy(const struct cc_ordered_map* other);
+
+void
+cc_ordered_map_delete(struct cc_ordered_map* self);
+
+struct cc_ordered_map_iterator
+cc_ordered_map_begin(struct cc_ordered_map* self);
+
+struct cc_ordered_map_iterator
+cc_ordered_map_end(struct cc_ordered_map* self);
+
+bool
+cc_ordered_map_empty(const struct cc_ordered_map* self);
+
+size_t
+cc_ordered_map_size(const struct cc_ordered_map* self);
+
+size_t
+cc_ordered_map_capacity(const struct cc_ordered_map* self);
+
+void
+cc_ordered_map_clear(struct cc_ordered_map* self);
+
+void
+cc_ordered_map_insert(struct cc_ordered_map* self,
+                      const void* key,
+                      const void* value);
+
+void
+cc_ordered_map_erase(struct cc_ordered_map* self, const void* key);
+
+void
+cc_ordered_map_swap(struct cc_ordered_map* self,
+                    struct cc_ordered_map* other);
+
+void*
+cc_ordered_map_find(const struct cc_ordered_map* self, const void* key);
+
+bool
+cc_ordered_map_contains(const struct cc_ordered_map* self, const void* key);
+
+void
+cc_ordered_map_reserve(struct cc_ordered_map* self, size_t count);
+
+bool
+cc_ordered_map_eq(const struct cc_ordered_map* self,
+                  const struct cc_ordered_map* other);
+
+bool
+cc_ordered_map_ne(const struct cc_ordered_map* self,
+                  const struct cc_ordered_map* other);
+
+void
+cc_ordered_map_iterator_increment(struct cc_ordered_map_iterator* self);
+
+void
+cc_ordered_map_iterator_decrement(struct cc_ordered_map_iterator* self);
+
+struct cc_ordered_map_key_value
+cc_ordered_map_iterator_dereference(const struct cc_ordered_map_iterator self);
+
+bool
+cc_ordered_map_iterator_eq(const struct cc_ordered_map_iterator self,
+                           const struct cc_ordered_map_iterator other);
+
+bool
+cc_ordered_map_iterator_ne(const struct cc_ordered_map_iterator self,
+                           const struct cc_ordered_map_iterator other);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_ORDERED_MAP_H
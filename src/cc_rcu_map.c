@@ -0,0 +1,289 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "cc_rcu_map.h"
+
+struct cc_rcu_map_reader
+{
+  // Zero while the reader is outside a read-side critical section, otherwise
+  // the global epoch observed on entry.  Only the owning thread writes it, and
+  // it sits on its own cache line.
+  _Alignas(64) atomic_uint_fast64_t epoch;
+  struct cc_rcu_map* map;
+  struct cc_rcu_map_reader* next;
+};
+
+struct cc_rcu_map
+{
+  _Atomic(struct cc_map*) current;
+  atomic_uint_fast64_t epoch;
+  pthread_mutex_t writer;
+  struct cc_rcu_map_reader* readers;
+};
+
+void
+_cc_rcu_map_synchronize(struct cc_rcu_map* self)
+{
+  // Readers that entered before the epoch advanced may still hold the old
+  // snapshot; readers that entered afterwards are guaranteed to see the new
+  // one.  Wait for the former to leave.
+  uint_fast64_t target = atomic_fetch_add(&self->epoch, 1) + 1;
+
+  struct cc_rcu_map_reader* reader = self->readers;
+  while (reader)
+  {
+    uint_fast64_t epoch = atomic_load(&reader->epoch);
+    while (epoch != 0 && epoch < target)
+    {
+      sched_yield();
+      epoch = atomic_load(&reader->epoch);
+    }
+    reader = reader->next;
+  }
+}
+
+void
+_cc_rcu_map_replace(struct cc_rcu_map* self, struct cc_map* map)
+{
+  struct cc_map* old = atomic_exchange(&self->current, map);
+  _cc_rcu_map_synchronize(self);
+  cc_map_delete(old);
+}
+
+struct cc_rcu_map*
+cc_rcu_map_new(size_t key_size, size_t value_size)
+{
+  return cc_rcu_map_new_f(
+      key_size,
+      value_size,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_rcu_map*
+cc_rcu_map_new_f(size_t key_size,
+                 size_t value_size,
+                 const struct cc_functions key_functions,
+                 const struct cc_functions value_functions)
+{
+  struct cc_map* map = cc_map_new_f(
+      key_size,
+      value_size,
+      key_functions,
+      value_functions
+    );
+  if (!map)
+  {
+    return NULL;
+  }
+
+  struct cc_rcu_map* self = cc_rcu_map_from_map(map);
+  if (!self)
+  {
+    cc_map_delete(map);
+    return NULL;
+  }
+
+  return self;
+}
+
+struct cc_rcu_map*
+cc_rcu_map_from_map(struct cc_map* map)
+{
+  if (!map)
+  {
+    return NULL;
+  }
+
+  void* buffer = malloc(sizeof(struct cc_rcu_map));
+  struct cc_rcu_map* self = (struct cc_rcu_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  if (pthread_mutex_init(&self->writer, NULL) != 0)
+  {
+    free(self);
+    return NULL;
+  }
+
+  atomic_init(&self->current, map);
+  atomic_init(&self->epoch, 1);
+  self->readers = NULL;
+
+  return self;
+}
+
+void
+cc_rcu_map_delete(struct cc_rcu_map* self)
+{
+  if (self)
+  {
+    struct cc_rcu_map_reader* reader = self->readers;
+    struct cc_rcu_map_reader* next;
+    while (reader)
+    {
+      next = reader->next;
+      free(reader);
+      reader = next;
+    }
+
+    cc_map_delete(atomic_load(&self->current));
+    pthread_mutex_destroy(&self->writer);
+    free(self);
+  }
+}
+
+struct cc_rcu_map_reader*
+cc_rcu_map_reader_new(struct cc_rcu_map* self)
+{
+  if (!self)
+  {
+    return NULL;
+  }
+
+  void* buffer = aligned_alloc(
+      _Alignof(struct cc_rcu_map_reader),
+      sizeof(struct cc_rcu_map_reader)
+    );
+  struct cc_rcu_map_reader* reader = (struct cc_rcu_map_reader*) buffer;
+  if (!reader)
+  {
+    return NULL;
+  }
+
+  atomic_init(&reader->epoch, 0);
+  reader->map = self;
+
+  pthread_mutex_lock(&self->writer);
+  reader->next = self->readers;
+  self->readers = reader;
+  pthread_mutex_unlock(&self->writer);
+
+  return reader;
+}
+
+void
+cc_rcu_map_reader_delete(struct cc_rcu_map_reader* reader)
+{
+  if (reader)
+  {
+    struct cc_rcu_map* self = reader->map;
+
+    pthread_mutex_lock(&self->writer);
+    struct cc_rcu_map_reader** link = &self->readers;
+    while (*link && *link != reader)
+    {
+      link = &(*link)->next;
+    }
+    if (*link)
+    {
+      *link = reader->next;
+    }
+    pthread_mutex_unlock(&self->writer);
+
+    free(reader);
+  }
+}
+
+const struct cc_map*
+cc_rcu_map_read_lock(struct cc_rcu_map_reader* reader)
+{
+  if (reader)
+  {
+    struct cc_rcu_map* self = reader->map;
+    atomic_store(&reader->epoch, atomic_load(&self->epoch));
+    return atomic_load(&self->current);
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void
+cc_rcu_map_read_unlock(struct cc_rcu_map_reader* reader)
+{
+  if (reader)
+  {
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+  }
+}
+
+void
+cc_rcu_map_insert(struct cc_rcu_map* self, const void* key, const void* value)
+{
+  if (self && key && value)
+  {
+    pthread_mutex_lock(&self->writer);
+    struct cc_map* map = cc_map_copy(atomic_load(&self->current));
+    if (map)
+    {
+      cc_map_insert(map, key, value);
+      _cc_rcu_map_replace(self, map);
+    }
+    pthread_mutex_unlock(&self->writer);
+  }
+}
+
+void
+cc_rcu_map_erase(struct cc_rcu_map* self, const void* key)
+{
+  if (self && key)
+  {
+    pthread_mutex_lock(&self->writer);
+    struct cc_map* current = atomic_load(&self->current);
+    if (cc_map_contains(current, key))
+    {
+      struct cc_map* map = cc_map_copy(current);
+      if (map)
+      {
+        cc_map_erase(map, key);
+        _cc_rcu_map_replace(self, map);
+      }
+    }
+    pthread_mutex_unlock(&self->writer);
+  }
+}
+
+void
+cc_rcu_map_update(struct cc_rcu_map* self,
+                  cc_rcu_map_update_fn update,
+                  void* arg)
+{
+  if (self && update)
+  {
+    pthread_mutex_lock(&self->writer);
+    struct cc_map* map = cc_map_copy(atomic_load(&self->current));
+    if (map)
+    {
+      update(map, arg);
+      _cc_rcu_map_replace(self, map);
+    }
+    pthread_mutex_unlock(&self->writer);
+  }
+}
+
+void
+cc_rcu_map_publish(struct cc_rcu_map* self, struct cc_map* map)
+{
+  if (self && map)
+  {
+    pthread_mutex_lock(&self->writer);
+    _cc_rcu_map_replace(self, map);
+    pthread_mutex_unlock(&self->writer);
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_RCU_MAP_H
+#define CC_RCU_MAP_H
+
+#include "cc_map.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A read-mostly map.  Readers see an immutable cc_map snapshot without taking
+// locks; writers build a modified copy, publish it, and free the old snapshot
+// once every reader has left it.  Both structures contain C11 atomics, so
+// their layouts are private to cc_rcu_map.c.
+struct cc_rcu_map;
+
+struct cc_rcu_map_reader;
+
+typedef struct cc_rcu_map* cc_rcu_map_t;
+
+typedef struct cc_rcu_map_reader* cc_rcu_map_reader_t;
+
+typedef void (*cc_rcu_map_update_fn)(struct cc_map* map, void* arg);
+
+struct cc_rcu_map*
+cc_rcu_map_new(size_t key_size, size_t value_size);
+
+struct cc_rcu_map*
+cc_rcu_map_new_f(size_t key_size,
+                 size_t value_size,
+                 const struct cc_functions key_functions,
+                 const struct cc_functions value_functions);
+
+struct cc_rcu_map*
+cc_rcu_map_from_map(struct cc_map* map);
+
+void
+cc_rcu_map_delete(struct cc_rcu_map* self);
+
+struct cc_rcu_map_reader*
+cc_rcu_map_reader_new(struct cc_rcu_map* self);
+
+void
+cc_rcu_map_reader_delete(struct cc_rcu_map_reader* reader);
+
+const struct cc_map*
+cc_rcu_map_read_lock(struct cc_rcu_map_reader* reader);
+
+void
+cc_rcu_map_read_unlock(struct cc_rcu_map_reader* reader);
+
+void
+cc_rcu_map_insert(struct cc_rcu_map* self, const void* key, const void* value);
+
+void
+cc_rcu_map_erase(struct cc_rcu_map* self, const void* key);
+
+void
+cc_rcu_map_update(struct cc_rcu_map* self,
+                  cc_rcu_map_update_fn update,
+                  void* arg);
+
+void
+cc_rcu_map_publish(struct cc_rcu_map* self, struct cc_map* map);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_RCU_MAP_H
@@ -0,0 +1,359 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include "cc_set.h"
+
+const size_t cc_set_sizeof = sizeof(struct cc_set);
+
+const struct cc_functions cc_set_functions = (struct cc_functions){
+  .hasher = cc_set_hasher,
+  .copier = cc_set_copier,
+  .deleter = cc_set_deleter,
+  .equality = cc_set_equality,
+  .relocator = cc_default_relocator
+};
+
+void
+_cc_set_retain(struct cc_set* self, const struct cc_set* other, bool common)
+{
+  size_t n = 0;
+  struct cc_map_node* node = self->map.nodes;
+  while (n < self->map.capacity)
+  {
+    if (node->length > 0 && cc_set_contains(other, node->key) != common)
+    {
+      cc_map_erase(&self->map, node->key);
+
+      // Erasing shifts the following entries back by one slot, so look at
+      // this slot again.
+      continue;
+    }
+    ++n;
+    ++node;
+  }
+}
+
+uint64_t
+cc_set_hasher(const void* buffer, size_t size)
+{
+  return cc_map_hasher(buffer, sizeof(struct cc_map));
+}
+
+void*
+cc_set_copier(void* dest, const void* src, size_t size)
+{
+  return cc_map_copier(dest, src, sizeof(struct cc_map));
+}
+
+void
+cc_set_deleter(void* ptr)
+{
+  cc_map_deleter(ptr);
+}
+
+bool
+cc_set_equality(const void* left, const void* right, size_t size)
+{
+  return cc_map_equality(left, right, sizeof(struct cc_map));
+}
+
+struct cc_set*
+cc_set_new(size_t key_size)
+{
+  return cc_set_new_f(key_size, cc_default_functions);
+}
+
+struct cc_set*
+cc_set_from_array(const void* keys, size_t count, size_t key_size)
+{
+  return cc_set_from_array_f(keys, count, key_size, cc_default_functions);
+}
+
+struct cc_set*
+cc_set_new_f(size_t key_size, const struct cc_functions key_functions)
+{
+  // A set is laid out exactly like the map it wraps.
+  struct cc_map* map = cc_map_new_f(
+      key_size,
+      0,
+      key_functions,
+      cc_default_functions
+    );
+  return (struct cc_set*) map;
+}
+
+struct cc_set*
+cc_set_from_array_f(const void* keys,
+                    size_t count,
+                    size_t key_size,
+                    const struct cc_functions key_functions)
+{
+  struct cc_set* self = cc_set_new_f(key_size, key_functions);
+  if (!self)
+  {
+    return NULL;
+  }
+
+  cc_set_reserve(self, count);
+
+  const void* key = keys;
+  for (size_t n = 0; n < count; ++n, key += key_size)
+  {
+    cc_set_insert(self, key);
+  }
+
+  return self;
+}
+
+struct cc_set*
+cc_set_copy(const struct cc_set* other)
+{
+  if (other)
+  {
+    return (struct cc_set*) cc_map_copy(&other->map);
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void
+cc_set_delete(struct cc_set* self)
+{
+  cc_map_delete((struct cc_map*) self);
+}
+
+struct cc_set_iterator
+cc_set_begin(struct cc_set* self)
+{
+  return (struct cc_set_iterator){
+    .set = self,
+    .node = cc_map_begin(&self->map).node
+  };
+}
+
+struct cc_set_iterator
+cc_set_end(struct cc_set* self)
+{
+  return (struct cc_set_iterator){
+    .set = self,
+    .node = cc_map_end(&self->map).node
+  };
+}
+
+bool
+cc_set_empty(const struct cc_set* self)
+{
+  return cc_map_empty((const struct cc_map*) self);
+}
+
+size_t
+cc_set_size(const struct cc_set* self)
+{
+  return cc_map_size((const struct cc_map*) self);
+}
+
+size_t
+cc_set_capacity(const struct cc_set* self)
+{
+  return cc_map_capacity((const struct cc_map*) self);
+}
+
+void
+cc_set_clear(struct cc_set* self)
+{
+  cc_map_clear((struct cc_map*) self);
+}
+
+void
+cc_set_insert(struct cc_set* self, const void* key)
+{
+  cc_map_insert((struct cc_map*) self, key, NULL);
+}
+
+void
+cc_set_erase(struct cc_set* self, const void* key)
+{
+  cc_map_erase((struct cc_map*) self, key);
+}
+
+void
+cc_set_swap(struct cc_set* self, struct cc_set* other)
+{
+  cc_map_swap((struct cc_map*) self, (struct cc_map*) other);
+}
+
+bool
+cc_set_contains(const struct cc_set* self, const void* key)
+{
+  return cc_map_contains((const struct cc_map*) self, key);
+}
+
+void
+cc_set_reserve(struct cc_set* self, size_t count)
+{
+  cc_map_reserve((struct cc_map*) self, count);
+}
+
+bool
+cc_set_attach_bloom(struct cc_set* self, double false_positive_rate)
+{
+  return cc_map_attach_bloom((struct cc_map*) self, false_positive_rate);
+}
+
+void
+cc_set_detach_bloom(struct cc_set* self)
+{
+  cc_map_detach_bloom((struct cc_map*) self);
+}
+
+void
+_cc_set_make_room(struct cc_set* self, size_t count)
+{
+  // Rebuild the table only if count keys would push it past its load limit;
+  // reserving unconditionally rehashes every key already in the set.
+  size_t total = self->map.size + count;
+  if (total < count)
+  {
+    return;
+  }
+  double load_factor = (double) total / (double) self->map.capacity;
+  if (load_factor > self->map.max_load_factor)
+  {
+    cc_set_reserve(self, total);
+  }
+}
+
+void
+cc_set_union(struct cc_set* self, const struct cc_set* other)
+{
+  if (self && other)
+  {
+    _cc_set_make_room(self, other->map.size);
+
+    const struct cc_map_node* node = other->map.nodes;
+    for (size_t n = 0; n < other->map.capacity; ++n, ++node)
+    {
+      if (node->length > 0)
+      {
+        cc_set_insert(self, node->key);
+      }
+    }
+  }
+}
+
+void
+cc_set_intersection(struct cc_set* self, const struct cc_set* other)
+{
+  if (self && other)
+  {
+    if (self->map.size <= other->map.size)
+    {
+      _cc_set_retain(self, other, true);
+      return;
+    }
+
+    // The other set is smaller, so probe this one with its keys and collect
+    // the common keys into a new table.
+    struct cc_set* result = cc_set_new_f(
+        self->map.key_size,
+        self->map.key_functions
+      );
+    if (!result)
+    {
+      return;
+    }
+    result->map.max_load_factor = self->map.max_load_factor;
+    _cc_set_make_room(result, other->map.size);
+    if (self->map.bloom)
+    {
+      cc_set_attach_bloom(result, self->map.bloom->false_positive_rate);
+    }
+
+    const struct cc_map_node* node = other->map.nodes;
+    for (size_t n = 0; n < other->map.capacity; ++n, ++node)
+    {
+      if (node->length > 0 && cc_set_contains(self, node->key))
+      {
+        cc_set_insert(result, node->key);
+      }
+    }
+
+    cc_set_swap(self, result);
+    cc_set_delete(result);
+  }
+}
+
+void
+cc_set_difference(struct cc_set* self, const struct cc_set* other)
+{
+  if (self && other)
+  {
+    if (self->map.size <= other->map.size)
+    {
+      _cc_set_retain(self, other, false);
+      return;
+    }
+
+    const struct cc_map_node* node = other->map.nodes;
+    for (size_t n = 0; n < other->map.capacity; ++n, ++node)
+    {
+      if (node->length > 0)
+      {
+        cc_set_erase(self, node->key);
+      }
+    }
+  }
+}
+
+bool
+cc_set_eq(const struct cc_set* self, const struct cc_set* other)
+{
+  return cc_set_equality(self, other, sizeof(struct cc_set));
+}
+
+bool
+cc_set_ne(const struct cc_set* self, const struct cc_set* other)
+{
+  return !cc_set_eq(self, other);
+}
+
+void
+cc_set_iterator_increment(struct cc_set_iterator* self)
+{
+  ++self->node;
+  struct cc_map_node* last = self->set->map.nodes + self->set->map.capacity;
+  while (self->node->length == 0 && self->node != last)
+  {
+    ++self->node;
+  }
+}
+
+void*
+cc_set_iterator_dereference(const struct cc_set_iterator self)
+{
+  return self.node->key;
+}
+
+bool
+cc_set_iterator_eq(const struct cc_set_iterator self,
+                   const struct cc_set_iterator other)
+{
+  return self.set == other.set && self.node == other.node;
+}
+
+bool
+cc_set_iterator_ne(const struct cc_set_iterator self,
+                   const struct cc_set_iterator other)
+{
+  return self.set != other.set || self.node != other.node;
+}
@@ -0,0 +1,146 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_SET_H
+#define CC_SET_H
+
+#include "cc_map.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A hash set.  It is a cc_map whose value size is zero, so it shares the map's
+// probing engine but never allocates, copies or deletes values.
+struct cc_set
+{
+  struct cc_map map;
+};
+
+struct cc_set_iterator
+{
+  struct cc_set* set;
+  struct cc_map_node* node;
+};
+
+typedef struct cc_set* cc_set_t;
+
+typedef struct cc_set_iterator cc_set_iterator_t;
+
+extern const size_t cc_set_sizeof;
+
+extern const struct cc_functions cc_set_functions;
+
+uint64_t
+cc_set_hasher(const void* buffer, size_t size);
+
+void*
+cc_set_copier(void* dest, const void* src, size_t size);
+
+void
+cc_set_deleter(void* ptr);
+
+bool
+cc_set_equality(const void* left, const void* right, size_t size);
+
+struct cc_set*
+cc_set_new(size_t key_size);
+
+struct cc_set*
+cc_set_from_array(const void* keys, size_t count, size_t key_size);
+
+struct cc_set*
+cc_set_new_f(size_t key_size, const struct cc_functions key_functions);
+
+struct cc_set*
+cc_set_from_array_f(const void* keys,
+                    size_t count,
+                    size_t key_size,
+                    const struct cc_functions key_functions);
+
+struct cc_set*
+cc_set_copy(const struct cc_set* other);
+
+void
+cc_set_delete(struct cc_set* self);
+
+struct cc_set_iterator
+cc_set_begin(struct cc_set* self);
+
+struct cc_set_iterator
+cc_set_end(struct cc_set* self);
+
+bool
+cc_set_empty(const struct cc_set* self);
+
+size_t
+cc_set_size(const struct cc_set* self);
+
+size_t
+cc_set_capacity(const struct cc_set* self);
+
+void
+cc_set_clear(struct cc_set* self);
+
+void
+cc_set_insert(struct cc_set* self, const void* key);
+
+void
+cc_set_erase(struct cc_set* self, const void* key);
+
+void
+cc_set_swap(struct cc_set* self, struct cc_set* other);
+
+bool
+cc_set_contains(const struct cc_set* self, const void* key);
+
+void
+cc_set_reserve(struct cc_set* self, size_t count);
+
+bool
+cc_set_attach_bloom(struct cc_set* self, double false_positive_rate);
+
+void
+cc_set_detach_bloom(struct cc_set* self);
+
+void
+cc_set_union(struct cc_set* self, const struct cc_set* other);
+
+void
+cc_set_intersection(struct cc_set* self, const struct cc_set* other);
+
+void
+cc_set_difference(struct cc_set* self, const struct cc_set* other);
+
+bool
+cc_set_eq(const struct cc_set* self, const struct cc_set* other);
+
+bool
+cc_set_ne(const struct cc_set* self, const struct cc_set* other);
+
+void
+cc_set_iterator_increment(struct cc_set_iterator* self);
+
+void*
+cc_set_iterator_dereference(const struct cc_set_iterator self);
+
+bool
+cc_set_iterator_eq(const struct cc_set_iterator self,
+                   const struct cc_set_iterator other);
+
+bool
+cc_set_iterator_ne(const struct cc_set_iterator self,
+                   const struct cc_set_iterator other);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_SET_H
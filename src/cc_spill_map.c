@@ -0,0 +1,493 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "cc_spill_map.h"
+
+size_t
+_cc_spill_map_partition(const struct cc_spill_map* self, const void* key)
+{
+  if (self->partition_bits == 0)
+  {
+    return 0;
+  }
+
+  // High hash bits choose the partition; the in-memory tables use the low
+  // bits, so a partition still spreads evenly over its own table.
+  uint64_t hash = self->key_functions.hasher(key, self->key_size);
+  return (size_t) (hash >> (64 - self->partition_bits));
+}
+
+size_t
+_cc_spill_map_footprint(const struct cc_spill_map* self,
+                        const struct cc_map* map)
+{
+  // Count entries rather than slots: the table keeps its capacity when it is
+  // cleared, and would otherwise stay over budget after the first spill.
+  size_t slot = sizeof(struct cc_map_node) + self->key_size + self->value_size;
+  return cc_map_size(map) * slot;
+}
+
+struct cc_map*
+_cc_spill_map_new_table(const struct cc_spill_map* self)
+{
+  return cc_map_new_f(
+      self->key_size,
+      self->value_size,
+      self->key_functions,
+      self->value_functions
+    );
+}
+
+void
+_cc_spill_map_add(const struct cc_spill_map* self,
+                  struct cc_map* map,
+                  const void* key,
+                  const void* value)
+{
+  void* existing = self->combine ? cc_map_find(map, key) : NULL;
+  if (existing)
+  {
+    self->combine(existing, value, self->combine_arg);
+  }
+  else
+  {
+    cc_map_insert(map, key, value);
+  }
+}
+
+void
+_cc_spill_map_drop_cache(struct cc_spill_map* self)
+{
+  if (self->cache)
+  {
+    cc_map_delete(self->cache);
+    self->cache = NULL;
+  }
+}
+
+struct cc_spill_map*
+cc_spill_map_new(size_t key_size, size_t value_size, size_t memory_budget)
+{
+  return cc_spill_map_new_f(
+      key_size,
+      value_size,
+      memory_budget,
+      64,
+      cc_default_functions,
+      cc_default_functions
+    );
+}
+
+struct cc_spill_map*
+cc_spill_map_new_f(size_t key_size,
+                   size_t value_size,
+                   size_t memory_budget,
+                   size_t partition_count,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions)
+{
+  void* buffer = malloc(sizeof(struct cc_spill_map));
+  struct cc_spill_map* self = (struct cc_spill_map*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  unsigned int bits = 0;
+  while (((size_t) 1 << bits) < partition_count && bits < 16)
+  {
+    ++bits;
+  }
+
+  self->key_size = key_size;
+  self->value_size = value_size;
+  self->memory_budget = memory_budget;
+  self->partition_count = (size_t) 1 << bits;
+  self->partition_bits = bits;
+  self->spilled = 0;
+  self->key_functions = key_functions;
+  self->value_functions = value_functions;
+  self->combine = NULL;
+  self->combine_arg = NULL;
+  self->cached_partition = 0;
+  self->cache = NULL;
+
+  self->runs = (FILE**) calloc(self->partition_count, sizeof(FILE*));
+  if (!self->runs)
+  {
+    free(self);
+    return NULL;
+  }
+
+  self->memory = _cc_spill_map_new_table(self);
+  if (!self->memory)
+  {
+    free(self->runs);
+    free(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+void
+cc_spill_map_delete(struct cc_spill_map* self)
+{
+  if (self)
+  {
+    for (size_t n = 0; n < self->partition_count; ++n)
+    {
+      if (self->runs[n])
+      {
+        fclose(self->runs[n]);
+      }
+    }
+    free(self->runs);
+    _cc_spill_map_drop_cache(self);
+    cc_map_delete(self->memory);
+    free(self);
+  }
+}
+
+void
+cc_spill_map_set_combiner(struct cc_spill_map* self,
+                          cc_spill_map_combine_fn combine,
+                          void* arg)
+{
+  if (self)
+  {
+    self->combine = combine;
+    self->combine_arg = arg;
+    _cc_spill_map_drop_cache(self);
+  }
+}
+
+size_t
+cc_spill_map_partition_count(const struct cc_spill_map* self)
+{
+  if (self)
+  {
+    return self->partition_count;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_spill_map_memory_size(const struct cc_spill_map* self)
+{
+  if (self)
+  {
+    return cc_map_size(self->memory);
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+size_t
+cc_spill_map_spilled(const struct cc_spill_map* self)
+{
+  if (self)
+  {
+    return self->spilled;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_spill_map_clear(struct cc_spill_map* self)
+{
+  if (self)
+  {
+    for (size_t n = 0; n < self->partition_count; ++n)
+    {
+      if (self->runs[n])
+      {
+        fclose(self->runs[n]);
+        self->runs[n] = NULL;
+      }
+    }
+    self->spilled = 0;
+    _cc_spill_map_drop_cache(self);
+    cc_map_clear(self->memory);
+  }
+}
+
+void
+cc_spill_map_insert(struct cc_spill_map* self,
+                    const void* key,
+                    const void* value)
+{
+  if (self && key && value)
+  {
+    if (self->cache
+        && _cc_spill_map_partition(self, key) == self->cached_partition)
+    {
+      _cc_spill_map_drop_cache(self);
+    }
+
+    _cc_spill_map_add(self, self->memory, key, value);
+
+    if (_cc_spill_map_footprint(self, self->memory) > self->memory_budget)
+    {
+      cc_spill_map_spill(self);
+    }
+  }
+}
+
+bool
+_cc_spill_map_write(const struct cc_spill_map* self,
+                    FILE* run,
+                    const void* key,
+                    const void* value)
+{
+  return fwrite(key, self->key_size, 1, run) == 1
+      && (self->value_size == 0
+          || fwrite(value, self->value_size, 1, run) == 1);
+}
+
+bool
+_cc_spill_map_read(const struct cc_spill_map* self,
+                   FILE* run,
+                   void* key,
+                   void* value)
+{
+  return fread(key, self->key_size, 1, run) == 1
+      && (self->value_size == 0
+          || fread(value, self->value_size, 1, run) == 1);
+}
+
+bool
+cc_spill_map_spill(struct cc_spill_map* self)
+{
+  if (!self)
+  {
+    return false;
+  }
+  if (cc_map_empty(self->memory))
+  {
+    return true;
+  }
+
+  // Open every run file the entries need, and note where each one ends so
+  // that a failed write can be cut off again.  Nothing leaves memory unless
+  // every record reaches its run file.
+  long* ends = (long*) malloc(self->partition_count * sizeof(long));
+  if (!ends)
+  {
+    return false;
+  }
+  cc_map_iterator_t p = cc_map_begin(self->memory);
+  cc_map_iterator_t e = cc_map_end(self->memory);
+  for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+  {
+    cc_map_key_value_t kv = cc_map_iterator_dereference(p);
+    size_t partition = _cc_spill_map_partition(self, kv.key);
+    if (!self->runs[partition])
+    {
+      self->runs[partition] = tmpfile();
+      if (!self->runs[partition])
+      {
+        free(ends);
+        return false;
+      }
+    }
+  }
+  for (size_t n = 0; n < self->partition_count; ++n)
+  {
+    ends[n] = self->runs[n] ? ftell(self->runs[n]) : 0;
+    if (ends[n] < 0)
+    {
+      free(ends);
+      return false;
+    }
+  }
+
+  bool written = true;
+  size_t count = 0;
+  p = cc_map_begin(self->memory);
+  for (; written && cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+  {
+    cc_map_key_value_t kv = cc_map_iterator_dereference(p);
+    FILE* run = self->runs[_cc_spill_map_partition(self, kv.key)];
+    written = _cc_spill_map_write(self, run, kv.key, kv.value);
+    ++count;
+  }
+  for (size_t n = 0; n < self->partition_count; ++n)
+  {
+    if (self->runs[n] && fflush(self->runs[n]) != 0)
+    {
+      written = false;
+    }
+  }
+
+  if (!written)
+  {
+    for (size_t n = 0; n < self->partition_count; ++n)
+    {
+      FILE* run = self->runs[n];
+      if (run)
+      {
+        // Seeking pushes out anything still buffered, then the file is cut
+        // back to where this spill started.
+        clearerr(run);
+        fseek(run, ends[n], SEEK_SET);
+        ftruncate(fileno(run), ends[n]);
+      }
+    }
+    free(ends);
+    return false;
+  }
+  free(ends);
+  self->spilled += count;
+
+  // Start over with a small table, so the memory actually goes back.
+  struct cc_map* memory = _cc_spill_map_new_table(self);
+  if (memory)
+  {
+    cc_map_delete(self->memory);
+    self->memory = memory;
+  }
+  else
+  {
+    cc_map_clear(self->memory);
+  }
+  _cc_spill_map_drop_cache(self);
+  return true;
+}
+
+struct cc_map*
+cc_spill_map_load_partition(struct cc_spill_map* self, size_t partition)
+{
+  if (!self || partition >= self->partition_count)
+  {
+    return NULL;
+  }
+
+  struct cc_map* map = _cc_spill_map_new_table(self);
+  if (!map)
+  {
+    return NULL;
+  }
+
+  FILE* run = self->runs[partition];
+  if (run)
+  {
+    void* record = malloc(self->key_size + self->value_size);
+    if (!record)
+    {
+      cc_map_delete(map);
+      return NULL;
+    }
+
+    // Records are replayed in the order they were spilled, so later values
+    // replace (or are combined into) earlier ones.
+    void* key = record;
+    void* value = (char*) record + self->key_size;
+    rewind(run);
+    while (_cc_spill_map_read(self, run, key, value))
+    {
+      _cc_spill_map_add(self, map, key, value);
+    }
+    fseek(run, 0, SEEK_END);
+
+    free(record);
+  }
+
+  // Entries still in memory are newer than anything on disk.
+  cc_map_iterator_t p = cc_map_begin(self->memory);
+  cc_map_iterator_t e = cc_map_end(self->memory);
+  for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+  {
+    cc_map_key_value_t kv = cc_map_iterator_dereference(p);
+    if (_cc_spill_map_partition(self, kv.key) == partition)
+    {
+      _cc_spill_map_add(self, map, kv.key, kv.value);
+    }
+  }
+
+  return map;
+}
+
+bool
+cc_spill_map_find(struct cc_spill_map* self, const void* key, void* value)
+{
+  if (!self || !key)
+  {
+    return false;
+  }
+
+  const void* found;
+  size_t partition = _cc_spill_map_partition(self, key);
+  if (!self->runs[partition])
+  {
+    found = cc_map_find(self->memory, key);
+  }
+  else
+  {
+    if (!self->cache || self->cached_partition != partition)
+    {
+      _cc_spill_map_drop_cache(self);
+      self->cache = cc_spill_map_load_partition(self, partition);
+      self->cached_partition = partition;
+    }
+    found = cc_map_find(self->cache, key);
+  }
+
+  if (found && value)
+  {
+    self->value_functions.copier(value, found, self->value_size);
+  }
+  return found != NULL;
+}
+
+bool
+cc_spill_map_contains(struct cc_spill_map* self, const void* key)
+{
+  return cc_spill_map_find(self, key, NULL);
+}
+
+void
+cc_spill_map_for_each(struct cc_spill_map* self,
+                      cc_spill_map_visit_fn visit,
+                      void* arg)
+{
+  if (self && visit)
+  {
+    for (size_t n = 0; n < self->partition_count; ++n)
+    {
+      struct cc_map* map = cc_spill_map_load_partition(self, n);
+      if (!map)
+      {
+        continue;
+      }
+
+      cc_map_iterator_t p = cc_map_begin(map);
+      cc_map_iterator_t e = cc_map_end(map);
+      for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+      {
+        cc_map_key_value_t kv = cc_map_iterator_dereference(p);
+        visit(kv.key, kv.value, arg);
+      }
+
+      cc_map_delete(map);
+    }
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#ifndef CC_SPILL_MAP_H
+#define CC_SPILL_MAP_H
+
+#include <stdio.h>
+#include "cc_map.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+// A map that keeps at most memory_budget bytes of table in memory.  When the
+// budget is exceeded, the in-memory entries are appended to one temporary run
+// file per hash partition and the table is emptied.  Lookups and iteration
+// rebuild one partition at a time.  Keys and values are written to disk
+// byte-for-byte, so they must not own pointers.
+struct cc_spill_map
+{
+  size_t key_size;
+  size_t value_size;
+  size_t memory_budget;
+  size_t partition_count;
+  unsigned int partition_bits;
+  size_t spilled;
+  struct cc_functions key_functions;
+  struct cc_functions value_functions;
+  void (*combine)(void* existing, const void* value, void* arg);
+  void* combine_arg;
+  struct cc_map* memory;
+  FILE** runs;
+  size_t cached_partition;
+  struct cc_map* cache;
+};
+
+typedef struct cc_spill_map* cc_spill_map_t;
+
+typedef void (*cc_spill_map_combine_fn)(void* existing,
+                                        const void* value,
+                                        void* arg);
+
+typedef void (*cc_spill_map_visit_fn)(const void* key, void* value, void* arg);
+
+struct cc_spill_map*
+cc_spill_map_new(size_t key_size, size_t value_size, size_t memory_budget);
+
+struct cc_spill_map*
+cc_spill_map_new_f(size_t key_size,
+                   size_t value_size,
+                   size_t memory_budget,
+                   size_t partition_count,
+                   const struct cc_functions key_functions,
+                   const struct cc_functions value_functions);
+
+void
+cc_spill_map_delete(struct cc_spill_map* self);
+
+void
+cc_spill_map_set_combiner(struct cc_spill_map* self,
+                          cc_spill_map_combine_fn combine,
+                          void* arg);
+
+size_t
+cc_spill_map_partition_count(const struct cc_spill_map* self);
+
+size_t
+cc_spill_map_memory_size(const struct cc_spill_map* self);
+
+size_t
+cc_spill_map_spilled(const struct cc_spill_map* self);
+
+void
+cc_spill_map_clear(struct cc_spill_map* self);
+
+void
+cc_spill_map_insert(struct cc_spill_map* self,
+                    const void* key,
+                    const void* value);
+
+// Moves the in-memory entries to their run files.  Returns false, keeping
+// every entry in memory, if a run file cannot be created or written.
+bool
+cc_spill_map_spill(struct cc_spill_map* self);
+
+bool
+cc_spill_map_find(struct cc_spill_map* self, const void* key, void* value);
+
+bool
+cc_spill_map_contains(struct cc_spill_map* self, const void* key);
+
+struct cc_map*
+cc_spill_map_load_partition(struct cc_spill_map* self, size_t partition);
+
+void
+cc_spill_map_for_each(struct cc_spill_map* self,
+                      cc_spill_map_visit_fn visit,
+                      void* arg);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // CC_SPILL_MAP_H
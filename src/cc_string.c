@@ -8,7 +8,6 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include "cc_string.h"
@@ -21,15 +20,20 @@ const struct cc_functions cc_string_functions = (struct cc_functions){
   .hasher = cc_string_hasher,
   .copier = cc_string_copier,
   .deleter = cc_string_deleter,
-  .equality = cc_string_equality
+  .equality = cc_string_equality,
+  .seeded_hasher = cc_string_seeded_hasher,
+  .relocator = cc_default_relocator
 };
 
 size_t
 _cc_string_capacity(size_t requested)
 {
-  double fraction = 1.0 * (requested < 16 ? 16 : requested + 1);
-  size_t exponent = lround(ceil(log2(fraction)));
-  return (1 << exponent) - 1;
+  size_t capacity = 16;
+  while (capacity <= requested && capacity <= SIZE_MAX / 2)
+  {
+    capacity <<= 1;
+  }
+  return capacity - 1;
 }
 
 char*
@@ -54,6 +58,13 @@ cc_string_hasher(const void* buffer, size_t size)
   return cc_default_hasher(self->data, self->size);
 }
 
+uint64_t
+cc_string_seeded_hasher(const void* buffer, size_t size, uint64_t seed)
+{
+  const struct cc_string* self = (const struct cc_string*) buffer;
+  return cc_default_seeded_hasher(self->data, self->size, seed);
+}
+
 void*
 cc_string_copier(void* dest, const void* src, size_t size)
 {
@@ -109,6 +120,21 @@ cc_string_equality(const void* left, const void* right, size_t size)
       && strncmp(self->data, other->data, self->size) == 0;
 }
 
+int
+cc_string_comparator(const void* left, const void* right, size_t size)
+{
+  const struct cc_string* self = (const struct cc_string*) left;
+  const struct cc_string* other = (const struct cc_string*) right;
+
+  size_t count = self->size < other->size ? self->size : other->size;
+  int result = memcmp(self->data, other->data, count);
+  if (result != 0)
+  {
+    return result;
+  }
+  return (self->size > other->size) - (self->size < other->size);
+}
+
 struct cc_string*
 cc_string_new()
 {
@@ -160,6 +186,28 @@ cc_string_from_chars(const char* s, size_t count)
   return self;
 }
 
+struct cc_string*
+cc_string_adopt(char* data, size_t count, size_t capacity)
+{
+  if (!data || count > capacity)
+  {
+    return NULL;
+  }
+
+  void* buffer = malloc(sizeof(struct cc_string));
+  struct cc_string* self = (struct cc_string*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+  memset(data + count, 0, capacity - count + 1);
+
+  self->size = count;
+  self->capacity = capacity;
+  self->data = data;
+  return self;
+}
+
 struct cc_string*
 cc_string_copy(const struct cc_string* other)
 {
@@ -193,6 +241,33 @@ cc_string_delete(struct cc_string* self)
   free(self);
 }
 
+char*
+cc_string_release(struct cc_string* self)
+{
+  if (self)
+  {
+    // Leave behind an empty string with a buffer of its own, as from
+    // cc_string_new(), so that the string remains usable.
+    size_t capacity = _cc_string_capacity(0);
+    char* data = (char*) malloc(capacity + 1);
+    if (!data)
+    {
+      return NULL;
+    }
+    memset(data, 0, capacity + 1);
+
+    char* released = self->data;
+    self->size = 0;
+    self->capacity = capacity;
+    self->data = data;
+    return released;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
 void
 cc_string_assign(struct cc_string* self, size_t count, char ch)
 {
@@ -45,6 +45,9 @@ extern const struct cc_functions cc_string_functions;
 uint64_t
 cc_string_hasher(const void* buffer, size_t size);
 
+uint64_t
+cc_string_seeded_hasher(const void* buffer, size_t size, uint64_t seed);
+
 void*
 cc_string_copier(void* dest, const void* src, size_t size);
 
@@ -54,18 +57,30 @@ cc_string_deleter(void* ptr);
 bool
 cc_string_equality(const void* left, const void* right, size_t size);
 
+int
+cc_string_comparator(const void* left, const void* right, size_t size);
+
 struct cc_string*
 cc_string_new();
 
 struct cc_string*
 cc_string_from_chars(const char* s, size_t count);
 
+// An adopted buffer must come from malloc() and hold capacity + 1 bytes, the
+// first count of which are the string.  A released buffer is terminated by a
+// null character and becomes the caller's to free.
+struct cc_string*
+cc_string_adopt(char* data, size_t count, size_t capacity);
+
 struct cc_string*
 cc_string_copy(const struct cc_string* other);
 
 void
 cc_string_delete(struct cc_string* self);
 
+char*
+cc_string_release(struct cc_string* self);
+
 void
 cc_string_assign(struct cc_string* self, size_t count, char ch);
 
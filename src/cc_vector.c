@@ -8,7 +8,6 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include "cc_vector.h"
@@ -19,19 +18,145 @@ const struct cc_functions cc_vector_functions = (struct cc_functions){
   .hasher = cc_vector_hasher,
   .copier = cc_vector_copier,
   .deleter = cc_vector_deleter,
-  .equality = cc_vector_equality
+  .equality = cc_vector_equality,
+  .relocator = cc_vector_relocator
 };
 
+const size_t _cc_vector_default_growth = 100;
+
+// Inline elements start at the first 16-byte boundary after the header.
+const size_t _cc_vector_header = (sizeof(struct cc_vector) + 15) & ~(size_t) 15;
+
+void*
+_cc_vector_inline(const struct cc_vector* self)
+{
+  return self->inline_capacity > 0 ? (void*) self + _cc_vector_header : NULL;
+}
+
+bool
+_cc_vector_is_inline(const struct cc_vector* self)
+{
+  return self->inline_capacity > 0 && self->data == _cc_vector_inline(self);
+}
+
+void
+_cc_vector_relocate_to(struct cc_vector* self, void* data)
+{
+  size_t elem_size = self->element_size;
+  if (self->size == 0)
+  {
+    return;
+  }
+  else if (self->functions.relocator == cc_default_relocator)
+  {
+    memcpy(data, self->data, self->size * elem_size);
+  }
+  else
+  {
+    for (size_t n = 0, offset = 0; n < self->size; ++n, offset += elem_size)
+    {
+      cc_relocate(
+          &self->functions,
+          data + offset,
+          self->data + offset,
+          elem_size
+        );
+    }
+  }
+}
+
+bool
+_cc_vector_reallocate(struct cc_vector* self, size_t capacity)
+{
+  void* storage = _cc_vector_inline(self);
+  void* data;
+  if (capacity <= self->inline_capacity)
+  {
+    // Small enough for the inline storage (or, for an ordinary vector, no
+    // storage at all).
+    capacity = self->inline_capacity;
+    data = storage;
+  }
+  else if (self->functions.relocator == cc_default_relocator
+           && self->data != storage)
+  {
+    data = realloc(self->data, capacity * self->element_size);
+    if (!data)
+    {
+      return false;
+    }
+    self->data = data;
+  }
+  else
+  {
+    data = malloc(capacity * self->element_size);
+    if (!data)
+    {
+      return false;
+    }
+  }
+
+  if (data != self->data)
+  {
+    _cc_vector_relocate_to(self, data);
+    if (self->data != storage)
+    {
+      free(self->data);
+    }
+  }
+
+  self->capacity = capacity;
+  self->data = data;
+  return true;
+}
+
+bool
+_cc_vector_spill(struct cc_vector* self)
+{
+  // Move inline elements to the heap, for operations that hand the buffer
+  // to another vector or to the caller.
+  if (_cc_vector_is_inline(self))
+  {
+    void* data = malloc(self->capacity * self->element_size);
+    if (!data)
+    {
+      return false;
+    }
+    _cc_vector_relocate_to(self, data);
+    self->data = data;
+  }
+  return true;
+}
+
+void
+_cc_vector_move(struct cc_vector* self, size_t dest, size_t src, size_t count)
+{
+  // Relocate a range of elements within the buffer.
+  size_t elem_size = self->element_size;
+  cc_relocate_range(
+      &self->functions,
+      self->data + dest * elem_size,
+      self->data + src * elem_size,
+      count,
+      elem_size
+    );
+}
+
 void
 _cc_vector_grow_as_needed(struct cc_vector* self, size_t requested)
 {
   if (requested > self->capacity)
   {
-    size_t current = self->capacity == 0 ? 1 : self->capacity;
-    double fraction = 1.0 * requested / current;
-    size_t exponent = lround(ceil(log2(fraction)));
-    size_t capacity = current * (1 << exponent);
-    cc_vector_reserve(self, capacity);
+    size_t capacity = self->capacity;
+    size_t step = self->growth > 0 && capacity > SIZE_MAX / self->growth
+                ? SIZE_MAX - capacity
+                : capacity * self->growth / 100;
+    capacity = step < SIZE_MAX - capacity ? capacity + step : SIZE_MAX;
+    if (self->element_size > 0 && capacity > SIZE_MAX / self->element_size)
+    {
+      capacity = requested;
+    }
+    cc_vector_reserve(self, capacity > requested ? capacity : requested);
   }
 }
 
@@ -61,10 +186,24 @@ cc_vector_copier(void* dest, const void* src, size_t size)
     struct cc_vector* self = (struct cc_vector*) dest;
     const struct cc_vector* other = (const struct cc_vector*) src;
 
-    void* data = malloc(other->size * other->element_size);
-    if (!data)
+    // Whatever room the destination has past the header is inline storage.
+    size_t room = 0;
+    if (size > _cc_vector_header && other->element_size > 0)
     {
-      return NULL;
+      room = (size - _cc_vector_header) / other->element_size;
+    }
+
+    self->inline_capacity = room;
+    void* data = _cc_vector_inline(self);
+    size_t capacity = room;
+    if (other->size > room)
+    {
+      data = malloc(other->capacity * other->element_size);
+      capacity = other->capacity;
+      if (!data)
+      {
+        return NULL;
+      }
     }
 
     void* a = data;
@@ -77,8 +216,9 @@ cc_vector_copier(void* dest, const void* src, size_t size)
     }
 
     self->size = other->size;
-    self->capacity = other->capacity;
+    self->capacity = capacity;
     self->element_size = other->element_size;
+    self->growth = other->growth;
     self->functions = other->functions;
     self->data = data;
 
@@ -90,6 +230,19 @@ cc_vector_copier(void* dest, const void* src, size_t size)
   }
 }
 
+void*
+cc_vector_relocator(void* dest, void* src, size_t size)
+{
+  struct cc_vector* self = (struct cc_vector*) dest;
+  bool relocated = _cc_vector_is_inline((const struct cc_vector*) src);
+  memcpy(dest, src, size);
+  if (relocated)
+  {
+    self->data = _cc_vector_inline(self);
+  }
+  return dest;
+}
+
 void
 cc_vector_deleter(void* ptr)
 {
@@ -105,11 +258,16 @@ cc_vector_deleter(void* ptr)
       deleter(data);
     }
 
-    free(self->data);
+    if (!_cc_vector_is_inline(self))
+    {
+      free(self->data);
+    }
 
     self->size = 0;
     self->capacity = 0;
     self->element_size = 0;
+    self->growth = _cc_vector_default_growth;
+    self->inline_capacity = 0;
     self->functions = cc_default_functions;
     self->data = NULL;
   }
@@ -179,6 +337,8 @@ cc_vector_new_f(size_t element_size, const struct cc_functions functions)
   self->size = 0;
   self->capacity = 0;
   self->element_size = element_size;
+  self->growth = _cc_vector_default_growth;
+  self->inline_capacity = 0;
   self->functions = functions;
   self->data = NULL;
 
@@ -214,7 +374,80 @@ cc_vector_from_array_f(const void* data,
   self->size = count;
   self->capacity = count;
   self->element_size = element_size;
+  self->growth = _cc_vector_default_growth;
+  self->inline_capacity = 0;
+  self->functions = functions;
+
+  return self;
+}
+
+size_t
+cc_small_vector_sizeof(size_t element_size, size_t count)
+{
+  // Round up so that arrays of small vectors keep their headers aligned.
+  return (_cc_vector_header + count * element_size + 15) & ~(size_t) 15;
+}
+
+struct cc_vector*
+cc_small_vector_new(size_t element_size, size_t count)
+{
+  return cc_small_vector_new_f(element_size, count, cc_default_functions);
+}
+
+struct cc_vector*
+cc_small_vector_new_f(size_t element_size,
+                      size_t count,
+                      const struct cc_functions functions)
+{
+  if (element_size > 0 && count > (SIZE_MAX / 2) / element_size)
+  {
+    return NULL;
+  }
+
+  void* buffer = malloc(cc_small_vector_sizeof(element_size, count));
+  struct cc_vector* self = (struct cc_vector*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->size = 0;
+  self->capacity = count;
+  self->element_size = element_size;
+  self->growth = _cc_vector_default_growth;
+  self->inline_capacity = count;
+  self->functions = functions;
+  self->data = _cc_vector_inline(self);
+
+  return self;
+}
+
+struct cc_vector*
+cc_vector_adopt(void* data,
+                size_t count,
+                size_t capacity,
+                size_t element_size,
+                const struct cc_functions functions)
+{
+  if (count > capacity || (!data && capacity > 0))
+  {
+    return NULL;
+  }
+
+  void* buffer = malloc(sizeof(struct cc_vector));
+  struct cc_vector* self = (struct cc_vector*) buffer;
+  if (!self)
+  {
+    return NULL;
+  }
+
+  self->size = count;
+  self->capacity = capacity;
+  self->element_size = element_size;
+  self->growth = _cc_vector_default_growth;
+  self->inline_capacity = 0;
   self->functions = functions;
+  self->data = data;
 
   return self;
 }
@@ -224,14 +457,18 @@ cc_vector_copy(const struct cc_vector* other)
 {
   if (other)
   {
-    void* buffer = malloc(sizeof(struct cc_vector));
+    size_t size = cc_small_vector_sizeof(
+        other->element_size,
+        other->inline_capacity
+      );
+    void* buffer = malloc(size);
     struct cc_vector* self = (struct cc_vector*) buffer;
     if (!self)
     {
       return NULL;
     }
 
-    if (!cc_vector_copier(self, other, sizeof(struct cc_vector)))
+    if (!cc_vector_copier(self, other, size))
     {
       free(self);
       return NULL;
@@ -252,6 +489,23 @@ cc_vector_delete(struct cc_vector* self)
   free(self);
 }
 
+void*
+cc_vector_release(struct cc_vector* self)
+{
+  if (self && _cc_vector_spill(self))
+  {
+    void* data = self->data;
+    self->size = 0;
+    self->capacity = self->inline_capacity;
+    self->data = _cc_vector_inline(self);
+    return data;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
 void
 cc_vector_assign(struct cc_vector* self, size_t count, const void* value)
 {
@@ -389,24 +643,15 @@ cc_vector_reserve(struct cc_vector* self, size_t new_cap)
 {
   if (self && new_cap > self->capacity)
   {
-    void* data = malloc(new_cap * self->element_size);
-    if (!data)
+    if (self->element_size > 0 && new_cap > SIZE_MAX / self->element_size)
     {
       return;
     }
 
-    size_t elem_size = self->element_size;
-    cc_copy_fn copier = self->functions.copier;
-    cc_delete_fn deleter = self->functions.deleter;
-    for (size_t n = 0, offset = 0; n < self->size; ++n, offset += elem_size)
+    if (_cc_vector_reallocate(self, new_cap))
     {
-      copier(data + offset, self->data + offset, elem_size);
-      deleter(self->data + offset);
+      cc_advise_huge_pages(self->data, new_cap * self->element_size);
     }
-    free(self->data);
-
-    self->capacity = new_cap;
-    self->data = data;
   }
 }
 
@@ -423,63 +668,110 @@ cc_vector_capacity(const struct cc_vector* self)
   }
 }
 
+size_t
+cc_vector_growth(const struct cc_vector* self)
+{
+  if (self)
+  {
+    return self->growth;
+  }
+  else
+  {
+    return 0;
+  }
+}
+
+void
+cc_vector_set_growth(struct cc_vector* self, size_t percent)
+{
+  if (self)
+  {
+    self->growth = percent;
+  }
+}
+
 void
 cc_vector_shrink_to_fit(struct cc_vector* self)
 {
   if (self && self->capacity > self->size)
   {
-    void* data = malloc(self->size * self->element_size);
-    if (!data)
+    _cc_vector_reallocate(self, self->size);
+  }
+}
+
+void
+cc_vector_clear(struct cc_vector* self)
+{
+  if (self)
+  {
+    self->size = 0;
+  }
+}
+
+void
+cc_vector_insert(struct cc_vector* self, size_t pos, const void* value)
+{
+  cc_vector_insert_range(self, pos, value, 1);
+}
+
+void
+cc_vector_insert_range(struct cc_vector* self,
+                       size_t pos,
+                       const void* values,
+                       size_t count)
+{
+  if (self && values && count > 0 && pos <= self->size)
+  {
+    if (count > SIZE_MAX - self->size)
+    {
+      return;
+    }
+    size_t size = self->size + count;
+    _cc_vector_grow_as_needed(self, size);
+    if (self->capacity < size)
     {
       return;
     }
 
+    _cc_vector_move(self, pos + count, pos, self->size - pos);
+
     size_t elem_size = self->element_size;
     cc_copy_fn copier = self->functions.copier;
-    cc_delete_fn deleter = self->functions.deleter;
-    for (size_t n = 0, offset = 0; n < self->size; ++n, offset += elem_size)
+    void* dest = self->data + pos * elem_size;
+    for (size_t n = 0, offset = 0; n < count; ++n, offset += elem_size)
     {
-      copier(data + offset, self->data + offset, elem_size);
-      deleter(self->data + offset);
+      copier(dest + offset, values + offset, elem_size);
     }
-    free(self->data);
 
-    self->capacity = self->size;
-    self->data = data;
+    self->size = size;
   }
 }
 
 void
-cc_vector_clear(struct cc_vector* self)
+cc_vector_append_array(struct cc_vector* self,
+                       const void* values,
+                       size_t count)
 {
   if (self)
   {
-    self->size = 0;
+    cc_vector_insert_range(self, self->size, values, count);
   }
 }
 
 void
-cc_vector_insert(struct cc_vector* self, size_t pos, const void* value)
+cc_vector_append_vector(struct cc_vector* self,
+                        const struct cc_vector* other)
 {
-  if (self && pos <= self->size)
+  if (self && other && self->element_size == other->element_size)
   {
-    _cc_vector_grow_as_needed(self, self->size + 1);
-
-    size_t elem_size = self->element_size;
-    cc_copy_fn copier = self->functions.copier;
-    cc_delete_fn deleter = self->functions.deleter;
-    void* dest = self->data + self->size * self->element_size;
-    void* src = self->data + (self->size - 1) * self->element_size;
-    for (size_t n = pos; n < self->size; ++n)
+    // Grow first, since other may be self and its buffer may move.
+    size_t count = other->size;
+    if (count > SIZE_MAX - self->size)
     {
-      copier(dest, src, elem_size);
-      deleter(src);
-      dest -= elem_size;
-      src -= elem_size;
+      return;
     }
-    copier(self->data + pos * elem_size, value, elem_size);
-
-    self->size += 1;
+    _cc_vector_grow_as_needed(self, self->size + count);
+    cc_vector_insert_range(self, self->size, other->data, count);
   }
 }
 
@@ -493,22 +785,14 @@ cc_vector_erase(struct cc_vector* self, size_t first, size_t last)
 
     if (first < last)
     {
-      size_t n = first;
-      size_t offset = first * self->element_size;
       size_t elem_size = self->element_size;
       cc_delete_fn deleter = self->functions.deleter;
-      for (; n < last; ++n, offset += elem_size)
+      for (size_t n = first; n < last; ++n)
       {
-        deleter(self->data + offset);
+        deleter(self->data + n * elem_size);
       }
 
-      void* dest = self->data + first * elem_size;
-      const void* src = self->data + last * elem_size;
-      cc_copy_fn copier = self->functions.copier;
-      for (n = last, offset = 0; n < self->size; ++n, offset += elem_size)
-      {
-        copier(dest + offset, src + offset, elem_size);
-      }
+      _cc_vector_move(self, first, last, self->size - last);
 
       self->size -= last - first;
     }
@@ -531,6 +815,41 @@ cc_vector_push_back(struct cc_vector* self, const void* value)
   }
 }
 
+void*
+cc_vector_emplace(struct cc_vector* self, size_t pos)
+{
+  if (self && pos <= self->size && self->size < SIZE_MAX)
+  {
+    _cc_vector_grow_as_needed(self, self->size + 1);
+    if (self->capacity <= self->size)
+    {
+      return NULL;
+    }
+
+    _cc_vector_move(self, pos + 1, pos, self->size - pos);
+    self->size += 1;
+
+    return self->data + pos * self->element_size;
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
+void*
+cc_vector_emplace_back(struct cc_vector* self)
+{
+  if (self)
+  {
+    return cc_vector_emplace(self, self->size);
+  }
+  else
+  {
+    return NULL;
+  }
+}
+
 void
 cc_vector_pop_back(struct cc_vector* self)
 {
@@ -570,23 +889,27 @@ cc_vector_resize(struct cc_vector* self, size_t count, const void* value)
 void
 cc_vector_swap(struct cc_vector* self, struct cc_vector* other)
 {
-  if (self && other)
+  // Inline storage belongs to its header, so it cannot change hands.
+  if (self && other && _cc_vector_spill(self) && _cc_vector_spill(other))
   {
     size_t size = self->size;
     size_t capacity = self->capacity;
     size_t element_size = self->element_size;
+    size_t growth = self->growth;
     struct cc_functions functions = self->functions;
     void* data = self->data;
 
     self->size = other->size;
     self->capacity = other->capacity;
     self->element_size = other->element_size;
+    self->growth = other->growth;
     self->functions = other->functions;
     self->data = other->data;
 
     other->size = size;
     other->capacity = capacity;
     other->element_size = element_size;
+    other->growth = growth;
     other->functions = functions;
     other->data = data;
   }
@@ -17,11 +17,23 @@
 extern "C" {
 #endif
 
+// Vectors grow by a percentage of their capacity, set per vector with
+// cc_vector_set_growth().  Elements whose functions have the default
+// relocator are moved by realloc(), so a large vector can grow in place or
+// be remapped without copying; other elements are relocated one at a time.
+//
+// A small vector has room for inline_capacity elements directly after its
+// header, in a block of cc_small_vector_sizeof() bytes, and only moves its
+// elements to the heap when they outgrow that room.  It is otherwise an
+// ordinary vector.  Containers of vectors whose element size leaves room
+// after the header give each element inline storage of its own.
 struct cc_vector
 {
   size_t size;
   size_t capacity;
   size_t element_size;
+  size_t growth;
+  size_t inline_capacity;
   struct cc_functions functions;
   void* data;
 };
@@ -46,6 +58,9 @@ cc_vector_hasher(const void* buffer, size_t size);
 void*
 cc_vector_copier(void* dest, const void* src, size_t size);
 
+void*
+cc_vector_relocator(void* dest, void* src, size_t size);
+
 void
 cc_vector_deleter(void* ptr);
 
@@ -67,12 +82,36 @@ cc_vector_from_array_f(const void* data,
                        size_t element_size,
                        const struct cc_functions functions);
 
+size_t
+cc_small_vector_sizeof(size_t element_size, size_t count);
+
+struct cc_vector*
+cc_small_vector_new(size_t element_size, size_t count);
+
+struct cc_vector*
+cc_small_vector_new_f(size_t element_size,
+                      size_t count,
+                      const struct cc_functions functions);
+
+// Adopting takes ownership of a malloc'd buffer holding count initialized
+// elements and room for capacity; releasing hands the buffer and its
+// elements back to the caller and leaves the vector empty.
+struct cc_vector*
+cc_vector_adopt(void* data,
+                size_t count,
+                size_t capacity,
+                size_t element_size,
+                const struct cc_functions functions);
+
 struct cc_vector*
 cc_vector_copy(const struct cc_vector* other);
 
 void
 cc_vector_delete(struct cc_vector* self);
 
+void*
+cc_vector_release(struct cc_vector* self);
+
 void
 cc_vector_assign(struct cc_vector* self, size_t count, const void* value);
 
@@ -109,6 +148,12 @@ cc_vector_reserve(struct cc_vector* self, size_t new_cap);
 size_t
 cc_vector_capacity(const struct cc_vector* self);
 
+size_t
+cc_vector_growth(const struct cc_vector* self);
+
+void
+cc_vector_set_growth(struct cc_vector* self, size_t percent);
+
 void
 cc_vector_shrink_to_fit(struct cc_vector* self);
 
@@ -118,12 +163,35 @@ cc_vector_clear(struct cc_vector* self);
 void
 cc_vector_insert(struct cc_vector* self, size_t pos, const void* value);
 
+void
+cc_vector_insert_range(struct cc_vector* self,
+                       size_t pos,
+                       const void* values,
+                       size_t count);
+
+void
+cc_vector_append_array(struct cc_vector* self,
+                       const void* values,
+                       size_t count);
+
+void
+cc_vector_append_vector(struct cc_vector* self,
+                        const struct cc_vector* other);
+
 void
 cc_vector_erase(struct cc_vector* self, size_t first, size_t last);
 
 void
 cc_vector_push_back(struct cc_vector* self, const void* value);
 
+// Emplacing makes room for one element and returns its uninitialized storage,
+// which the caller must initialize before using the vector again.
+void*
+cc_vector_emplace(struct cc_vector* self, size_t pos);
+
+void*
+cc_vector_emplace_back(struct cc_vector* self);
+
 void
 cc_vector_pop_back(struct cc_vector* self);
 
@@ -0,0 +1,690 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+#include "vector.hpp"
+
+int
+iarray_comparator(const void* left, const void* right, size_t size)
+{
+  const iarray& l = *(const iarray*) left;
+  const iarray& r = *(const iarray*) right;
+  return l < r ? -1 : (r < l ? 1 : 0);
+}
+
+std::vector<int>
+random_ints(size_t count, int range)
+{
+  std::vector<int> x(count);
+  for (auto& value : x)
+  {
+    value = rand() % range;
+  }
+  return x;
+}
+
+void
+check_sort(const std::vector<int>& x, size_t threads)
+{
+  cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(int));
+  if (threads == 1)
+  {
+    cc_vector_sort(u, cc_int_comparator);
+  }
+  else
+  {
+    cc_vector_parallel_sort(u, cc_int_comparator, threads);
+  }
+  std::vector<int> y = x;
+  std::sort(y.begin(), y.end());
+  check_vector(u, y);
+  cc_vector_delete(u);
+}
+
+struct record
+{
+  uint32_t id;
+  int32_t small;
+  int64_t time;
+  double value;
+  float weight;
+  uint16_t tag;
+};
+
+bool
+operator==(const record& left, const record& right)
+{
+  return left.id == right.id;
+}
+
+std::vector<record>
+random_records(size_t count)
+{
+  std::vector<record> x(count);
+  for (size_t n = 0; n < count; ++n)
+  {
+    x[n].id = (uint32_t) n;
+    x[n].small = rand() % 200 - 100;
+    x[n].time = ((int64_t) rand() << 20) - ((int64_t) rand() << 30);
+    x[n].value = (rand() % 2000 - 1000) / 8.0;
+    x[n].weight = (float) (rand() % 100 - 50) / 4.0f;
+    x[n].tag = (uint16_t) (rand() % 1000);
+  }
+  if (count > 0)
+  {
+    x[0].value = -0.0;
+  }
+  return x;
+}
+
+template <class T>
+void
+check_radix_sort(const std::vector<record>& x,
+                 T record::* member,
+                 enum cc_radix_key type,
+                 size_t threads)
+{
+  cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(record));
+  CHECK(cc_vector_parallel_radix_sort(
+      u,
+      (size_t) &(((record*) nullptr)->*member),
+      sizeof(T),
+      type,
+      threads
+    ));
+  std::vector<record> y = x;
+  std::stable_sort(y.begin(), y.end(),
+                   [member](const record& a, const record& b) {
+                     return a.*member < b.*member;
+                   });
+  check_vector(u, y);
+  cc_vector_delete(u);
+}
+
+uint64_t
+record_key(const void* element, void* arg)
+{
+  const record* r = (const record*) element;
+  return (uint64_t) r->tag << 32 | (uint32_t) ~r->id;
+}
+
+uint64_t
+iarray_key(const void* element, void* arg)
+{
+  return (uint64_t) ((const iarray*) element)->data[0];
+}
+
+size_t comparisons = 0;
+
+int
+record_comparator(const void* left, const void* right, size_t size)
+{
+  ++comparisons;
+  const record* l = (const record*) left;
+  const record* r = (const record*) right;
+  return (l->tag > r->tag) - (l->tag < r->tag);
+}
+
+void
+check_stable_sort(const std::vector<record>& x)
+{
+  cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(record));
+  cc_vector_stable_sort(u, record_comparator);
+  std::vector<record> y = x;
+  std::stable_sort(y.begin(), y.end(),
+                   [](const record& a, const record& b) {
+                     return a.tag < b.tag;
+                   });
+  check_vector(u, y);
+  cc_vector_delete(u);
+}
+
+int
+slow_int_comparator(const void* left, const void* right, size_t size)
+{
+  return cc_int_comparator(left, right, size);
+}
+
+typedef bool (*set_fn)(const cc_vector*, const cc_vector*, cc_compare_fn,
+                       cc_vector*);
+
+template <class T, class F>
+void
+check_set_operations(std::vector<T> x,
+                     std::vector<T> y,
+                     cc_compare_fn compare,
+                     F expected)
+{
+  std::sort(x.begin(), x.end());
+  std::sort(y.begin(), y.end());
+  cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(T));
+  cc_vector_t v = cc_vector_from_array(y.data(), y.size(), sizeof(T));
+  cc_vector_t w = cc_vector_from_array(x.data(), x.size() / 2, sizeof(T));
+  std::vector<std::pair<set_fn, int>> operations = {
+    { cc_vector_merge, 0 },
+    { cc_vector_set_union, 1 },
+    { cc_vector_set_intersection, 2 },
+    { cc_vector_set_difference, 3 }
+  };
+  for (auto& operation : operations)
+  {
+    CHECK(operation.first(u, v, compare, w));
+    check_vector(w, expected(x, y, operation.second));
+  }
+  cc_vector_delete(w);
+  cc_vector_delete(v);
+  cc_vector_delete(u);
+}
+
+template <class T>
+std::vector<T>
+set_operation(const std::vector<T>& x, const std::vector<T>& y, int which)
+{
+  std::vector<T> z;
+  auto out = std::back_inserter(z);
+  switch (which)
+  {
+    case 0:
+      std::merge(x.begin(), x.end(), y.begin(), y.end(), out);
+      break;
+    case 1:
+      std::set_union(x.begin(), x.end(), y.begin(), y.end(), out);
+      break;
+    case 2:
+      std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), out);
+      break;
+    default:
+      std::set_difference(x.begin(), x.end(), y.begin(), y.end(), out);
+      break;
+  }
+  return z;
+}
+
+TEST_SUITE("algorithms")
+{
+  TEST_CASE("sort")
+  {
+    srand(46);
+
+    SUBCASE("short")
+    {
+      check_sort({ }, 1);
+      check_sort({ 3 }, 1);
+      check_sort({ 2, 1 }, 1);
+      check_sort({ 5, 1, 4, 1, 5, 9, 2, 6, 5, 3 }, 1);
+    }
+
+    SUBCASE("random")
+    {
+      check_sort(random_ints(1000, 1000000), 1);
+      check_sort(random_ints(1000, 4), 1);
+    }
+
+    SUBCASE("ordered")
+    {
+      std::vector<int> x(1000);
+      for (int n = 0; n < 1000; ++n)
+      {
+        x[n] = n;
+      }
+      check_sort(x, 1);
+      std::reverse(x.begin(), x.end());
+      check_sort(x, 1);
+      check_sort(std::vector<int>(1000, 7), 1);
+    }
+
+    SUBCASE("deep")
+    {
+      std::vector<std::vector<int>> values;
+      for (int n = 0; n < 200; ++n)
+      {
+        values.push_back(random_ints(rand() % 4 + 1, 10));
+      }
+      cc_vector_t u = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      std::vector<iarray> y;
+      for (auto& value : values)
+      {
+        iarray a = { value.size(), value.data() };
+        cc_vector_push_back(u, &a);
+        y.push_back(a);
+      }
+      cc_vector_sort(u, iarray_comparator);
+      std::sort(y.begin(), y.end());
+      check_vector(u, y);
+      cc_vector_delete(u);
+    }
+  }
+
+  TEST_CASE("parallel sort")
+  {
+    srand(64);
+
+    SUBCASE("short")
+    {
+      check_sort({ }, 4);
+      check_sort({ 2, 1 }, 4);
+      check_sort(random_ints(1000, 100), 4);
+    }
+
+    SUBCASE("random")
+    {
+      check_sort(random_ints(100000, 1000000), 4);
+      check_sort(random_ints(100001, 16), 3);
+      check_sort(random_ints(50000, 1000000), 0);
+    }
+
+    SUBCASE("ordered")
+    {
+      std::vector<int> x(40000);
+      for (int n = 0; n < 40000; ++n)
+      {
+        x[n] = 40000 - n;
+      }
+      check_sort(x, 4);
+      std::reverse(x.begin(), x.end());
+      check_sort(x, 4);
+    }
+
+    SUBCASE("deep")
+    {
+      std::vector<int> values = random_ints(20000, 1000);
+      cc_vector_t u = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      std::vector<iarray> y;
+      for (auto& value : values)
+      {
+        iarray a = { 1, &value };
+        cc_vector_push_back(u, &a);
+        y.push_back(a);
+      }
+      cc_vector_parallel_sort(u, iarray_comparator, 2);
+      std::sort(y.begin(), y.end());
+      check_vector(u, y);
+      cc_vector_delete(u);
+    }
+  }
+
+  TEST_CASE("radix sort")
+  {
+    srand(47);
+    std::vector<record> x = random_records(3000);
+
+    SUBCASE("keys")
+    {
+      check_radix_sort(x, &record::id, CC_RADIX_UNSIGNED, 1);
+      check_radix_sort(x, &record::small, CC_RADIX_SIGNED, 1);
+      check_radix_sort(x, &record::time, CC_RADIX_SIGNED, 1);
+      check_radix_sort(x, &record::value, CC_RADIX_FLOAT, 1);
+      check_radix_sort(x, &record::weight, CC_RADIX_FLOAT, 1);
+      check_radix_sort(x, &record::tag, CC_RADIX_UNSIGNED, 1);
+    }
+
+    SUBCASE("key function")
+    {
+      cc_vector_t u = cc_vector_from_array(x.data(), x.size(),
+                                           sizeof(record));
+      CHECK(cc_vector_radix_sort_by(u, record_key, nullptr));
+      std::vector<record> y = x;
+      std::sort(y.begin(), y.end(), [](const record& a, const record& b) {
+        return a.tag < b.tag || (a.tag == b.tag && a.id > b.id);
+      });
+      check_vector(u, y);
+      cc_vector_delete(u);
+    }
+
+    SUBCASE("invalid keys")
+    {
+      cc_vector_t u = cc_vector_from_array(x.data(), 10, sizeof(record));
+      CHECK(!cc_vector_radix_sort(u, 0, 3, CC_RADIX_UNSIGNED));
+      CHECK(!cc_vector_radix_sort(u, 0, 2, CC_RADIX_FLOAT));
+      CHECK(!cc_vector_radix_sort(u, sizeof(record) - 4, 8,
+                                  CC_RADIX_SIGNED));
+      CHECK(!cc_vector_radix_sort_by(u, nullptr, nullptr));
+      CHECK(!cc_vector_radix_sort(nullptr, 0, 4, CC_RADIX_UNSIGNED));
+      check_vector(u, std::vector<record>(x.begin(), x.begin() + 10));
+      cc_vector_delete(u);
+    }
+
+    SUBCASE("short")
+    {
+      cc_vector_t u = cc_vector_new(sizeof(int));
+      CHECK(cc_vector_radix_sort(u, 0, sizeof(int), CC_RADIX_SIGNED));
+      int value = -3;
+      cc_vector_push_back(u, &value);
+      CHECK(cc_vector_radix_sort(u, 0, sizeof(int), CC_RADIX_SIGNED));
+      check_vector<int>(u, { -3 });
+      cc_vector_delete(u);
+    }
+
+    SUBCASE("parallel")
+    {
+      std::vector<record> z = random_records(50000);
+      check_radix_sort(z, &record::time, CC_RADIX_SIGNED, 4);
+      check_radix_sort(z, &record::value, CC_RADIX_FLOAT, 3);
+      check_radix_sort(z, &record::tag, CC_RADIX_UNSIGNED, 0);
+    }
+
+    SUBCASE("deep")
+    {
+      std::vector<int> values = random_ints(20000, 1000);
+      cc_vector_t u = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      std::vector<iarray> y;
+      for (auto& value : values)
+      {
+        iarray a = { 1, &value };
+        cc_vector_push_back(u, &a);
+        y.push_back(a);
+      }
+      CHECK(cc_vector_parallel_radix_sort_by(u, iarray_key, nullptr, 2));
+      std::stable_sort(y.begin(), y.end());
+      check_vector(u, y);
+      cc_vector_delete(u);
+    }
+  }
+
+  TEST_CASE("stable sort")
+  {
+    srand(48);
+
+    SUBCASE("short")
+    {
+      for (size_t n = 0; n < 70; ++n)
+      {
+        check_stable_sort(random_records(n));
+      }
+    }
+
+    SUBCASE("random")
+    {
+      std::vector<record> x = random_records(5000);
+      check_stable_sort(x);
+      for (auto& r : x)
+      {
+        r.tag %= 3;
+      }
+      check_stable_sort(x);
+    }
+
+    SUBCASE("runs")
+    {
+      std::vector<record> x = random_records(5000);
+      for (size_t n = 0; n < x.size(); ++n)
+      {
+        x[n].tag = (uint16_t) (n % 1000 < 500 ? n % 1000 : 5000 - n / 2);
+      }
+      check_stable_sort(x);
+      for (size_t n = 0; n < x.size(); ++n)
+      {
+        x[n].tag = (uint16_t) (n < 4000 ? 2 * n : 2 * n - 7999);
+      }
+      check_stable_sort(x);
+    }
+
+    SUBCASE("nearly sorted")
+    {
+      std::vector<record> x = random_records(10000);
+      for (size_t n = 0; n < x.size(); ++n)
+      {
+        x[n].tag = (uint16_t) (n / 2);
+      }
+      for (size_t n = 0; n < 20; ++n)
+      {
+        std::swap(x[rand() % x.size()].tag, x[rand() % x.size()].tag);
+      }
+      comparisons = 0;
+      check_stable_sort(x);
+      CHECK(comparisons < 2 * x.size());
+
+      std::reverse(x.begin(), x.end());
+      check_stable_sort(x);
+    }
+
+    SUBCASE("deep")
+    {
+      std::vector<int> values = random_ints(3000, 100);
+      for (size_t n = 1000; n < 2000; ++n)
+      {
+        values[n] = (int) n;
+      }
+      cc_vector_t u = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      std::vector<iarray> y;
+      for (auto& value : values)
+      {
+        iarray a = { 1, &value };
+        cc_vector_push_back(u, &a);
+        y.push_back(a);
+      }
+      cc_vector_stable_sort(u, iarray_comparator);
+      std::stable_sort(y.begin(), y.end());
+      check_vector(u, y);
+      cc_vector_delete(u);
+    }
+  }
+
+  TEST_CASE("selection")
+  {
+    srand(49);
+
+    SUBCASE("nth element")
+    {
+      for (int range : { 1000000, 5 })
+      {
+        std::vector<int> x = random_ints(2000, range);
+        std::vector<int> y = x;
+        std::sort(y.begin(), y.end());
+        for (size_t nth : { 0, 1, 17, 999, 1998, 1999 })
+        {
+          cc_vector_t u = cc_vector_from_array(x.data(), x.size(),
+                                               sizeof(int));
+          cc_vector_nth_element(u, nth, cc_int_comparator);
+          const int* data = (const int*) cc_vector_data(u);
+          CHECK(data[nth] == y[nth]);
+          CHECK(std::all_of(data, data + nth,
+                            [&](int v) { return v <= data[nth]; }));
+          CHECK(std::all_of(data + nth, data + x.size(),
+                            [&](int v) { return v >= data[nth]; }));
+          cc_vector_delete(u);
+        }
+      }
+    }
+
+    SUBCASE("partial sort")
+    {
+      std::vector<int> x = random_ints(3000, 1000);
+      std::vector<int> y = x;
+      std::sort(y.begin(), y.end());
+      for (size_t count : { 0, 1, 100, 2999, 3000, 4000 })
+      {
+        cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(int));
+        cc_vector_partial_sort(u, count, cc_int_comparator);
+        const int* data = (const int*) cc_vector_data(u);
+        size_t n = std::min(count, x.size());
+        CHECK(std::equal(data, data + n, y.begin()));
+        std::vector<int> z(data, data + x.size());
+        std::sort(z.begin(), z.end());
+        CHECK(z == y);
+        cc_vector_delete(u);
+      }
+    }
+
+    SUBCASE("top k")
+    {
+      std::vector<int> x = random_ints(5000, 100000);
+      std::vector<int> y = x;
+      std::sort(y.begin(), y.end());
+      cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(int));
+      cc_vector_t v = cc_vector_from_array(x.data(), 3, sizeof(int));
+      for (size_t k : { 0, 1, 100, 5000, 6000 })
+      {
+        CHECK(cc_vector_top_k(u, k, cc_int_comparator, v));
+        size_t n = std::min(k, x.size());
+        check_vector(v, std::vector<int>(y.begin(), y.begin() + n));
+      }
+      check_vector(u, x);
+
+      cc_vector_t w = cc_vector_new(sizeof(double));
+      CHECK(!cc_vector_top_k(u, 10, cc_int_comparator, w));
+      CHECK(!cc_vector_top_k(u, 10, cc_int_comparator, u));
+      cc_vector_delete(w);
+      cc_vector_delete(v);
+      cc_vector_delete(u);
+    }
+
+    SUBCASE("deep")
+    {
+      std::vector<int> values = random_ints(2000, 1000);
+      cc_vector_t u = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      std::vector<iarray> y;
+      for (auto& value : values)
+      {
+        iarray a = { 1, &value };
+        cc_vector_push_back(u, &a);
+        y.push_back(a);
+      }
+      std::sort(y.begin(), y.end());
+
+      cc_vector_t v = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      CHECK(cc_vector_top_k(u, 50, iarray_comparator, v));
+      check_vector(v, std::vector<iarray>(y.begin(), y.begin() + 50));
+      cc_vector_partial_sort(u, 50, iarray_comparator);
+      for (size_t n = 0; n < 50; ++n)
+      {
+        CHECK(iarray_equal(cc_vector_get(u, n), &y[n], 0));
+      }
+      cc_vector_nth_element(u, 1000, iarray_comparator);
+      CHECK(iarray_equal(cc_vector_get(u, 1000), &y[1000], 0));
+      cc_vector_delete(v);
+      cc_vector_delete(u);
+    }
+  }
+
+  TEST_CASE("binary search")
+  {
+    srand(50);
+    std::vector<int> x = random_ints(1000, 300);
+    std::sort(x.begin(), x.end());
+    cc_vector_t u = cc_vector_from_array(x.data(), x.size(), sizeof(int));
+    for (int value = -1; value <= 301; ++value)
+    {
+      for (cc_compare_fn compare : { cc_int_comparator, slow_int_comparator })
+      {
+        auto range = std::equal_range(x.begin(), x.end(), value);
+        size_t first = 0;
+        size_t last = 0;
+        cc_vector_equal_range(u, &value, compare, &first, &last);
+        CHECK(first == range.first - x.begin());
+        CHECK(last == range.second - x.begin());
+        CHECK(cc_vector_lower_bound(u, &value, compare) == first);
+        CHECK(cc_vector_upper_bound(u, &value, compare) == last);
+        CHECK(cc_vector_binary_search(u, &value, compare) == (first < last));
+      }
+    }
+    cc_vector_delete(u);
+
+    int value = 1;
+    cc_vector_t v = cc_vector_new(sizeof(int));
+    CHECK(cc_vector_lower_bound(v, &value, cc_int_comparator) == 0);
+    CHECK(!cc_vector_binary_search(v, &value, cc_int_comparator));
+    CHECK(!cc_vector_binary_search(nullptr, &value, cc_int_comparator));
+    cc_vector_delete(v);
+  }
+
+  TEST_CASE("set operations")
+  {
+    srand(51);
+
+    SUBCASE("ints")
+    {
+      for (cc_compare_fn compare : { cc_int_comparator, slow_int_comparator })
+      {
+        check_set_operations(random_ints(2000, 3000), random_ints(1500, 3000),
+                             compare, set_operation<int>);
+        check_set_operations(random_ints(300, 20), random_ints(500, 20),
+                             compare, set_operation<int>);
+        check_set_operations(random_ints(10, 100000),
+                             random_ints(5000, 100000),
+                             compare, set_operation<int>);
+        check_set_operations(random_ints(5000, 1000), random_ints(7, 1000),
+                             compare, set_operation<int>);
+        check_set_operations(random_ints(100, 10), std::vector<int>(),
+                             compare, set_operation<int>);
+        std::vector<int> x = random_ints(1000, 1000000);
+        for (auto& value : x)
+        {
+          value -= 500000;
+        }
+        check_set_operations(x, x, compare, set_operation<int>);
+      }
+    }
+
+    SUBCASE("wide integers")
+    {
+      std::vector<uint32_t> x;
+      std::vector<uint32_t> y;
+      std::vector<int64_t> z;
+      std::vector<uint64_t> w;
+      std::vector<uint64_t> v;
+      for (int n = 0; n < 3000; ++n)
+      {
+        x.push_back(UINT32_MAX - rand() % 5000);
+        y.push_back(UINT32_MAX - rand() % 5000);
+        z.push_back(((int64_t) rand() - RAND_MAX / 2) * 4294967296);
+        w.push_back((uint64_t) (rand() % 4000) << 40);
+        v.push_back((uint64_t) (rand() % 3) << 32 | (uint64_t) (rand() % 2000));
+      }
+      check_set_operations(x, y, cc_uint32_comparator,
+                           set_operation<uint32_t>);
+      check_set_operations(z, std::vector<int64_t>(z.begin(), z.begin() + 900),
+                           cc_int64_comparator, set_operation<int64_t>);
+      check_set_operations(w, std::vector<uint64_t>(w.rbegin(), w.rend()),
+                           cc_uint64_comparator, set_operation<uint64_t>);
+      std::vector<uint64_t> half(v.begin(), v.begin() + 1500);
+      check_set_operations(v, half, cc_uint64_comparator,
+                           set_operation<uint64_t>);
+    }
+
+    SUBCASE("deep")
+    {
+      std::vector<int> values = random_ints(600, 200);
+      std::vector<iarray> x;
+      std::vector<iarray> y;
+      for (size_t n = 0; n < values.size(); ++n)
+      {
+        iarray a = { 1, &values[n] };
+        (n % 3 ? x : y).push_back(a);
+      }
+      std::sort(x.begin(), x.end());
+      std::sort(y.begin(), y.end());
+      cc_vector_t u = cc_vector_from_array_f(x.data(), x.size(), sizeof(iarray),
+                                             iarray_functions);
+      cc_vector_t v = cc_vector_from_array_f(y.data(), y.size(), sizeof(iarray),
+                                             iarray_functions);
+      cc_vector_t w = cc_vector_new_f(sizeof(iarray), iarray_functions);
+      CHECK(cc_vector_merge(u, v, iarray_comparator, w));
+      check_vector(w, set_operation(x, y, 0));
+      CHECK(cc_vector_set_union(u, v, iarray_comparator, w));
+      check_vector(w, set_operation(x, y, 1));
+      CHECK(cc_vector_set_intersection(u, v, iarray_comparator, w));
+      check_vector(w, set_operation(x, y, 2));
+      CHECK(cc_vector_set_difference(u, v, iarray_comparator, w));
+      check_vector(w, set_operation(x, y, 3));
+
+      CHECK(!cc_vector_merge(u, v, iarray_comparator, u));
+      CHECK(!cc_vector_set_union(u, v, nullptr, w));
+      cc_vector_delete(w);
+      cc_vector_delete(v);
+      cc_vector_delete(u);
+    }
+  }
+}
@@ -0,0 +1,288 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+
+typedef std::vector<std::pair<std::string, int>> art_items;
+
+void
+collect_art(const void* key, size_t length, void* value, void* arg)
+{
+  auto items = (art_items*) arg;
+  items->emplace_back(std::string((const char*) key, length), *(int*) value);
+}
+
+void
+check_art(cc_art_t u, const std::map<std::string, int>& x)
+{
+  REQUIRE(cc_art_size(u) == x.size());
+  for (const auto& kv : x)
+  {
+    int* value = (int*) cc_art_find(u, kv.first.data(), kv.first.size());
+    REQUIRE(value != nullptr);
+    CHECK(*value == kv.second);
+  }
+
+  art_items items;
+  cc_art_for_each(u, collect_art, &items);
+  CHECK(items == art_items(x.begin(), x.end()));
+}
+
+std::string
+random_path()
+{
+  static const char* parts[] = {
+    "usr", "local", "share", "lib", "include", "x", "", "documentation"
+  };
+  std::string path;
+  int depth = rand() % 5;
+  for (int n = 0; n < depth; ++n)
+  {
+    path += "/";
+    path += parts[rand() % 8];
+  }
+  return path;
+}
+
+TEST_SUITE_BEGIN("adaptive radix trees");
+
+TEST_CASE("art construction")
+{
+  SUBCASE("empty tree")
+  {
+    cc_art_t u = cc_art_new(sizeof(int));
+    CHECK(cc_art_empty(u));
+    CHECK(cc_art_find(u, "a", 1) == nullptr);
+    CHECK(cc_art_longest_prefix(u, "a", 1, NULL) == nullptr);
+    check_art(u, { });
+    cc_art_delete(u);
+  }
+
+  SUBCASE("keys that prefix each other")
+  {
+    cc_art_t u = cc_art_new(sizeof(int));
+    std::map<std::string, int> x;
+    const char* keys[] = { "abcdefghijklmnop", "abc", "", "abcdefghijk", "b" };
+    for (int n = 0; n < 5; ++n)
+    {
+      cc_art_insert(u, keys[n], strlen(keys[n]), &n);
+      x[keys[n]] = n;
+    }
+    check_art(u, x);
+
+    cc_art_t v = cc_art_copy(u);
+    check_art(v, x);
+    cc_art_erase(v, "abc", 3);
+    cc_art_erase(v, "abcdefghijk", 11);
+    cc_art_erase(v, "abcdefgh", 8);
+    check_art(u, x);
+    x.erase("abc");
+    x.erase("abcdefghijk");
+    check_art(v, x);
+    cc_art_delete(u);
+    cc_art_delete(v);
+  }
+}
+
+TEST_CASE("art modification")
+{
+  cc_art_t u = cc_art_new(sizeof(int));
+  std::map<std::string, int> x;
+  srand(23);
+
+  SUBCASE("paths")
+  {
+    for (int n = 0; n < 20000; ++n)
+    {
+      std::string key = random_path();
+      if (rand() % 3 == 0)
+      {
+        cc_art_erase(u, key.data(), key.size());
+        x.erase(key);
+      }
+      else
+      {
+        cc_art_insert(u, key.data(), key.size(), &n);
+        x[key] = n;
+      }
+    }
+    check_art(u, x);
+  }
+
+  SUBCASE("wide nodes")
+  {
+    for (int n = 0; n < 256 * 20; ++n)
+    {
+      unsigned char key[3] = {
+        (unsigned char) (n % 256),
+        (unsigned char) 'k',
+        (unsigned char) (n / 256)
+      };
+      cc_art_insert(u, key, 3, &n);
+      x[std::string((const char*) key, 3)] = n;
+    }
+    check_art(u, x);
+    for (int n = 0; n < 256 * 20; n += 1 + n % 3)
+    {
+      unsigned char key[3] = {
+        (unsigned char) (n % 256),
+        (unsigned char) 'k',
+        (unsigned char) (n / 256)
+      };
+      cc_art_erase(u, key, 3);
+      x.erase(std::string((const char*) key, 3));
+    }
+    check_art(u, x);
+    for (int n = 0; n < 256 * 20; ++n)
+    {
+      unsigned char key[3] = {
+        (unsigned char) (n % 256),
+        (unsigned char) 'k',
+        (unsigned char) (n / 256)
+      };
+      if (key[0] >= 20)
+      {
+        cc_art_erase(u, key, 3);
+        x.erase(std::string((const char*) key, 3));
+      }
+    }
+    check_art(u, x);
+  }
+
+  SUBCASE("clear")
+  {
+    int value = 1;
+    cc_art_insert(u, "key", 3, &value);
+    cc_art_clear(u);
+    check_art(u, { });
+    cc_art_insert(u, "key", 3, &value);
+    check_art(u, { {"key", 1} });
+  }
+
+  cc_art_delete(u);
+}
+
+TEST_CASE("art prefix queries")
+{
+  cc_art_t u = cc_art_new(sizeof(int));
+  std::map<std::string, int> x;
+  srand(29);
+  for (int n = 0; n < 2000; ++n)
+  {
+    std::string key = random_path();
+    cc_art_insert(u, key.data(), key.size(), &n);
+    x[key] = n;
+  }
+
+  SUBCASE("prefix iteration")
+  {
+    for (int n = 0; n < 200; ++n)
+    {
+      std::string prefix = random_path();
+      prefix = prefix.substr(0, prefix.size() - rand() % 4 % (prefix.size() + 1));
+      art_items items;
+      cc_art_for_each_prefix(
+          u,
+          prefix.data(),
+          prefix.size(),
+          collect_art,
+          &items
+        );
+      art_items expected;
+      for (auto p = x.lower_bound(prefix); p != x.end(); ++p)
+      {
+        if (p->first.compare(0, prefix.size(), prefix) != 0)
+        {
+          break;
+        }
+        expected.push_back(*p);
+      }
+      CHECK(items == expected);
+    }
+  }
+
+  SUBCASE("longest prefix match")
+  {
+    for (int n = 0; n < 500; ++n)
+    {
+      std::string key = random_path() + random_path();
+      size_t best = std::string::npos;
+      for (size_t length = 0; length <= key.size(); ++length)
+      {
+        if (x.count(key.substr(0, length)))
+        {
+          best = length;
+        }
+      }
+
+      size_t length;
+      int* value = (int*) cc_art_longest_prefix(
+          u,
+          key.data(),
+          key.size(),
+          &length
+        );
+      if (best == std::string::npos)
+      {
+        CHECK(value == nullptr);
+      }
+      else
+      {
+        REQUIRE(value != nullptr);
+        CHECK(length == best);
+        CHECK(*value == x[key.substr(0, best)]);
+      }
+    }
+  }
+
+  cc_art_delete(u);
+}
+
+TEST_CASE("art with string keys and array values")
+{
+  int a[] = { 1, 2, 3 };
+  int b[] = { 4, 5 };
+  iarray values[] = { { 3, a }, { 2, b } };
+
+  cc_art_t u = cc_art_new_f(sizeof(iarray), iarray_functions);
+  cc_string_t key = cc_string_from_chars("/home/user", 10);
+  cc_art_insert_string(u, key, &values[0]);
+  cc_string_t path = cc_string_from_chars("/home/user/notes.txt", 20);
+  cc_art_insert_string(u, path, &values[1]);
+  cc_art_insert_string(u, path, &values[0]);
+
+  size_t length;
+  cc_string_t query = cc_string_from_chars("/home/user/src", 14);
+  void* found = cc_art_longest_prefix_string(u, query, &length);
+  CHECK(length == 10);
+  CHECK(iarray_equal(found, &values[0], 0));
+  CHECK(iarray_equal(cc_art_find_string(u, path), &values[0], 0));
+
+  cc_art_t v = cc_art_copy(u);
+  cc_art_erase_string(u, key);
+  CHECK(cc_art_find_string(u, key) == nullptr);
+  CHECK(iarray_equal(cc_art_find_string(v, key), &values[0], 0));
+
+  cc_string_delete(key);
+  cc_string_delete(path);
+  cc_string_delete(query);
+  cc_art_delete(u);
+  cc_art_delete(v);
+}
+
+TEST_SUITE_END();
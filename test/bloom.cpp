@@ -0,0 +1,173 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+TEST_SUITE_BEGIN("bloom filters");
+
+TEST_CASE("bloom filter sizing")
+{
+  cc_bloom_t u = cc_bloom_new(10000, 0.01);
+  CHECK(cc_bloom_hash_count(u) == 7);
+  CHECK(cc_bloom_block_count(u) * 512 >= 95850);
+  CHECK(cc_bloom_false_positive_rate(u) == 0.01);
+  cc_bloom_delete(u);
+
+  u = cc_bloom_new(0, 2.0);
+  CHECK(cc_bloom_block_count(u) == 1);
+  CHECK(cc_bloom_false_positive_rate(u) == 0.01);
+  cc_bloom_delete(u);
+
+  // The sizing rests on the library's own logarithm.
+  for (double x : { 1e-9, 0.3, 1.0, 1.5, 2.0, 100.0, 1e12 })
+  {
+    CHECK(cc_log(x) == doctest::Approx(std::log(x)).epsilon(1e-12));
+  }
+}
+
+TEST_CASE("bloom filter membership")
+{
+  const int count = 20000;
+  cc_bloom_t u = cc_bloom_new(count, 0.01);
+  for (int n = 0; n < count; ++n)
+  {
+    cc_bloom_add(u, &n, sizeof(int));
+  }
+
+  SUBCASE("no false negatives")
+  {
+    for (int n = 0; n < count; ++n)
+    {
+      REQUIRE(cc_bloom_contains(u, &n, sizeof(int)));
+    }
+  }
+
+  SUBCASE("false positive rate")
+  {
+    int positives = 0;
+    for (int n = count; n < 11 * count; ++n)
+    {
+      positives += cc_bloom_contains(u, &n, sizeof(int)) ? 1 : 0;
+    }
+    CHECK(positives < count * 10 / 50);
+  }
+
+  SUBCASE("copy and clear")
+  {
+    cc_bloom_t v = cc_bloom_copy(u);
+    int key = 17;
+    CHECK(cc_bloom_contains(v, &key, sizeof(int)));
+    cc_bloom_clear(u);
+    CHECK(!cc_bloom_contains(u, &key, sizeof(int)));
+    CHECK(cc_bloom_contains(v, &key, sizeof(int)));
+    cc_bloom_delete(v);
+  }
+
+  cc_bloom_delete(u);
+}
+
+TEST_CASE("map with a bloom filter")
+{
+  cc_map_t u = cc_map_new(sizeof(int), sizeof(int));
+  std::map<int, int> x;
+  for (int n = 0; n < 100; ++n)
+  {
+    cc_map_insert(u, &n, &n);
+    x[n] = n;
+  }
+  REQUIRE(cc_map_attach_bloom(u, 0.01));
+
+  srand(13);
+  for (int n = 0; n < 20000; ++n)
+  {
+    int key = rand() % 4000;
+    if (rand() % 4 == 0)
+    {
+      cc_map_erase(u, &key);
+      x.erase(key);
+    }
+    else
+    {
+      cc_map_insert(u, &key, &n);
+      x[key] = n;
+    }
+  }
+  cc_map_set_seed(u, 12345);
+
+  SUBCASE("lookups")
+  {
+    REQUIRE(cc_map_size(u) == x.size());
+    for (int key = -100; key < 4100; ++key)
+    {
+      int* value = (int*) cc_map_find(u, &key);
+      REQUIRE((value != nullptr) == (x.count(key) == 1));
+      if (value)
+      {
+        CHECK(*value == x[key]);
+      }
+    }
+  }
+
+  SUBCASE("copy and swap")
+  {
+    cc_map_t v = cc_map_copy(u);
+    REQUIRE(v->bloom != nullptr);
+    cc_map_t w = cc_map_new(sizeof(int), sizeof(int));
+    cc_map_swap(v, w);
+    CHECK(v->bloom == nullptr);
+    CHECK(cc_map_eq(u, w));
+    cc_map_delete(v);
+    cc_map_delete(w);
+  }
+
+  SUBCASE("clear and detach")
+  {
+    cc_map_clear(u);
+    int key = 7;
+    CHECK(!cc_map_contains(u, &key));
+    cc_map_insert(u, &key, &key);
+    CHECK(cc_map_contains(u, &key));
+    cc_map_detach_bloom(u);
+    CHECK(cc_map_contains(u, &key));
+  }
+
+  cc_map_delete(u);
+}
+
+TEST_CASE("set with a bloom filter")
+{
+  cc_set_t u = cc_set_new(sizeof(int));
+  cc_set_t v = cc_set_new(sizeof(int));
+  REQUIRE(cc_set_attach_bloom(u, 0.02));
+  for (int n = 0; n < 1000; ++n)
+  {
+    cc_set_insert(u, &n);
+    if (n % 7 == 0)
+    {
+      cc_set_insert(v, &n);
+    }
+  }
+  cc_set_intersection(u, v);
+  CHECK(u->map.bloom != nullptr);
+  CHECK(cc_set_size(u) == 143);
+  for (int n = 0; n < 1000; ++n)
+  {
+    CHECK(cc_set_contains(u, &n) == (n % 7 == 0));
+  }
+  cc_set_detach_bloom(u);
+  cc_set_delete(u);
+  cc_set_delete(v);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,329 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+void
+check_btree_map(cc_btree_map_t u, const std::map<int, int>& x)
+{
+  REQUIRE(cc_btree_map_size(u) == x.size());
+
+  auto q = x.begin();
+  cc_btree_map_iterator_t p = cc_btree_map_begin(u);
+  cc_btree_map_iterator_t e = cc_btree_map_end(u);
+  for (; cc_btree_map_iterator_ne(p, e); cc_btree_map_iterator_increment(&p))
+  {
+    REQUIRE(q != x.end());
+    cc_btree_map_key_value_t kv = cc_btree_map_iterator_dereference(p);
+    CHECK(*(int*) kv.key == q->first);
+    CHECK(*(int*) kv.value == q->second);
+    ++q;
+  }
+  CHECK(q == x.end());
+}
+
+TEST_SUITE_BEGIN("btree maps");
+
+TEST_CASE("btree map construction")
+{
+  SUBCASE("empty map")
+  {
+    cc_btree_map_t u = cc_btree_map_new(
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    CHECK(cc_btree_map_empty(u));
+    CHECK(cc_btree_map_height(u) == 1);
+    check_btree_map(u, { });
+    cc_btree_map_delete(u);
+  }
+
+  SUBCASE("bulk load")
+  {
+    std::map<int, int> x;
+    std::vector<int> ks;
+    std::vector<int> vs;
+    for (int n = 0; n < 10000; ++n)
+    {
+      ks.push_back(3 * n);
+      vs.push_back(n);
+      x[3 * n] = n;
+    }
+    cc_btree_map_t u = cc_btree_map_from_sorted_arrays(
+        ks.data(),
+        vs.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    CHECK(cc_btree_map_height(u) == 3);
+    check_btree_map(u, x);
+
+    int key = 300;
+    CHECK(*(int*) cc_btree_map_find(u, &key) == 100);
+    key = 301;
+    CHECK(!cc_btree_map_contains(u, &key));
+    cc_btree_map_insert(u, &key, &key);
+    x[301] = 301;
+    check_btree_map(u, x);
+    cc_btree_map_delete(u);
+  }
+
+  SUBCASE("sorted arrays with duplicate keys")
+  {
+    std::vector<int> ks = { 1, 2, 2, 3 };
+    std::vector<int> vs = { 10, 20, 21, 30 };
+    cc_btree_map_t u = cc_btree_map_from_sorted_arrays(
+        ks.data(),
+        vs.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    REQUIRE(u);
+    check_btree_map(u, { {1, 10}, {2, 21}, {3, 30} });
+    cc_btree_map_delete(u);
+  }
+
+  SUBCASE("unsorted arrays")
+  {
+    std::vector<int> ks = { 5, 1, 3 };
+    cc_btree_map_t u = cc_btree_map_from_sorted_arrays(
+        ks.data(),
+        ks.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    check_btree_map(u, { {1, 1}, {3, 3}, {5, 5} });
+    cc_btree_map_delete(u);
+  }
+
+  SUBCASE("copy")
+  {
+    cc_btree_map_t u = cc_btree_map_new(
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    std::map<int, int> x;
+    for (int n = 0; n < 1000; ++n)
+    {
+      int key = (n * 37) % 1000;
+      cc_btree_map_insert(u, &key, &n);
+      x[key] = n;
+    }
+    cc_btree_map_t v = cc_btree_map_copy(u);
+    check_btree_map(v, x);
+    CHECK(cc_btree_map_eq(u, v));
+    int key = 10;
+    cc_btree_map_erase(v, &key);
+    CHECK(cc_btree_map_ne(u, v));
+    cc_btree_map_delete(u);
+    cc_btree_map_delete(v);
+  }
+}
+
+TEST_CASE("btree map modification")
+{
+  cc_btree_map_t u = cc_btree_map_new(
+      sizeof(int),
+      sizeof(int),
+      cc_int_comparator
+    );
+  std::map<int, int> x;
+  srand(7);
+
+  SUBCASE("random inserts and erases")
+  {
+    for (int n = 0; n < 20000; ++n)
+    {
+      int key = rand() % 5000;
+      if (rand() % 3 == 0)
+      {
+        cc_btree_map_erase(u, &key);
+        x.erase(key);
+      }
+      else
+      {
+        cc_btree_map_insert(u, &key, &n);
+        x[key] = n;
+      }
+    }
+    check_btree_map(u, x);
+    for (int key = 0; key < 5000; ++key)
+    {
+      CHECK(cc_btree_map_contains(u, &key) == (x.count(key) == 1));
+    }
+  }
+
+  SUBCASE("erase everything")
+  {
+    for (int n = 0; n < 5000; ++n)
+    {
+      cc_btree_map_insert(u, &n, &n);
+    }
+    CHECK(cc_btree_map_height(u) > 1);
+    for (int n = 4999; n >= 0; n -= 2)
+    {
+      cc_btree_map_erase(u, &n);
+    }
+    for (int n = 0; n < 5000; n += 2)
+    {
+      cc_btree_map_erase(u, &n);
+    }
+    check_btree_map(u, { });
+    CHECK(cc_btree_map_height(u) == 1);
+
+    int key = 9;
+    cc_btree_map_insert(u, &key, &key);
+    check_btree_map(u, { {9, 9} });
+  }
+
+  SUBCASE("clear")
+  {
+    for (int n = 0; n < 1000; ++n)
+    {
+      cc_btree_map_insert(u, &n, &n);
+    }
+    cc_btree_map_clear(u);
+    check_btree_map(u, { });
+    int key = 3;
+    cc_btree_map_insert(u, &key, &key);
+    check_btree_map(u, { {3, 3} });
+  }
+
+  cc_btree_map_delete(u);
+}
+
+TEST_CASE("btree map range queries")
+{
+  std::vector<int> ks;
+  for (int n = 0; n < 1000; ++n)
+  {
+    ks.push_back(10 * n);
+  }
+  cc_btree_map_t u = cc_btree_map_from_sorted_arrays(
+      ks.data(),
+      ks.data(),
+      ks.size(),
+      sizeof(int),
+      sizeof(int),
+      cc_int_comparator
+    );
+
+  SUBCASE("bounds")
+  {
+    int key = 250;
+    cc_btree_map_iterator_t p = cc_btree_map_lower_bound(u, &key);
+    CHECK(*(int*) cc_btree_map_iterator_dereference(p).key == 250);
+    p = cc_btree_map_upper_bound(u, &key);
+    CHECK(*(int*) cc_btree_map_iterator_dereference(p).key == 260);
+    key = 255;
+    p = cc_btree_map_lower_bound(u, &key);
+    CHECK(*(int*) cc_btree_map_iterator_dereference(p).key == 260);
+    key = 9990;
+    p = cc_btree_map_upper_bound(u, &key);
+    CHECK(cc_btree_map_iterator_eq(p, cc_btree_map_end(u)));
+    key = -5;
+    p = cc_btree_map_lower_bound(u, &key);
+    CHECK(cc_btree_map_iterator_eq(p, cc_btree_map_begin(u)));
+  }
+
+  SUBCASE("range iteration")
+  {
+    int low = 1234;
+    int high = 5678;
+    cc_btree_map_iterator_t p = cc_btree_map_lower_bound(u, &low);
+    cc_btree_map_iterator_t e = cc_btree_map_upper_bound(u, &high);
+    int expected = 1240;
+    for (; cc_btree_map_iterator_ne(p, e); cc_btree_map_iterator_increment(&p))
+    {
+      CHECK(*(int*) cc_btree_map_iterator_dereference(p).key == expected);
+      expected += 10;
+    }
+    CHECK(expected == 5680);
+  }
+
+  SUBCASE("reverse iteration")
+  {
+    cc_btree_map_iterator_t b = cc_btree_map_begin(u);
+    cc_btree_map_iterator_t p = cc_btree_map_end(u);
+    int expected = 9990;
+    do
+    {
+      cc_btree_map_iterator_decrement(&p);
+      CHECK(*(int*) cc_btree_map_iterator_dereference(p).key == expected);
+      expected -= 10;
+    }
+    while (cc_btree_map_iterator_ne(p, b));
+    CHECK(expected == -10);
+  }
+
+  cc_btree_map_delete(u);
+}
+
+TEST_CASE("btree map of strings")
+{
+  cc_btree_map_t u = cc_btree_map_new_f(
+      sizeof(struct cc_string),
+      sizeof(int),
+      cc_string_comparator,
+      cc_string_functions,
+      cc_default_functions
+    );
+
+  std::map<std::string, int> x;
+  for (int n = 0; n < 500; ++n)
+  {
+    std::string s = "key" + std::to_string((n * 7) % 500);
+    cc_string_t key = cc_string_from_chars(s.data(), s.size());
+    cc_btree_map_insert(u, key, &n);
+    cc_string_delete(key);
+    x[s] = n;
+  }
+  for (int n = 0; n < 500; n += 3)
+  {
+    std::string s = "key" + std::to_string(n);
+    cc_string_t key = cc_string_from_chars(s.data(), s.size());
+    cc_btree_map_erase(u, key);
+    cc_string_delete(key);
+    x.erase(s);
+  }
+
+  REQUIRE(cc_btree_map_size(u) == x.size());
+  auto q = x.begin();
+  cc_btree_map_iterator_t p = cc_btree_map_begin(u);
+  cc_btree_map_iterator_t e = cc_btree_map_end(u);
+  for (; cc_btree_map_iterator_ne(p, e); cc_btree_map_iterator_increment(&p))
+  {
+    cc_btree_map_key_value_t kv = cc_btree_map_iterator_dereference(p);
+    const struct cc_string* key = (const struct cc_string*) kv.key;
+    CHECK(std::string(key->data, key->size) == q->first);
+    CHECK(*(int*) kv.value == q->second);
+    ++q;
+  }
+
+  cc_btree_map_t v = cc_btree_map_copy(u);
+  CHECK(cc_btree_map_eq(u, v));
+  cc_btree_map_delete(v);
+  cc_btree_map_delete(u);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,149 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <thread>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+void
+add_to(void* existing, const void* value, void* arg)
+{
+  *(int*) existing += *(const int*) value;
+}
+
+void
+sum_values(const void* key, const void* value, void* arg)
+{
+  *(long*) arg += *(const int*) value;
+}
+
+TEST_SUITE_BEGIN("concurrent maps");
+
+TEST_CASE("concurrent map construction")
+{
+  SUBCASE("shard count is rounded up to a power of two")
+  {
+    cc_concurrent_map_t u = cc_concurrent_map_new(sizeof(int), sizeof(int), 5);
+    CHECK(cc_concurrent_map_shard_count(u) == 8);
+    CHECK(cc_concurrent_map_empty(u));
+    cc_concurrent_map_delete(u);
+  }
+
+  SUBCASE("default shard count")
+  {
+    cc_concurrent_map_t u = cc_concurrent_map_new(sizeof(int), sizeof(int), 0);
+    CHECK(cc_concurrent_map_shard_count(u) == 64);
+    cc_concurrent_map_delete(u);
+  }
+}
+
+TEST_CASE("concurrent map modification")
+{
+  int value;
+  cc_concurrent_map_t u = cc_concurrent_map_new(sizeof(int), sizeof(int), 4);
+  for (int n = 0; n < 100; ++n)
+  {
+    value = n * n;
+    cc_concurrent_map_insert(u, &n, &value);
+  }
+
+  SUBCASE("find")
+  {
+    CHECK(cc_concurrent_map_size(u) == 100);
+    for (int n = 0; n < 100; ++n)
+    {
+      REQUIRE(cc_concurrent_map_find(u, &n, &value));
+      CHECK(value == n * n);
+    }
+    int missing = 100;
+    CHECK(!cc_concurrent_map_find(u, &missing, &value));
+    CHECK(!cc_concurrent_map_contains(u, &missing));
+  }
+
+  SUBCASE("erase")
+  {
+    for (int n = 0; n < 100; n += 2)
+    {
+      cc_concurrent_map_erase(u, &n);
+    }
+    int missing = 1000;
+    cc_concurrent_map_erase(u, &missing);
+    CHECK(cc_concurrent_map_size(u) == 50);
+    for (int n = 0; n < 100; ++n)
+    {
+      CHECK(cc_concurrent_map_contains(u, &n) == (n % 2 == 1));
+    }
+  }
+
+  SUBCASE("upsert")
+  {
+    int key = 7;
+    int delta = 10;
+    cc_concurrent_map_upsert(u, &key, &delta, add_to, NULL);
+    REQUIRE(cc_concurrent_map_find(u, &key, &value));
+    CHECK(value == 59);
+
+    key = 200;
+    cc_concurrent_map_upsert(u, &key, &delta, add_to, NULL);
+    REQUIRE(cc_concurrent_map_find(u, &key, &value));
+    CHECK(value == 10);
+  }
+
+  SUBCASE("iteration")
+  {
+    long sum = 0;
+    cc_concurrent_map_for_each(u, sum_values, &sum);
+    CHECK(sum == 328350);
+  }
+
+  SUBCASE("clear")
+  {
+    cc_concurrent_map_clear(u);
+    CHECK(cc_concurrent_map_empty(u));
+  }
+
+  cc_concurrent_map_delete(u);
+}
+
+TEST_CASE("concurrent map threads")
+{
+  const int threads = 4;
+  const int count = 1000;
+  int one = 1;
+  cc_concurrent_map_t u = cc_concurrent_map_new(sizeof(int), sizeof(int), 16);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&]() {
+      for (int n = 0; n < count; ++n)
+      {
+        cc_concurrent_map_upsert(u, &n, &one, add_to, NULL);
+      }
+    });
+  }
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  int value;
+  CHECK(cc_concurrent_map_size(u) == count);
+  for (int n = 0; n < count; ++n)
+  {
+    REQUIRE(cc_concurrent_map_find(u, &n, &value));
+    CHECK(value == threads);
+  }
+
+  cc_concurrent_map_delete(u);
+}
+
+TEST_SUITE_END();
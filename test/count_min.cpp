@@ -0,0 +1,100 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <map>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+TEST_SUITE_BEGIN("count-min sketches");
+
+TEST_CASE("count-min construction")
+{
+  cc_count_min_t u = cc_count_min_new(0.001, 0.01);
+  CHECK(cc_count_min_width(u) == 4096);
+  CHECK(cc_count_min_depth(u) == 5);
+  CHECK(cc_count_min_total(u) == 0);
+  int key = 3;
+  CHECK(cc_count_min_estimate(u, &key, sizeof(int)) == 0);
+  cc_count_min_delete(u);
+
+  u = cc_count_min_new_f(1000, 4, cc_default_hasher);
+  CHECK(cc_count_min_width(u) == 1024);
+  cc_count_min_delete(u);
+
+  CHECK(cc_count_min_new_f(0, 4, cc_default_hasher) == nullptr);
+}
+
+TEST_CASE("count-min estimates")
+{
+  cc_count_min_t u = cc_count_min_new(0.001, 0.01);
+  std::map<int, uint64_t> x;
+  srand(17);
+  for (int n = 0; n < 100000; ++n)
+  {
+    int key = rand() % 1000 < 100 ? rand() % 10 : rand() % 100000;
+    cc_count_min_add(u, &key, sizeof(int), 1);
+    ++x[key];
+  }
+  CHECK(cc_count_min_total(u) == 100000);
+
+  SUBCASE("bounds")
+  {
+    uint64_t slack = cc_count_min_total(u) / 1000;
+    int overcounted = 0;
+    for (const auto& kv : x)
+    {
+      uint64_t estimate = cc_count_min_estimate(u, &kv.first, sizeof(int));
+      REQUIRE(estimate >= kv.second);
+      overcounted += estimate > kv.second + slack ? 1 : 0;
+    }
+    CHECK(overcounted < (int) x.size() / 100);
+  }
+
+  SUBCASE("heavy hitters")
+  {
+    for (int key = 0; key < 10; ++key)
+    {
+      uint64_t estimate = cc_count_min_estimate(u, &key, sizeof(int));
+      CHECK(estimate >= 900);
+      CHECK(estimate <= x[key] + 100);
+    }
+  }
+
+  SUBCASE("merge")
+  {
+    cc_count_min_t v = cc_count_min_copy(u);
+    int key = 123456;
+    cc_count_min_add(v, &key, sizeof(int), 50);
+    REQUIRE(cc_count_min_merge(v, u));
+    CHECK(cc_count_min_total(v) == 200050);
+    CHECK(cc_count_min_estimate(v, &key, sizeof(int)) >= 50);
+    key = 0;
+    CHECK(cc_count_min_estimate(v, &key, sizeof(int))
+          >= 2 * cc_count_min_estimate(u, &key, sizeof(int)));
+
+    cc_count_min_t w = cc_count_min_new_f(16, 2, cc_default_hasher);
+    CHECK(!cc_count_min_merge(v, w));
+    cc_count_min_delete(w);
+    cc_count_min_delete(v);
+  }
+
+  SUBCASE("clear")
+  {
+    cc_count_min_clear(u);
+    int key = 0;
+    CHECK(cc_count_min_estimate(u, &key, sizeof(int)) == 0);
+    CHECK(cc_count_min_total(u) == 0);
+  }
+
+  cc_count_min_delete(u);
+}
+
+TEST_SUITE_END();
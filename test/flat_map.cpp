@@ -0,0 +1,186 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+
+void
+check_flat_map(cc_flat_map_t u, const std::map<int, int>& x)
+{
+  REQUIRE(cc_flat_map_size(u) == x.size());
+
+  auto q = x.begin();
+  cc_flat_map_iterator_t p = cc_flat_map_begin(u);
+  cc_flat_map_iterator_t e = cc_flat_map_end(u);
+  for (; cc_flat_map_iterator_ne(p, e); cc_flat_map_iterator_increment(&p))
+  {
+    cc_flat_map_key_value_t kv = cc_flat_map_iterator_dereference(p);
+    CHECK(*(int*) kv.key == q->first);
+    CHECK(*(int*) kv.value == q->second);
+    CHECK(*(int*) cc_flat_map_find(u, &q->first) == q->second);
+    ++q;
+  }
+}
+
+TEST_SUITE_BEGIN("flat maps");
+
+TEST_CASE("flat map construction")
+{
+  SUBCASE("empty map")
+  {
+    cc_flat_map_t u = cc_flat_map_new(
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    CHECK(cc_flat_map_empty(u));
+    check_flat_map(u, { });
+    cc_flat_map_delete(u);
+  }
+
+  SUBCASE("create from arrays")
+  {
+    std::vector<int> ks = { 5, 3, 9, 3, 1 };
+    std::vector<int> vs = { 50, 30, 90, 31, 10 };
+    cc_flat_map_t u = cc_flat_map_from_arrays(
+        ks.data(),
+        vs.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    check_flat_map(u, { {1, 10}, {3, 31}, {5, 50}, {9, 90} });
+    cc_flat_map_delete(u);
+  }
+
+  SUBCASE("copy")
+  {
+    std::vector<int> ks = { 2, 1 };
+    cc_flat_map_t u = cc_flat_map_from_arrays(
+        ks.data(),
+        ks.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int),
+        cc_int_comparator
+      );
+    cc_flat_map_t v = cc_flat_map_copy(u);
+    check_flat_map(v, { {1, 1}, {2, 2} });
+    CHECK(cc_flat_map_eq(u, v));
+    cc_flat_map_delete(u);
+    cc_flat_map_delete(v);
+  }
+}
+
+TEST_CASE("flat map modification")
+{
+  cc_flat_map_t u = cc_flat_map_new(sizeof(int), sizeof(int), cc_int_comparator);
+  std::map<int, int> x;
+  for (int n = 0; n < 100; n += 2)
+  {
+    cc_flat_map_insert(u, &n, &n);
+    x[n] = n;
+  }
+
+  SUBCASE("insert")
+  {
+    int key = 51;
+    int value = -1;
+    cc_flat_map_insert(u, &key, &value);
+    key = 50;
+    cc_flat_map_insert(u, &key, &value);
+    x[51] = -1;
+    x[50] = -1;
+    check_flat_map(u, x);
+  }
+
+  SUBCASE("erase")
+  {
+    int key = 40;
+    cc_flat_map_erase(u, &key);
+    key = 41;
+    cc_flat_map_erase(u, &key);
+    x.erase(40);
+    check_flat_map(u, x);
+    CHECK(!cc_flat_map_contains(u, &key));
+  }
+
+  SUBCASE("batch insert")
+  {
+    std::vector<int> ks;
+    std::vector<int> vs;
+    srand(11);
+    for (int n = 0; n < 1000; ++n)
+    {
+      int key = rand() % 300 - 50;
+      ks.push_back(key);
+      vs.push_back(n);
+      x[key] = n;
+    }
+    cc_flat_map_insert_batch(u, ks.data(), vs.data(), ks.size());
+    check_flat_map(u, x);
+  }
+
+  SUBCASE("bounds")
+  {
+    int key = 31;
+    cc_flat_map_iterator_t p = cc_flat_map_lower_bound(u, &key);
+    CHECK(*(int*) cc_flat_map_iterator_dereference(p).key == 32);
+    key = 32;
+    p = cc_flat_map_upper_bound(u, &key);
+    CHECK(*(int*) cc_flat_map_iterator_dereference(p).key == 34);
+    key = 98;
+    p = cc_flat_map_upper_bound(u, &key);
+    CHECK(cc_flat_map_iterator_eq(p, cc_flat_map_end(u)));
+  }
+
+  SUBCASE("clear")
+  {
+    cc_flat_map_clear(u);
+    check_flat_map(u, { });
+  }
+
+  cc_flat_map_delete(u);
+}
+
+TEST_CASE("flat map of arrays")
+{
+  int a[] = { 1, 2, 3 };
+  int b[] = { 4, 5 };
+  iarray values[] = { { 3, a }, { 2, b }, { 2, b } };
+  int keys[] = { 7, 3, 7 };
+
+  cc_flat_map_t u = cc_flat_map_new_f(
+      sizeof(int),
+      sizeof(iarray),
+      cc_int_comparator,
+      cc_default_functions,
+      iarray_functions
+    );
+  cc_flat_map_insert(u, &keys[0], &values[0]);
+  cc_flat_map_insert_batch(u, keys, values, 3);
+  CHECK(cc_flat_map_size(u) == 2);
+  CHECK(iarray_equal(cc_flat_map_find(u, &keys[0]), &values[1], 0));
+
+  cc_flat_map_t v = cc_flat_map_copy(u);
+  CHECK(cc_flat_map_eq(u, v));
+  cc_flat_map_erase(v, &keys[1]);
+  CHECK(cc_flat_map_ne(u, v));
+
+  cc_flat_map_delete(u);
+  cc_flat_map_delete(v);
+}
+
+TEST_SUITE_END();
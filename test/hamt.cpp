@@ -0,0 +1,259 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <map>
+#include <thread>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+
+void
+collect_hamt(const void* key, const void* value, void* arg)
+{
+  auto items = (std::map<int, int>*) arg;
+  items->emplace(*(const int*) key, *(const int*) value);
+}
+
+void
+check_hamt(cc_hamt_t u, const std::map<int, int>& x)
+{
+  REQUIRE(cc_hamt_size(u) == x.size());
+  for (const auto& kv : x)
+  {
+    const int* value = (const int*) cc_hamt_find(u, &kv.first);
+    REQUIRE(value != nullptr);
+    CHECK(*value == kv.second);
+  }
+
+  std::map<int, int> items;
+  cc_hamt_for_each(u, collect_hamt, &items);
+  CHECK(items == x);
+}
+
+cc_hamt_t
+hamt_replace(cc_hamt_t u, cc_hamt_t v)
+{
+  cc_hamt_delete(u);
+  return v;
+}
+
+uint64_t
+colliding_hasher(const void* buffer, size_t size)
+{
+  return *(const int*) buffer % 4;
+}
+
+TEST_SUITE("persistent hash maps")
+{
+  TEST_CASE("create")
+  {
+    cc_hamt_t u = cc_hamt_new(sizeof(int), sizeof(int));
+    REQUIRE(u != nullptr);
+    CHECK(cc_hamt_empty(u));
+    CHECK(cc_hamt_size(u) == 0);
+    int key = 1;
+    CHECK(cc_hamt_find(u, &key) == nullptr);
+    CHECK(!cc_hamt_contains(u, &key));
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("versions")
+  {
+    cc_hamt_t u = cc_hamt_new(sizeof(int), sizeof(int));
+    std::vector<cc_hamt_t> versions;
+    std::vector<std::map<int, int>> models;
+    std::map<int, int> x;
+    for (int n = 0; n < 200; ++n)
+    {
+      int value = n * 7;
+      u = hamt_replace(u, cc_hamt_insert(u, &n, &value));
+      x[n] = value;
+      if (n % 20 == 0)
+      {
+        versions.push_back(cc_hamt_copy(u));
+        models.push_back(x);
+      }
+    }
+    for (int n = 0; n < 200; n += 3)
+    {
+      u = hamt_replace(u, cc_hamt_erase(u, &n));
+      x.erase(n);
+    }
+    check_hamt(u, x);
+    for (size_t n = 0; n < versions.size(); ++n)
+    {
+      check_hamt(versions[n], models[n]);
+      cc_hamt_delete(versions[n]);
+    }
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("update")
+  {
+    cc_hamt_t u = cc_hamt_new(sizeof(int), sizeof(int));
+    int key = 5;
+    int value = 1;
+    u = hamt_replace(u, cc_hamt_insert(u, &key, &value));
+    value = 2;
+    cc_hamt_t v = cc_hamt_insert(u, &key, &value);
+    CHECK(cc_hamt_size(v) == 1);
+    CHECK(*(const int*) cc_hamt_find(u, &key) == 1);
+    CHECK(*(const int*) cc_hamt_find(v, &key) == 2);
+    CHECK(cc_hamt_ne(u, v));
+
+    key = 6;
+    cc_hamt_t w = cc_hamt_erase(v, &key);
+    CHECK(cc_hamt_eq(v, w));
+    cc_hamt_delete(w);
+    cc_hamt_delete(v);
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("random")
+  {
+    cc_hamt_t u = cc_hamt_new(sizeof(int), sizeof(int));
+    std::map<int, int> x;
+    srand(19);
+    for (int n = 0; n < 5000; ++n)
+    {
+      int key = rand() % 1000;
+      int value = rand();
+      if (rand() % 3 == 0)
+      {
+        u = hamt_replace(u, cc_hamt_erase(u, &key));
+        x.erase(key);
+      }
+      else
+      {
+        u = hamt_replace(u, cc_hamt_insert(u, &key, &value));
+        x[key] = value;
+      }
+    }
+    check_hamt(u, x);
+    for (const auto& kv : x)
+    {
+      u = hamt_replace(u, cc_hamt_erase(u, &kv.first));
+    }
+    CHECK(cc_hamt_empty(u));
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("collisions")
+  {
+    struct cc_functions functions = cc_default_functions;
+    functions.hasher = colliding_hasher;
+    functions.seeded_hasher = NULL;
+    cc_hamt_t u = cc_hamt_new_f(sizeof(int), sizeof(int), functions,
+                                cc_default_functions);
+    std::map<int, int> x;
+    for (int n = 0; n < 64; ++n)
+    {
+      int value = -n;
+      u = hamt_replace(u, cc_hamt_insert(u, &n, &value));
+      x[n] = value;
+    }
+    cc_hamt_t v = cc_hamt_copy(u);
+    check_hamt(u, x);
+    for (int n = 0; n < 64; n += 2)
+    {
+      u = hamt_replace(u, cc_hamt_erase(u, &n));
+      x.erase(n);
+    }
+    check_hamt(u, x);
+    CHECK(cc_hamt_size(v) == 64);
+    CHECK(cc_hamt_ne(u, v));
+    cc_hamt_delete(v);
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("equality")
+  {
+    cc_hamt_t u = cc_hamt_new(sizeof(int), sizeof(int));
+    cc_hamt_t v = cc_hamt_new(sizeof(int), sizeof(int));
+    for (int n = 0; n < 100; ++n)
+    {
+      int m = 99 - n;
+      u = hamt_replace(u, cc_hamt_insert(u, &n, &n));
+      v = hamt_replace(v, cc_hamt_insert(v, &m, &m));
+    }
+    CHECK(cc_hamt_eq(u, v));
+    int key = 50;
+    int value = 0;
+    cc_hamt_t w = cc_hamt_insert(v, &key, &value);
+    CHECK(cc_hamt_ne(u, w));
+    cc_hamt_delete(w);
+    cc_hamt_delete(v);
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("deep values")
+  {
+    int a[] = { 1, 2, 3 };
+    int b[] = { 4, 5 };
+    iarray values[] = { { 3, a }, { 2, b } };
+    cc_hamt_t u = cc_hamt_new_f(sizeof(int), sizeof(iarray),
+                                cc_default_functions, iarray_functions);
+    for (int n = 0; n < 50; ++n)
+    {
+      u = hamt_replace(u, cc_hamt_insert(u, &n, &values[n % 2]));
+    }
+    cc_hamt_t v = cc_hamt_copy(u);
+    for (int n = 0; n < 50; n += 5)
+    {
+      u = hamt_replace(u, cc_hamt_erase(u, &n));
+    }
+    int key = 7;
+    CHECK(iarray_equal(cc_hamt_find(u, &key), &values[1], 0));
+    key = 10;
+    CHECK(iarray_equal(cc_hamt_find(v, &key), &values[0], 0));
+    CHECK(!cc_hamt_contains(u, &key));
+    cc_hamt_delete(v);
+    cc_hamt_delete(u);
+  }
+
+  TEST_CASE("threads")
+  {
+    cc_hamt_t u = cc_hamt_new(sizeof(int), sizeof(int));
+    for (int n = 0; n < 1000; ++n)
+    {
+      u = hamt_replace(u, cc_hamt_insert(u, &n, &n));
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> found(4, 0);
+    for (int t = 0; t < 4; ++t)
+    {
+      cc_hamt_t snapshot = cc_hamt_copy(u);
+      threads.emplace_back([snapshot, t, &found]() {
+        cc_hamt_t v = snapshot;
+        for (int n = 0; n < 1000; ++n)
+        {
+          found[t] += cc_hamt_contains(v, &n) ? 1 : 0;
+          int key = n + 1000 * (t + 1);
+          v = hamt_replace(v, cc_hamt_insert(v, &key, &n));
+        }
+        cc_hamt_delete(v);
+      });
+    }
+    for (int n = 0; n < 1000; n += 2)
+    {
+      u = hamt_replace(u, cc_hamt_erase(u, &n));
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    CHECK(found == std::vector<size_t>(4, 1000));
+    CHECK(cc_hamt_size(u) == 500);
+    cc_hamt_delete(u);
+  }
+}
@@ -0,0 +1,90 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdint>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+TEST_SUITE_BEGIN("hyperloglog sketches");
+
+TEST_CASE("hyperloglog construction")
+{
+  cc_hll_t u = cc_hll_new(12);
+  CHECK(cc_hll_precision(u) == 12);
+  CHECK(cc_hll_estimate(u) == 0.0);
+  cc_hll_delete(u);
+
+  u = cc_hll_new(1);
+  CHECK(cc_hll_precision(u) == 4);
+  cc_hll_delete(u);
+
+  u = cc_hll_new(40);
+  CHECK(cc_hll_precision(u) == 18);
+  cc_hll_delete(u);
+}
+
+TEST_CASE("hyperloglog estimates")
+{
+  cc_hll_t u = cc_hll_new(14);
+
+  SUBCASE("small cardinality")
+  {
+    for (int n = 0; n < 3; ++n)
+    {
+      for (int key = 0; key < 100; ++key)
+      {
+        cc_hll_add(u, &key, sizeof(int));
+      }
+    }
+    CHECK(cc_hll_estimate(u) == doctest::Approx(100).epsilon(0.03));
+  }
+
+  SUBCASE("large cardinality")
+  {
+    for (int key = 0; key < 1000000; ++key)
+    {
+      cc_hll_add(u, &key, sizeof(int));
+    }
+    CHECK(cc_hll_estimate(u) == doctest::Approx(1000000).epsilon(0.03));
+    cc_hll_clear(u);
+    CHECK(cc_hll_estimate(u) == 0.0);
+  }
+
+  cc_hll_delete(u);
+}
+
+TEST_CASE("hyperloglog merge")
+{
+  cc_hll_t u = cc_hll_new(14);
+  cc_hll_t v = cc_hll_new(14);
+  for (int key = 0; key < 60000; ++key)
+  {
+    cc_hll_add(u, &key, sizeof(int));
+  }
+  for (int key = 40000; key < 100000; ++key)
+  {
+    cc_hll_add(v, &key, sizeof(int));
+  }
+
+  cc_hll_t w = cc_hll_copy(u);
+  REQUIRE(cc_hll_merge(w, v));
+  CHECK(cc_hll_estimate(w) == doctest::Approx(100000).epsilon(0.03));
+  CHECK(cc_hll_estimate(w) >= cc_hll_estimate(u));
+
+  cc_hll_t x = cc_hll_new(10);
+  CHECK(!cc_hll_merge(w, x));
+
+  cc_hll_delete(u);
+  cc_hll_delete(v);
+  cc_hll_delete(w);
+  cc_hll_delete(x);
+}
+
+TEST_SUITE_END();
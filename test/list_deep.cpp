@@ -208,6 +208,16 @@ TEST_CASE("list modification [deep]")
     check_list<iarray>(v, { {2, x1}, {2, x2}, {2, x3}, {1, a1} });
   }
 
+  SUBCASE("emplace back")
+  {
+    cc_list_t w = cc_list_new_f(sizeof(iarray), iarray_functions);
+    iarray* y = (iarray*) cc_list_emplace_back(w);
+    REQUIRE(y != nullptr);
+    iarray_copy(y, &a, sizeof(iarray));
+    check_list<iarray>(w, { {1, a1} });
+    cc_list_delete(w);
+  }
+
   SUBCASE("pop back")
   {
     cc_list_pop_back(v);
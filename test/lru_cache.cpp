@@ -0,0 +1,253 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+
+void
+record_eviction(const void* key, void* value, void* arg)
+{
+  auto evicted = (std::vector<int>*) arg;
+  evicted->push_back(*(const int*) key);
+  CHECK(*(int*) value == 10 * *(const int*) key);
+}
+
+TEST_SUITE_BEGIN("lru caches");
+
+TEST_CASE("lru cache construction")
+{
+  cc_lru_cache_t u = cc_lru_cache_new(sizeof(int), sizeof(int), 4);
+  CHECK(cc_lru_cache_empty(u));
+  CHECK(cc_lru_cache_capacity(u) == 4);
+  CHECK(cc_lru_cache_policy(u) == CC_LRU_CACHE_LRU);
+  int key = 1;
+  CHECK(cc_lru_cache_get(u, &key) == nullptr);
+  cc_lru_cache_erase(u, &key);
+  cc_lru_cache_delete(u);
+
+  u = cc_lru_cache_new(sizeof(int), sizeof(int), 0);
+  cc_lru_cache_put(u, &key, &key);
+  CHECK(cc_lru_cache_empty(u));
+  cc_lru_cache_delete(u);
+}
+
+TEST_CASE("lru cache eviction")
+{
+  cc_lru_cache_t u = cc_lru_cache_new(sizeof(int), sizeof(int), 3);
+  std::vector<int> evicted;
+  cc_lru_cache_set_eviction_callback(u, record_eviction, &evicted);
+  for (int key = 1; key <= 3; ++key)
+  {
+    int value = 10 * key;
+    cc_lru_cache_put(u, &key, &value);
+  }
+  CHECK(cc_lru_cache_size(u) == 3);
+
+  SUBCASE("least recently used goes first")
+  {
+    int key = 1;
+    CHECK(*(int*) cc_lru_cache_get(u, &key) == 10);
+    key = 4;
+    int value = 40;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(evicted == std::vector<int>{ 2 });
+    key = 5;
+    value = 50;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(evicted == std::vector<int>{ 2, 3 });
+    key = 1;
+    CHECK(cc_lru_cache_contains(u, &key));
+  }
+
+  SUBCASE("peek does not refresh")
+  {
+    int key = 1;
+    CHECK(*(int*) cc_lru_cache_peek(u, &key) == 10);
+    key = 4;
+    int value = 40;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(evicted == std::vector<int>{ 1 });
+  }
+
+  SUBCASE("overwrite refreshes")
+  {
+    int key = 1;
+    int value = 10;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(cc_lru_cache_size(u) == 3);
+    key = 4;
+    value = 40;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(evicted == std::vector<int>{ 2 });
+  }
+
+  SUBCASE("erase frees a slot")
+  {
+    int key = 2;
+    cc_lru_cache_erase(u, &key);
+    CHECK(cc_lru_cache_size(u) == 2);
+    key = 4;
+    int value = 40;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(evicted.empty());
+    CHECK(cc_lru_cache_size(u) == 3);
+  }
+
+  SUBCASE("clear")
+  {
+    cc_lru_cache_clear(u);
+    CHECK(cc_lru_cache_empty(u));
+    int key = 1;
+    CHECK(!cc_lru_cache_contains(u, &key));
+    CHECK(evicted.empty());
+  }
+
+  cc_lru_cache_delete(u);
+}
+
+TEST_CASE("lru cache against a model")
+{
+  const size_t capacity = 64;
+  cc_lru_cache_t u = cc_lru_cache_new(sizeof(int), sizeof(int), capacity);
+  std::list<int> order;
+  std::map<int, int> x;
+  srand(3);
+  for (int n = 0; n < 20000; ++n)
+  {
+    int key = rand() % 200;
+    int op = rand() % 4;
+    if (op == 0)
+    {
+      cc_lru_cache_erase(u, &key);
+      if (x.erase(key))
+      {
+        order.remove(key);
+      }
+    }
+    else if (op == 1)
+    {
+      int* value = (int*) cc_lru_cache_get(u, &key);
+      REQUIRE((value != nullptr) == (x.count(key) == 1));
+      if (value)
+      {
+        CHECK(*value == x[key]);
+        order.remove(key);
+        order.push_front(key);
+      }
+    }
+    else
+    {
+      cc_lru_cache_put(u, &key, &n);
+      if (x.count(key))
+      {
+        order.remove(key);
+      }
+      else if (x.size() == capacity)
+      {
+        x.erase(order.back());
+        order.pop_back();
+      }
+      order.push_front(key);
+      x[key] = n;
+    }
+  }
+
+  CHECK(cc_lru_cache_size(u) == x.size());
+  for (int key = 0; key < 200; ++key)
+  {
+    int* value = (int*) cc_lru_cache_peek(u, &key);
+    REQUIRE((value != nullptr) == (x.count(key) == 1));
+    if (value)
+    {
+      CHECK(*value == x[key]);
+    }
+  }
+  cc_lru_cache_delete(u);
+}
+
+TEST_CASE("clock cache")
+{
+  cc_lru_cache_t u = cc_lru_cache_new_f(
+      sizeof(int),
+      sizeof(int),
+      3,
+      CC_LRU_CACHE_CLOCK,
+      cc_default_functions,
+      cc_default_functions
+    );
+  std::vector<int> evicted;
+  cc_lru_cache_set_eviction_callback(u, record_eviction, &evicted);
+  for (int key = 1; key <= 3; ++key)
+  {
+    int value = 10 * key;
+    cc_lru_cache_put(u, &key, &value);
+  }
+
+  // Referenced entries get a second chance; the sweep clears their bits.
+  int key = 1;
+  CHECK(*(int*) cc_lru_cache_get(u, &key) == 10);
+  key = 4;
+  int value = 40;
+  cc_lru_cache_put(u, &key, &value);
+  CHECK(evicted == std::vector<int>{ 2 });
+  key = 5;
+  value = 50;
+  cc_lru_cache_put(u, &key, &value);
+  CHECK(evicted == std::vector<int>{ 2, 3 });
+  key = 6;
+  value = 60;
+  cc_lru_cache_put(u, &key, &value);
+  CHECK(evicted == std::vector<int>{ 2, 3, 1 });
+
+  for (int n = 0; n < 1000; ++n)
+  {
+    key = n % 10;
+    value = 10 * key;
+    cc_lru_cache_put(u, &key, &value);
+    CHECK(cc_lru_cache_size(u) == 3);
+    CHECK(*(int*) cc_lru_cache_get(u, &key) == value);
+  }
+  cc_lru_cache_delete(u);
+}
+
+TEST_CASE("lru cache of arrays")
+{
+  int a[] = { 1, 2, 3 };
+  int b[] = { 4, 5 };
+  iarray values[] = { { 3, a }, { 2, b } };
+
+  cc_lru_cache_t u = cc_lru_cache_new_f(
+      sizeof(int),
+      sizeof(iarray),
+      2,
+      CC_LRU_CACHE_LRU,
+      cc_default_functions,
+      iarray_functions
+    );
+  for (int key = 0; key < 5; ++key)
+  {
+    cc_lru_cache_put(u, &key, &values[key % 2]);
+  }
+  int key = 4;
+  cc_lru_cache_put(u, &key, &values[1]);
+  CHECK(iarray_equal(cc_lru_cache_get(u, &key), &values[1], 0));
+  key = 3;
+  CHECK(iarray_equal(cc_lru_cache_get(u, &key), &values[1], 0));
+  key = 2;
+  CHECK(!cc_lru_cache_contains(u, &key));
+  cc_lru_cache_delete(u);
+}
+
+TEST_SUITE_END();
@@ -261,6 +261,132 @@ TEST_CASE("map hash policy [atomic]")
   cc_map_delete(u);
 }
 
+uint64_t
+flooded_hasher(const void* buffer, size_t size, uint64_t seed)
+{
+  // Every key collides under one particular seed.
+  return seed == 12345 ? 0 : cc_default_seeded_hasher(buffer, size, seed);
+}
+
+uint64_t
+modular_hasher(const void* buffer, size_t size)
+{
+  return (uint64_t) (*(const int*) buffer % 100);
+}
+
+bool
+modular_equality(const void* left, const void* right, size_t size)
+{
+  return *(const int*) left % 100 == *(const int*) right % 100;
+}
+
+TEST_CASE("map hash seeding [atomic]")
+{
+  std::map<int, int> x;
+  for (auto n = 0; n < 100; ++n) x[n] = 3 * n;
+
+  SUBCASE("random seeds")
+  {
+    cc_map_t u = create_map(x);
+    cc_map_t v = create_map(x);
+    CHECK(cc_map_seed(u) != cc_map_seed(v));
+    CHECK(cc_map_eq(u, v));
+    CHECK(cc_map_hasher(u, cc_map_sizeof) == cc_map_hasher(v, cc_map_sizeof));
+    cc_map_delete(u);
+    cc_map_delete(v);
+  }
+
+  SUBCASE("reproducible seeds")
+  {
+    cc_hash_set_random_seeding(false);
+    cc_map_t u = create_map(x);
+    cc_map_t v = create_map(x);
+    cc_hash_set_random_seeding(true);
+    CHECK(cc_map_seed(u) == 0);
+    CHECK(cc_map_seed(v) == 0);
+    cc_map_delete(u);
+    cc_map_delete(v);
+  }
+
+  SUBCASE("setting the seed")
+  {
+    cc_map_t u = create_map(x);
+    cc_map_set_seed(u, 42);
+    CHECK(cc_map_seed(u) == 42);
+    check_map(u, x);
+    cc_map_delete(u);
+  }
+
+  SUBCASE("reseeding on long probe sequences")
+  {
+    struct cc_functions functions = cc_default_functions;
+    functions.seeded_hasher = flooded_hasher;
+    cc_map_t u = cc_map_new_f(
+        sizeof(int),
+        sizeof(int),
+        functions,
+        cc_default_functions
+      );
+    cc_map_set_seed(u, 12345);
+    for (auto n = 0; n < 1000; ++n)
+    {
+      cc_map_insert(u, &n, &n);
+    }
+    CHECK(cc_map_seed(u) != 12345);
+    CHECK(u->max_length <= 128);
+    for (auto n = 0; n < 1000; ++n)
+    {
+      REQUIRE(cc_map_find(u, &n));
+      CHECK(*(int*) cc_map_find(u, &n) == n);
+    }
+    cc_map_delete(u);
+  }
+
+  SUBCASE("replacing only the hasher")
+  {
+    struct cc_functions functions = cc_default_functions;
+    functions.hasher = modular_hasher;
+    functions.equality = modular_equality;
+    cc_map_t u = cc_map_new_f(
+        sizeof(int),
+        sizeof(int),
+        functions,
+        cc_default_functions
+      );
+    for (auto n = 0; n < 1000; ++n)
+    {
+      cc_map_insert(u, &n, &n);
+    }
+    CHECK(cc_map_size(u) == 100);
+    int key = 1042;
+    REQUIRE(cc_map_find(u, &key));
+    CHECK(*(int*) cc_map_find(u, &key) == 942);
+    cc_map_delete(u);
+  }
+}
+
+TEST_CASE("map large tables [atomic]")
+{
+  const int count = 100000;
+  cc_map_t u = cc_map_new(sizeof(int), sizeof(long));
+  cc_map_reserve(u, count);
+  CHECK(cc_map_capacity(u) == 131072);
+
+  for (int n = 0; n < count; ++n)
+  {
+    long value = 7L * n;
+    cc_map_insert(u, &n, &value);
+  }
+  REQUIRE(cc_map_size(u) == count);
+  for (int n = 0; n < count; n += 97)
+  {
+    REQUIRE(cc_map_find(u, &n));
+    CHECK(*(long*) cc_map_find(u, &n) == 7L * n);
+  }
+
+  cc_map_delete(u);
+}
+
 TEST_CASE("map comparison [atomic]")
 {
   std::map<int, int> x = { {1, 2}, {3, 4}, {5, 6} };
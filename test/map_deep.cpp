@@ -265,6 +265,24 @@ TEST_CASE("map modification [deep]")
     });
   }
 
+  SUBCASE("emplace")
+  {
+    iarray* y = (iarray*) cc_map_emplace(v, &a.first);
+    REQUIRE(y != nullptr);
+    iarray_copy(y, &a.second, sizeof(iarray));
+    iarray k = {2, x2};
+    y = (iarray*) cc_map_emplace(v, &k);
+    REQUIRE(y != nullptr);
+    iarray_copy(y, &a.second, sizeof(iarray));
+    check_map<iarray, iarray>(v, {
+      { {1, x1}, {2, x2} },
+      { {2, x2}, {1, x1} },
+      { {3, x3}, {2, x4} },
+      { {2, x4}, {1, x5} },
+      { {1, x5}, {1, x1} }
+    });
+  }
+
   SUBCASE("erase")
   {
     iarray k = {2, x2};
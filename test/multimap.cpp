@@ -0,0 +1,195 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+
+void
+check_multimap(cc_multimap_t u, const std::map<int, std::vector<int>>& x)
+{
+  size_t total = 0;
+  for (const auto& group : x)
+  {
+    size_t count;
+    const int* values = (const int*) cc_multimap_find(u, &group.first, &count);
+    REQUIRE(count == group.second.size());
+    CHECK(std::vector<int>(values, values + count) == group.second);
+    total += count;
+  }
+  CHECK(cc_multimap_frozen(u));
+  CHECK(cc_multimap_key_count(u) == x.size());
+  CHECK(cc_multimap_size(u) == total);
+}
+
+void
+collect_multimap(const void* key, const void* values, size_t count, void* arg)
+{
+  auto x = (std::map<int, std::vector<int>>*) arg;
+  const int* p = (const int*) values;
+  (*x)[*(const int*) key] = std::vector<int>(p, p + count);
+}
+
+TEST_SUITE_BEGIN("multimaps");
+
+TEST_CASE("multimap construction")
+{
+  SUBCASE("empty multimap")
+  {
+    cc_multimap_t u = cc_multimap_new(sizeof(int), sizeof(int));
+    CHECK(cc_multimap_empty(u));
+    CHECK(cc_multimap_frozen(u));
+    int key = 1;
+    CHECK(!cc_multimap_contains(u, &key));
+    CHECK(cc_multimap_count(u, &key) == 0);
+    check_multimap(u, { });
+    cc_multimap_delete(u);
+  }
+
+  SUBCASE("copy")
+  {
+    cc_multimap_t u = cc_multimap_new(sizeof(int), sizeof(int));
+    std::map<int, std::vector<int>> x;
+    for (int n = 0; n < 20; ++n)
+    {
+      int key = n % 3;
+      cc_multimap_insert(u, &key, &n);
+      x[key].push_back(n);
+      if (n == 10)
+      {
+        cc_multimap_freeze(u);
+      }
+    }
+    CHECK(!cc_multimap_frozen(u));
+    cc_multimap_t v = cc_multimap_copy(u);
+    check_multimap(v, x);
+    check_multimap(u, x);
+    cc_multimap_delete(u);
+    cc_multimap_delete(v);
+  }
+}
+
+TEST_CASE("multimap modification")
+{
+  cc_multimap_t u = cc_multimap_new(sizeof(int), sizeof(int));
+  std::map<int, std::vector<int>> x;
+  srand(5);
+  for (int n = 0; n < 5000; ++n)
+  {
+    int key = rand() % 200;
+    cc_multimap_insert(u, &key, &n);
+    x[key].push_back(n);
+  }
+  CHECK(cc_multimap_size(u) == 5000);
+
+  SUBCASE("freeze")
+  {
+    check_multimap(u, x);
+  }
+
+  SUBCASE("insert after freeze")
+  {
+    cc_multimap_freeze(u);
+    for (int n = 0; n < 1000; ++n)
+    {
+      int key = rand() % 300;
+      int value = -n;
+      cc_multimap_insert(u, &key, &value);
+      x[key].push_back(value);
+    }
+    check_multimap(u, x);
+  }
+
+  SUBCASE("erase")
+  {
+    for (int key = 0; key < 200; key += 3)
+    {
+      cc_multimap_erase(u, &key);
+      x.erase(key);
+    }
+    int key = 7;
+    int value = 99;
+    cc_multimap_insert(u, &key, &value);
+    x[7].push_back(99);
+    key = 9;
+    cc_multimap_insert(u, &key, &value);
+    x[9] = { 99 };
+    check_multimap(u, x);
+    CHECK(u->group_count == x.size());
+    key = 3;
+    CHECK(!cc_multimap_contains(u, &key));
+    key = 4;
+    cc_multimap_erase(u, &key);
+    x.erase(key);
+    check_multimap(u, x);
+    CHECK(u->group_count == x.size());
+  }
+
+  SUBCASE("for each")
+  {
+    std::map<int, std::vector<int>> y;
+    cc_multimap_for_each(u, collect_multimap, &y);
+    CHECK(y == x);
+  }
+
+  SUBCASE("clear")
+  {
+    cc_multimap_clear(u);
+    check_multimap(u, { });
+    int key = 4;
+    cc_multimap_insert(u, &key, &key);
+    check_multimap(u, { {4, {4}} });
+  }
+
+  cc_multimap_delete(u);
+}
+
+TEST_CASE("multimap of arrays")
+{
+  int a[] = { 1, 2, 3 };
+  int b[] = { 4, 5 };
+  iarray values[] = { { 3, a }, { 2, b } };
+
+  cc_multimap_t u = cc_multimap_new_f(
+      sizeof(int),
+      sizeof(iarray),
+      cc_default_functions,
+      iarray_functions
+    );
+  int key = 1;
+  cc_multimap_insert(u, &key, &values[0]);
+  cc_multimap_insert(u, &key, &values[1]);
+  key = 2;
+  cc_multimap_insert(u, &key, &values[1]);
+
+  size_t count;
+  const iarray* found = (const iarray*) cc_multimap_find(u, &key, &count);
+  CHECK(count == 1);
+  CHECK(iarray_equal(&found[0], &values[1], 0));
+
+  cc_multimap_t v = cc_multimap_copy(u);
+  key = 1;
+  cc_multimap_erase(u, &key);
+  found = (const iarray*) cc_multimap_find(v, &key, &count);
+  REQUIRE(count == 2);
+  CHECK(iarray_equal(&found[0], &values[0], 0));
+  CHECK(iarray_equal(&found[1], &values[1], 0));
+  cc_multimap_insert(v, &key, &values[0]);
+  CHECK(cc_multimap_count(v, &key) == 3);
+  CHECK(cc_multimap_count(u, &key) == 0);
+
+  cc_multimap_delete(u);
+  cc_multimap_delete(v);
+}
+
+TEST_SUITE_END();
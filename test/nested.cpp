@@ -8,6 +8,8 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
+#include <cstdlib>
+#include <cstring>
 #include "doctest/doctest.h"
 #include "cc.h"
 #include "string.hpp"
@@ -87,6 +89,96 @@ TEST_CASE("vector of vectors")
   cc_vector_delete(a);
 }
 
+TEST_CASE("vector of small vectors")
+{
+  size_t size = cc_small_vector_sizeof(sizeof(int), 3);
+  cc_vector_t a = cc_vector_new_f(size, cc_vector_functions);
+
+  std::vector<std::vector<int>> x = {
+    { 1 }, { 1, 2, 3 }, { 1, 2, 3, 4, 5 }, { }, { 7, 8 }
+  };
+  for (const auto& y : x)
+  {
+    cc_vector_t u = cc_vector_from_array(y.data(), y.size(), sizeof(int));
+    cc_vector_push_back(a, u);
+    cc_vector_delete(u);
+  }
+
+  // Short elements live inline, so they follow their headers around as the
+  // outer vector grows.
+  REQUIRE(cc_vector_size(a) == x.size());
+  for (size_t n = 0; n < x.size(); ++n)
+  {
+    auto u = (const struct cc_vector*) cc_vector_get(a, n);
+    bool inline_data = (const char*) u->data > (const char*) u
+                    && (const char*) u->data < (const char*) u + size;
+    CHECK(inline_data == (x[n].size() <= 3));
+    check_vector((cc_vector_t) u, x[n]);
+  }
+
+  int value = 6;
+  cc_vector_t v = (cc_vector_t) cc_vector_get(a, 4);
+  cc_vector_push_back(v, &value);
+  cc_vector_push_back(v, &value);
+  check_vector(v, std::vector<int>{ 7, 8, 6, 6 });
+
+  cc_vector_t b = cc_vector_copy(a);
+  CHECK(cc_vector_eq(a, b));
+  cc_vector_erase(b, 0, 2);
+  check_vector((cc_vector_t) cc_vector_get(b, 0), x[2]);
+
+  cc_vector_delete(b);
+  cc_vector_delete(a);
+}
+
+TEST_CASE("emplaced vectors")
+{
+  cc_vector_t a = cc_vector_new_f(cc_vector_sizeof, cc_vector_functions);
+  cc_map_t b = cc_map_new_f(
+      cc_string_sizeof,
+      cc_vector_sizeof,
+      cc_string_functions,
+      cc_vector_functions
+    );
+
+  std::vector<int> x = { 1, 2, 3, 4, 5 };
+  cc_string_t key = cc_string_from_chars("squares", 7);
+
+  // Build the elements in place by relocating fresh, empty vectors into the
+  // emplaced slots and filling them there.
+  cc_vector_t u = cc_vector_new(sizeof(int));
+  void* slot = cc_vector_emplace_back(a);
+  REQUIRE(slot != nullptr);
+  memcpy(slot, u, cc_vector_sizeof);
+  free(u);
+  cc_vector_append_array((cc_vector_t) slot, x.data(), x.size());
+
+  cc_vector_t v = cc_vector_new(sizeof(int));
+  slot = cc_map_emplace(b, key);
+  REQUIRE(slot != nullptr);
+  memcpy(slot, v, cc_vector_sizeof);
+  free(v);
+  for (int n : x)
+  {
+    int square = n * n;
+    cc_vector_push_back((cc_vector_t) slot, &square);
+  }
+
+  REQUIRE(cc_vector_size(a) == 1);
+  check_vector(
+      (cc_vector_t) cc_vector_get(a, 0),
+      std::vector<int>{ 1, 2, 3, 4, 5 }
+    );
+  check_vector(
+      (cc_vector_t) cc_map_find(b, key),
+      std::vector<int>{ 1, 4, 9, 16, 25 }
+    );
+
+  cc_string_delete(key);
+  cc_map_delete(b);
+  cc_vector_delete(a);
+}
+
 TEST_CASE("map of strings to vectors")
 {
   cc_map_t a = cc_map_new_f(
@@ -133,4 +225,202 @@ TEST_CASE("map of strings to vectors")
   cc_map_delete(a);
 }
 
+// Values for the maps of small vectors below.  Most fit in the inline
+// storage, which must follow the vector whenever a container moves it.
+std::vector<int>
+small_value(int key)
+{
+  std::vector<int> x = { key, 2 * key };
+  if (key % 5 == 0)
+  {
+    x.insert(x.end(), { 3 * key, 4 * key, 5 * key });
+  }
+  return x;
+}
+
+cc_vector_t
+small_vector(int key)
+{
+  std::vector<int> x = small_value(key);
+  return cc_vector_from_array(x.data(), x.size(), sizeof(int));
+}
+
+TEST_CASE("ordered map of small vectors")
+{
+  size_t size = cc_small_vector_sizeof(sizeof(int), 3);
+  cc_ordered_map_t a = cc_ordered_map_new_f(
+      sizeof(int),
+      size,
+      cc_default_functions,
+      cc_vector_functions
+    );
+
+  // The erased entries leave tombstones that later resizes compact away.
+  for (int key = 0; key < 500; ++key)
+  {
+    cc_vector_t u = small_vector(key);
+    cc_ordered_map_insert(a, &key, u);
+    cc_vector_delete(u);
+  }
+  for (int key = 0; key < 500; key += 3)
+  {
+    cc_ordered_map_erase(a, &key);
+  }
+  for (int key = 500; key < 1000; ++key)
+  {
+    cc_vector_t u = small_vector(key);
+    cc_ordered_map_insert(a, &key, u);
+    cc_vector_delete(u);
+  }
+
+  for (int key = 0; key < 1000; ++key)
+  {
+    auto u = (cc_vector_t) cc_ordered_map_find(a, &key);
+    if (key < 500 && key % 3 == 0)
+    {
+      CHECK(u == nullptr);
+    }
+    else
+    {
+      REQUIRE(u != nullptr);
+      check_vector(u, small_value(key));
+    }
+  }
+
+  cc_ordered_map_delete(a);
+}
+
+TEST_CASE("btree map of small vectors")
+{
+  size_t size = cc_small_vector_sizeof(sizeof(int), 3);
+  cc_btree_map_t a = cc_btree_map_new_f(
+      sizeof(int),
+      size,
+      cc_int_comparator,
+      cc_default_functions,
+      cc_vector_functions
+    );
+
+  // Scattered keys shift entries within the nodes and split both leaves
+  // and branches.
+  for (int n = 0; n < 20000; ++n)
+  {
+    int key = n * 7919 % 20000;
+    cc_vector_t u = small_vector(key);
+    cc_btree_map_insert(a, &key, u);
+    cc_vector_delete(u);
+  }
+  REQUIRE(cc_btree_map_height(a) > 2);
+  for (int key = 0; key < 20000; key += 3)
+  {
+    cc_btree_map_erase(a, &key);
+  }
+
+  for (int key = 0; key < 20000; ++key)
+  {
+    auto u = (cc_vector_t) cc_btree_map_find(a, &key);
+    if (key % 3 == 0)
+    {
+      CHECK(u == nullptr);
+    }
+    else
+    {
+      REQUIRE(u != nullptr);
+      check_vector(u, small_value(key));
+    }
+  }
+
+  cc_btree_map_delete(a);
+}
+
+TEST_CASE("flat map of small vectors")
+{
+  size_t size = cc_small_vector_sizeof(sizeof(int), 3);
+  cc_flat_map_t a = cc_flat_map_new_f(
+      sizeof(int),
+      size,
+      cc_int_comparator,
+      cc_default_functions,
+      cc_vector_functions
+    );
+  for (int key = 0; key < 100; key += 2)
+  {
+    cc_vector_t u = small_vector(key);
+    cc_flat_map_insert(a, &key, u);
+    cc_vector_delete(u);
+  }
+
+  // The batch interleaves with the existing keys, so the merge moves every
+  // existing entry.
+  std::vector<int> keys;
+  cc_vector_t values = cc_vector_new_f(size, cc_vector_functions);
+  for (int key = 1; key < 100; key += 2)
+  {
+    cc_vector_t u = small_vector(key);
+    keys.push_back(key);
+    cc_vector_push_back(values, u);
+    cc_vector_delete(u);
+  }
+  cc_flat_map_insert_batch(a, keys.data(), cc_vector_data(values), keys.size());
+  cc_vector_delete(values);
+
+  REQUIRE(cc_flat_map_size(a) == 100);
+  for (int key = 0; key < 100; ++key)
+  {
+    auto u = (cc_vector_t) cc_flat_map_find(a, &key);
+    REQUIRE(u != nullptr);
+    check_vector(u, small_value(key));
+  }
+
+  cc_flat_map_delete(a);
+}
+
+TEST_CASE("multimap of small vectors")
+{
+  size_t size = cc_small_vector_sizeof(sizeof(int), 3);
+  cc_multimap_t a = cc_multimap_new_f(
+      sizeof(int),
+      size,
+      cc_default_functions,
+      cc_vector_functions
+    );
+
+  // Each freeze relocates the frozen values along with the pending ones,
+  // and erasing a group shifts the values after it.
+  for (int round = 0; round < 3; ++round)
+  {
+    for (int key = 0; key < 50; ++key)
+    {
+      cc_vector_t u = small_vector(key);
+      cc_multimap_insert(a, &key, u);
+      cc_vector_delete(u);
+    }
+    cc_multimap_freeze(a);
+  }
+  for (int key = 0; key < 50; key += 3)
+  {
+    cc_multimap_erase(a, &key);
+  }
+
+  for (int key = 0; key < 50; ++key)
+  {
+    size_t count;
+    auto u = (const char*) cc_multimap_find(a, &key, &count);
+    if (key % 3 == 0)
+    {
+      CHECK(count == 0);
+    }
+    else
+    {
+      REQUIRE(count == 3);
+      for (size_t n = 0; n < count; ++n)
+      {
+        check_vector((cc_vector_t) (u + n * size), small_value(key));
+      }
+    }
+  }
+
+  cc_multimap_delete(a);
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,229 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <utility>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+#include "iarray.hpp"
+
+void
+check_ordered_map(cc_ordered_map_t u,
+                  const std::vector<std::pair<int, int>>& x)
+{
+  REQUIRE(cc_ordered_map_size(u) == x.size());
+
+  size_t n = 0;
+  cc_ordered_map_iterator_t p = cc_ordered_map_begin(u);
+  cc_ordered_map_iterator_t e = cc_ordered_map_end(u);
+  for (; cc_ordered_map_iterator_ne(p, e); cc_ordered_map_iterator_increment(&p))
+  {
+    REQUIRE(n < x.size());
+    cc_ordered_map_key_value_t kv = cc_ordered_map_iterator_dereference(p);
+    CHECK(*(int*) kv.key == x[n].first);
+    CHECK(*(int*) kv.value == x[n].second);
+    CHECK(*(int*) cc_ordered_map_find(u, &x[n].first) == x[n].second);
+    ++n;
+  }
+  CHECK(n == x.size());
+}
+
+TEST_SUITE_BEGIN("ordered maps");
+
+TEST_CASE("ordered map construction")
+{
+  SUBCASE("empty map")
+  {
+    cc_ordered_map_t u = cc_ordered_map_new(sizeof(int), sizeof(int));
+    CHECK(cc_ordered_map_empty(u));
+    check_ordered_map(u, { });
+    cc_ordered_map_delete(u);
+  }
+
+  SUBCASE("create from arrays")
+  {
+    std::vector<int> ks = { 5, 3, 9, 1 };
+    std::vector<int> vs = { 50, 30, 90, 10 };
+    cc_ordered_map_t u = cc_ordered_map_from_arrays(
+        ks.data(),
+        vs.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int)
+      );
+    check_ordered_map(u, { {5, 50}, {3, 30}, {9, 90}, {1, 10} });
+    cc_ordered_map_delete(u);
+  }
+
+  SUBCASE("copy")
+  {
+    std::vector<int> ks = { 5, 3, 9, 1 };
+    cc_ordered_map_t u = cc_ordered_map_from_arrays(
+        ks.data(),
+        ks.data(),
+        ks.size(),
+        sizeof(int),
+        sizeof(int)
+      );
+    cc_ordered_map_t v = cc_ordered_map_copy(u);
+    check_ordered_map(v, { {5, 5}, {3, 3}, {9, 9}, {1, 1} });
+    CHECK(cc_ordered_map_eq(u, v));
+    cc_ordered_map_delete(u);
+    cc_ordered_map_delete(v);
+  }
+}
+
+TEST_CASE("ordered map modification")
+{
+  cc_ordered_map_t u = cc_ordered_map_new(sizeof(int), sizeof(int));
+  for (int n = 10; n > 0; --n)
+  {
+    int value = 10 * n;
+    cc_ordered_map_insert(u, &n, &value);
+  }
+
+  SUBCASE("insert keeps insertion order")
+  {
+    std::vector<std::pair<int, int>> x;
+    for (int n = 10; n > 0; --n)
+    {
+      x.push_back({n, 10 * n});
+    }
+    check_ordered_map(u, x);
+  }
+
+  SUBCASE("overwrite keeps position")
+  {
+    int key = 7;
+    int value = -7;
+    cc_ordered_map_insert(u, &key, &value);
+    CHECK(cc_ordered_map_size(u) == 10);
+    cc_ordered_map_iterator_t p = cc_ordered_map_begin(u);
+    for (int n = 0; n < 3; ++n)
+    {
+      cc_ordered_map_iterator_increment(&p);
+    }
+    CHECK(*(int*) cc_ordered_map_iterator_dereference(p).key == 7);
+    CHECK(*(int*) cc_ordered_map_iterator_dereference(p).value == -7);
+  }
+
+  SUBCASE("erase")
+  {
+    for (int key = 1; key <= 10; key += 2)
+    {
+      cc_ordered_map_erase(u, &key);
+    }
+    check_ordered_map(u, { {10, 100}, {8, 80}, {6, 60}, {4, 40}, {2, 20} });
+    int key = 3;
+    CHECK(!cc_ordered_map_contains(u, &key));
+
+    int value = 30;
+    cc_ordered_map_insert(u, &key, &value);
+    check_ordered_map(
+        u,
+        { {10, 100}, {8, 80}, {6, 60}, {4, 40}, {2, 20}, {3, 30} }
+      );
+  }
+
+  SUBCASE("erase everything")
+  {
+    for (int key = 1; key <= 10; ++key)
+    {
+      cc_ordered_map_erase(u, &key);
+    }
+    check_ordered_map(u, { });
+    int key = 4;
+    cc_ordered_map_insert(u, &key, &key);
+    check_ordered_map(u, { {4, 4} });
+  }
+
+  SUBCASE("clear")
+  {
+    cc_ordered_map_clear(u);
+    check_ordered_map(u, { });
+  }
+
+  SUBCASE("swap")
+  {
+    cc_ordered_map_t v = cc_ordered_map_new(sizeof(int), sizeof(int));
+    cc_ordered_map_swap(u, v);
+    CHECK(cc_ordered_map_empty(u));
+    CHECK(cc_ordered_map_size(v) == 10);
+    cc_ordered_map_delete(v);
+  }
+
+  cc_ordered_map_delete(u);
+}
+
+TEST_CASE("ordered map growth")
+{
+  const int count = 100000;
+  cc_ordered_map_t u = cc_ordered_map_new(sizeof(int), sizeof(int));
+  std::vector<std::pair<int, int>> x;
+
+  // Spans every index width up to four bytes.
+  for (int n = 0; n < count; ++n)
+  {
+    int key = (n * 7919) % count;
+    cc_ordered_map_insert(u, &key, &n);
+    x.push_back({key, n});
+  }
+  CHECK(u->index_width == 4);
+  check_ordered_map(u, x);
+
+  // Erasing most entries compacts the tombstones without reordering.
+  std::vector<std::pair<int, int>> y;
+  for (const auto& kv : x)
+  {
+    if (kv.first % 10 != 0)
+    {
+      cc_ordered_map_erase(u, &kv.first);
+    }
+    else
+    {
+      y.push_back(kv);
+    }
+  }
+  CHECK(u->count < (size_t) count);
+  check_ordered_map(u, y);
+
+  cc_ordered_map_delete(u);
+}
+
+TEST_CASE("ordered map of arrays")
+{
+  int a[] = { 1, 2, 3 };
+  int b[] = { 4, 5 };
+  iarray i = { 3, a };
+  iarray j = { 2, b };
+
+  cc_ordered_map_t u = cc_ordered_map_new_f(
+      sizeof(iarray),
+      sizeof(iarray),
+      iarray_functions,
+      iarray_functions
+    );
+  cc_ordered_map_insert(u, &i, &j);
+  cc_ordered_map_insert(u, &j, &i);
+  cc_ordered_map_insert(u, &i, &i);
+
+  cc_ordered_map_t v = cc_ordered_map_copy(u);
+  CHECK(cc_ordered_map_eq(u, v));
+  CHECK(iarray_equal(cc_ordered_map_find(v, &i), &i, sizeof(iarray)));
+  CHECK(iarray_equal(cc_ordered_map_find(v, &j), &i, sizeof(iarray)));
+
+  cc_ordered_map_erase(u, &i);
+  CHECK(cc_ordered_map_ne(u, v));
+
+  cc_ordered_map_delete(u);
+  cc_ordered_map_delete(v);
+}
+
+TEST_SUITE_END();
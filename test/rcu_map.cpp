@@ -0,0 +1,145 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+void
+double_values(struct cc_map* map, void* arg)
+{
+  cc_map_iterator_t p = cc_map_begin(map);
+  cc_map_iterator_t e = cc_map_end(map);
+  for (; cc_map_iterator_ne(p, e); cc_map_iterator_increment(&p))
+  {
+    *(int*) cc_map_iterator_dereference(p).value *= 2;
+  }
+}
+
+void
+set_version(struct cc_map* map, void* arg)
+{
+  int version = *(int*) arg;
+  for (int n = 0; n < 16; ++n)
+  {
+    cc_map_insert(map, &n, &version);
+  }
+}
+
+TEST_SUITE_BEGIN("rcu maps");
+
+TEST_CASE("rcu map modification")
+{
+  cc_rcu_map_t u = cc_rcu_map_new(sizeof(int), sizeof(int));
+  cc_rcu_map_reader_t r = cc_rcu_map_reader_new(u);
+  const struct cc_map* snapshot;
+
+  for (int n = 0; n < 10; ++n)
+  {
+    int value = 10 * n;
+    cc_rcu_map_insert(u, &n, &value);
+  }
+
+  SUBCASE("insert")
+  {
+    snapshot = cc_rcu_map_read_lock(r);
+    CHECK(cc_map_size(snapshot) == 10);
+    for (int n = 0; n < 10; ++n)
+    {
+      REQUIRE(cc_map_find(snapshot, &n));
+      CHECK(*(int*) cc_map_find(snapshot, &n) == 10 * n);
+    }
+    cc_rcu_map_read_unlock(r);
+  }
+
+  SUBCASE("erase")
+  {
+    int key = 4;
+    cc_rcu_map_erase(u, &key);
+    snapshot = cc_rcu_map_read_lock(r);
+    CHECK(cc_map_size(snapshot) == 9);
+    CHECK(!cc_map_contains(snapshot, &key));
+    cc_rcu_map_read_unlock(r);
+  }
+
+  SUBCASE("update")
+  {
+    cc_rcu_map_update(u, double_values, NULL);
+    snapshot = cc_rcu_map_read_lock(r);
+    int key = 3;
+    CHECK(*(int*) cc_map_find(snapshot, &key) == 60);
+    cc_rcu_map_read_unlock(r);
+  }
+
+  SUBCASE("publish")
+  {
+    cc_map_t map = cc_map_new(sizeof(int), sizeof(int));
+    int key = 42;
+    cc_map_insert(map, &key, &key);
+    cc_rcu_map_publish(u, map);
+    snapshot = cc_rcu_map_read_lock(r);
+    CHECK(cc_map_size(snapshot) == 1);
+    CHECK(*(int*) cc_map_find(snapshot, &key) == 42);
+    cc_rcu_map_read_unlock(r);
+  }
+
+  cc_rcu_map_reader_delete(r);
+  cc_rcu_map_delete(u);
+}
+
+TEST_CASE("rcu map readers see consistent snapshots")
+{
+  const int readers = 3;
+  int version = 0;
+  cc_rcu_map_t u = cc_rcu_map_new(sizeof(int), sizeof(int));
+  cc_rcu_map_update(u, set_version, &version);
+
+  std::atomic<bool> done(false);
+  std::atomic<int> inconsistent(0);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < readers; ++t)
+  {
+    workers.emplace_back([&]() {
+      cc_rcu_map_reader_t r = cc_rcu_map_reader_new(u);
+      while (!done.load())
+      {
+        const struct cc_map* snapshot = cc_rcu_map_read_lock(r);
+        int key = 0;
+        int first = *(int*) cc_map_find(snapshot, &key);
+        for (key = 1; key < 16; ++key)
+        {
+          if (*(int*) cc_map_find(snapshot, &key) != first)
+          {
+            ++inconsistent;
+          }
+        }
+        cc_rcu_map_read_unlock(r);
+      }
+      cc_rcu_map_reader_delete(r);
+    });
+  }
+
+  for (version = 1; version <= 100; ++version)
+  {
+    cc_rcu_map_update(u, set_version, &version);
+  }
+  done.store(true);
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  CHECK(inconsistent.load() == 0);
+  cc_rcu_map_delete(u);
+}
+
+TEST_SUITE_END();
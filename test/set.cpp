@@ -0,0 +1,201 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include <set>
+#include <vector>
+#include "doctest/doctest.h"
+#include "cc.h"
+
+void
+check_set(cc_set_t u, const std::set<int>& x)
+{
+  CHECK(cc_set_size(u) == x.size());
+  for (int key : x)
+  {
+    CHECK(cc_set_contains(u, &key));
+  }
+
+  size_t count = 0;
+  cc_set_iterator_t p = cc_set_begin(u);
+  cc_set_iterator_t e = cc_set_end(u);
+  for (; cc_set_iterator_ne(p, e); cc_set_iterator_increment(&p))
+  {
+    CHECK(x.count(*(int*) cc_set_iterator_dereference(p)) == 1);
+    ++count;
+  }
+  CHECK(count == x.size());
+}
+
+cc_set_t
+create_set(const std::set<int>& x)
+{
+  std::vector<int> keys(x.begin(), x.end());
+  return cc_set_from_array(keys.data(), keys.size(), sizeof(int));
+}
+
+TEST_SUITE_BEGIN("sets");
+
+TEST_CASE("set construction")
+{
+  SUBCASE("empty set")
+  {
+    cc_set_t u = cc_set_new(sizeof(int));
+    CHECK(cc_set_empty(u));
+    CHECK(cc_set_size(u) == 0);
+    CHECK(u->map.value_size == 0);
+    cc_set_delete(u);
+  }
+
+  SUBCASE("create from array")
+  {
+    std::vector<int> keys = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    cc_set_t u = cc_set_from_array(keys.data(), keys.size(), sizeof(int));
+    check_set(u, { 1, 2, 3, 4, 5, 6, 9 });
+    cc_set_delete(u);
+  }
+
+  SUBCASE("copy")
+  {
+    cc_set_t u = create_set({ 1, 2, 3 });
+    cc_set_t v = cc_set_copy(u);
+    check_set(v, { 1, 2, 3 });
+    CHECK(cc_set_eq(u, v));
+    cc_set_delete(u);
+    cc_set_delete(v);
+  }
+}
+
+TEST_CASE("set modification")
+{
+  cc_set_t u = create_set({ 1, 2, 3 });
+
+  SUBCASE("insert")
+  {
+    for (int n = 0; n < 1000; ++n)
+    {
+      cc_set_insert(u, &n);
+    }
+    CHECK(cc_set_size(u) == 1000);
+    int key = 1000;
+    CHECK(!cc_set_contains(u, &key));
+  }
+
+  SUBCASE("erase")
+  {
+    int key = 2;
+    cc_set_erase(u, &key);
+    check_set(u, { 1, 3 });
+    key = 7;
+    cc_set_erase(u, &key);
+    check_set(u, { 1, 3 });
+  }
+
+  SUBCASE("clear")
+  {
+    cc_set_clear(u);
+    check_set(u, { });
+  }
+
+  SUBCASE("swap")
+  {
+    cc_set_t v = create_set({ 4, 5 });
+    cc_set_swap(u, v);
+    check_set(u, { 4, 5 });
+    check_set(v, { 1, 2, 3 });
+    cc_set_delete(v);
+  }
+
+  cc_set_delete(u);
+}
+
+TEST_CASE("set operations")
+{
+  std::set<int> small = { 2, 4, 6, 8 };
+  std::set<int> large;
+  for (int n = 0; n < 100; n += 3)
+  {
+    large.insert(n);
+  }
+
+  SUBCASE("union")
+  {
+    cc_set_t u = create_set(small);
+    cc_set_t v = create_set(large);
+    std::set<int> x = small;
+    x.insert(large.begin(), large.end());
+    cc_set_union(u, v);
+    check_set(u, x);
+    cc_set_delete(u);
+    cc_set_delete(v);
+  }
+
+  SUBCASE("union with room to spare")
+  {
+    cc_set_t u = create_set(large);
+    cc_set_t v = create_set(small);
+    size_t capacity = u->map.capacity;
+    std::set<int> x = large;
+    x.insert(small.begin(), small.end());
+    cc_set_union(u, v);
+    check_set(u, x);
+    CHECK(u->map.capacity == capacity);
+    cc_set_delete(u);
+    cc_set_delete(v);
+  }
+
+  SUBCASE("intersection")
+  {
+    std::set<int> x = { 6 };
+    cc_set_t u = create_set(small);
+    cc_set_t v = create_set(large);
+    cc_set_intersection(u, v);
+    check_set(u, x);
+    cc_set_intersection(v, u);
+    check_set(v, x);
+    cc_set_delete(u);
+    cc_set_delete(v);
+  }
+
+  SUBCASE("difference")
+  {
+    cc_set_t u = create_set(small);
+    cc_set_t v = create_set(large);
+    cc_set_t w = create_set(large);
+    cc_set_difference(u, v);
+    check_set(u, { 2, 4, 8 });
+    cc_set_difference(w, u);
+    check_set(w, large);
+    cc_set_difference(v, v);
+    check_set(v, { });
+    cc_set_delete(u);
+    cc_set_delete(v);
+    cc_set_delete(w);
+  }
+}
+
+TEST_CASE("nested sets")
+{
+  cc_map_t m = cc_map_new_f(
+      sizeof(int),
+      cc_set_sizeof,
+      cc_default_functions,
+      cc_set_functions
+    );
+  cc_set_t u = create_set({ 1, 2, 3 });
+  int key = 7;
+  cc_map_insert(m, &key, u);
+  cc_set_t v = (cc_set_t) cc_map_find(m, &key);
+  check_set(v, { 1, 2, 3 });
+  CHECK(cc_set_eq(u, v));
+  cc_set_delete(u);
+  cc_map_delete(m);
+}
+
+TEST_SUITE_END();
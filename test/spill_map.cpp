@@ -0,0 +1,169 @@
+/*
+ *  cc - C Containers library
+ *
+ *  cc is, per 17 USC § 101, a work of the U.S. Government and is not subject to
+ *  copyright protection in the United States.
+ *
+ *  DISTRIBUTION STATEMENT A.  Approved for public release; distribution is
+ *  unlimited.  Granted clearance per 88ABW-2020-3430.
+ */
+
+#include "doctest/doctest.h"
+#include "cc.h"
+
+void
+add_counts(void* existing, const void* value, void* arg)
+{
+  *(int*) existing += *(const int*) value;
+}
+
+void
+sum_spilled(const void* key, void* value, void* arg)
+{
+  long* totals = (long*) arg;
+  totals[0] += 1;
+  totals[1] += *(int*) value;
+}
+
+TEST_SUITE_BEGIN("spill maps");
+
+TEST_CASE("spill map in memory")
+{
+  cc_spill_map_t m = cc_spill_map_new(sizeof(int), sizeof(int), 1 << 20);
+  CHECK(cc_spill_map_partition_count(m) == 64);
+
+  for (int n = 0; n < 100; ++n)
+  {
+    int value = 2 * n;
+    cc_spill_map_insert(m, &n, &value);
+  }
+  CHECK(cc_spill_map_memory_size(m) == 100);
+  CHECK(cc_spill_map_spilled(m) == 0);
+
+  int key = 21;
+  int value = 0;
+  CHECK(cc_spill_map_find(m, &key, &value));
+  CHECK(value == 42);
+  key = 100;
+  CHECK(!cc_spill_map_contains(m, &key));
+
+  cc_spill_map_delete(m);
+}
+
+TEST_CASE("spill map after a spill")
+{
+  // 64 entries fit in the budget; once they have been spilled, the next 63
+  // stay in memory instead of each being spilled on its own.
+  size_t slot = sizeof(struct cc_map_node) + 2 * sizeof(int);
+  cc_spill_map_t m = cc_spill_map_new(sizeof(int), sizeof(int), 64 * slot);
+  for (int n = 0; n < 65; ++n)
+  {
+    cc_spill_map_insert(m, &n, &n);
+  }
+  CHECK(cc_spill_map_spilled(m) == 65);
+  CHECK(cc_spill_map_memory_size(m) == 0);
+
+  for (int n = 65; n < 128; ++n)
+  {
+    cc_spill_map_insert(m, &n, &n);
+  }
+  CHECK(cc_spill_map_spilled(m) == 65);
+  CHECK(cc_spill_map_memory_size(m) == 63);
+
+  CHECK(cc_spill_map_spill(m));
+  CHECK(cc_spill_map_spilled(m) == 128);
+  CHECK(cc_spill_map_memory_size(m) == 0);
+  for (int n = 0; n < 128; n += 9)
+  {
+    int value = -1;
+    REQUIRE(cc_spill_map_find(m, &n, &value));
+    CHECK(value == n);
+  }
+
+  cc_spill_map_delete(m);
+}
+
+TEST_CASE("spill map beyond its budget")
+{
+  const int count = 5000;
+  cc_spill_map_t m = cc_spill_map_new_f(
+      sizeof(int),
+      sizeof(int),
+      4096,
+      16,
+      cc_default_functions,
+      cc_default_functions
+    );
+  cc_spill_map_set_combiner(m, add_counts, NULL);
+
+  // Every key is inserted twice, so some duplicates meet in memory and others
+  // only meet when a partition is rebuilt from its run file.
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (int n = 0; n < count; ++n)
+    {
+      int one = 1;
+      cc_spill_map_insert(m, &n, &one);
+    }
+  }
+  CHECK(cc_spill_map_spilled(m) > 0);
+  CHECK(cc_spill_map_memory_size(m) < (size_t) count);
+
+  SUBCASE("find")
+  {
+    for (int n = 0; n < count; n += 7)
+    {
+      int value = 0;
+      REQUIRE(cc_spill_map_find(m, &n, &value));
+      CHECK(value == 2);
+    }
+    int key = count;
+    CHECK(!cc_spill_map_contains(m, &key));
+  }
+
+  SUBCASE("insert after find")
+  {
+    int key = 3;
+    int one = 1;
+    int value = 0;
+    CHECK(cc_spill_map_find(m, &key, &value));
+    cc_spill_map_insert(m, &key, &one);
+    CHECK(cc_spill_map_find(m, &key, &value));
+    CHECK(value == 3);
+  }
+
+  SUBCASE("for each")
+  {
+    long totals[2] = {0, 0};
+    cc_spill_map_for_each(m, sum_spilled, totals);
+    CHECK(totals[0] == count);
+    CHECK(totals[1] == 2 * count);
+  }
+
+  SUBCASE("load partition")
+  {
+    size_t total = 0;
+    for (size_t p = 0; p < cc_spill_map_partition_count(m); ++p)
+    {
+      cc_map_t partition = cc_spill_map_load_partition(m, p);
+      REQUIRE(partition);
+      total += cc_map_size(partition);
+      cc_map_delete(partition);
+    }
+    CHECK(total == (size_t) count);
+    CHECK(!cc_spill_map_load_partition(m, 16));
+  }
+
+  SUBCASE("clear")
+  {
+    cc_spill_map_clear(m);
+    CHECK(cc_spill_map_spilled(m) == 0);
+    CHECK(cc_spill_map_memory_size(m) == 0);
+    int key = 0;
+    CHECK(!cc_spill_map_contains(m, &key));
+  }
+
+  cc_spill_map_delete(m);
+}
+
+TEST_SUITE_END();
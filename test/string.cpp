@@ -8,6 +8,9 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
+#include <cstdlib>
+#include <cstring>
+#include <string>
 #include "doctest/doctest.h"
 #include "cc.h"
 #include "string.hpp"
@@ -46,6 +49,27 @@ TEST_CASE("string construction")
     cc_string_delete(s);
     cc_string_delete(t);
   }
+
+  SUBCASE("adopt and release")
+  {
+    char* data = (char*) malloc(32);
+    memcpy(data, "Hello", 5);
+    cc_string_t s = cc_string_adopt(data, 5, 31);
+    REQUIRE(s != nullptr);
+    CHECK(cc_string_data(s) == data);
+    cc_string_append(s, ", world!", 8);
+    CHECK(to_string(s) == "Hello, world!");
+
+    char* released = cc_string_release(s);
+    CHECK(std::string(released) == "Hello, world!");
+    CHECK(cc_string_size(s) == 0);
+    cc_string_push_back(s, 'x');
+    CHECK(to_string(s) == "x");
+    CHECK(cc_string_adopt(released, 14, 13) == nullptr);
+
+    free(released);
+    cc_string_delete(s);
+  }
 }
 
 TEST_CASE("string assignment")
@@ -8,6 +8,7 @@
  *  unlimited.  Granted clearance per 88ABW-2020-3430.
  */
 
+#include <cstdlib>
 #include "doctest/doctest.h"
 #include "cc.h"
 #include "vector.hpp"
@@ -49,6 +50,36 @@ TEST_CASE("vector construction [atomic]")
     cc_vector_delete(u);
     cc_vector_delete(v);
   }
+
+  SUBCASE("adopt and release")
+  {
+    int* data = (int*) malloc(4 * sizeof(int));
+    for (int n = 0; n < 3; ++n)
+    {
+      data[n] = n * n;
+    }
+    cc_vector_t u = cc_vector_adopt(data, 3, 4, sizeof(int),
+                                    cc_default_functions);
+    REQUIRE(u != nullptr);
+    CHECK(cc_vector_data(u) == data);
+    CHECK(cc_vector_capacity(u) == 4);
+    check_vector<int>(u, { 0, 1, 4 });
+
+    int a = 9;
+    cc_vector_push_back(u, &a);
+    check_vector<int>(u, { 0, 1, 4, 9 });
+    int* released = (int*) cc_vector_release(u);
+    CHECK(released[3] == 9);
+    check_vector<int>(u, { });
+    CHECK(cc_vector_capacity(u) == 0);
+    CHECK(cc_vector_adopt(nullptr, 1, 1, sizeof(int),
+                          cc_default_functions) == nullptr);
+
+    cc_vector_push_back(u, &a);
+    check_vector<int>(u, { 9 });
+    free(released);
+    cc_vector_delete(u);
+  }
 }
 
 TEST_CASE("vector assignment [atomic]")
@@ -147,6 +178,35 @@ TEST_CASE("vector capacity [atomic]")
     CHECK(cc_vector_capacity(v) == 6);
   }
 
+  SUBCASE("growth")
+  {
+    CHECK(cc_vector_growth(u) == 100);
+    cc_vector_set_growth(u, 50);
+    CHECK(cc_vector_growth(u) == 50);
+
+    std::vector<size_t> capacities;
+    for (int n = 0; n < 10; ++n)
+    {
+      double value = n;
+      cc_vector_push_back(u, &value);
+      if (capacities.empty() || capacities.back() != cc_vector_capacity(u))
+      {
+        capacities.push_back(cc_vector_capacity(u));
+      }
+    }
+    CHECK(capacities == std::vector<size_t>{ 1, 2, 3, 4, 6, 9, 13 });
+    for (int n = 0; n < 10; ++n)
+    {
+      CHECK(*(double*) cc_vector_get(u, n) == n);
+    }
+
+    cc_vector_set_growth(v, 0);
+    cc_vector_push_back(v, &a);
+    cc_vector_push_back(v, &a);
+    CHECK(cc_vector_capacity(v) == 7);
+    CHECK(*(double*) cc_vector_get(v, 4) == 5.5);
+  }
+
   cc_vector_delete(u);
   cc_vector_delete(v);
 }
@@ -174,6 +234,26 @@ TEST_CASE("vector modification [atomic]")
     check_vector<double>(v, { 1.1, -6.6, -2.2, 3.3, -4.4, 5.5 });
   }
 
+  SUBCASE("insert range")
+  {
+    double y[] = { 7.7, 8.8 };
+    cc_vector_insert_range(u, 0, y, 2);
+    cc_vector_insert_range(v, 2, y, 2);
+    cc_vector_insert_range(v, 6, y, 1);
+    check_vector<double>(u, { 7.7, 8.8 });
+    check_vector<double>(v, { 1.1, -2.2, 7.7, 8.8, 3.3, -4.4, 7.7, 5.5 });
+  }
+
+  SUBCASE("append")
+  {
+    cc_vector_append_array(u, &a, 1);
+    cc_vector_append_vector(u, v);
+    cc_vector_append_vector(v, v);
+    check_vector<double>(u, { -6.6, 1.1, -2.2, 3.3, -4.4, 5.5 });
+    check_vector<double>(v, { 1.1, -2.2, 3.3, -4.4, 5.5,
+                              1.1, -2.2, 3.3, -4.4, 5.5 });
+  }
+
   SUBCASE("erase")
   {
     cc_vector_erase(v, 1, 3);
@@ -214,6 +294,66 @@ TEST_CASE("vector modification [atomic]")
   cc_vector_delete(v);
 }
 
+TEST_CASE("small vectors [atomic]")
+{
+  cc_vector_t u = cc_small_vector_new(sizeof(int), 4);
+  REQUIRE(u != nullptr);
+  const void* storage = cc_vector_data(u);
+  CHECK(cc_vector_capacity(u) == 4);
+
+  for (int n = 0; n < 4; ++n)
+  {
+    cc_vector_push_back(u, &n);
+  }
+  CHECK(cc_vector_data(u) == storage);
+  check_vector<int>(u, { 0, 1, 2, 3 });
+
+  SUBCASE("spill")
+  {
+    int a = 4;
+    cc_vector_push_back(u, &a);
+    CHECK(cc_vector_data(u) != storage);
+    CHECK(cc_vector_capacity(u) == 8);
+    check_vector<int>(u, { 0, 1, 2, 3, 4 });
+
+    cc_vector_erase(u, 1, 3);
+    cc_vector_shrink_to_fit(u);
+    CHECK(cc_vector_data(u) == storage);
+    CHECK(cc_vector_capacity(u) == 4);
+    check_vector<int>(u, { 0, 3, 4 });
+  }
+
+  SUBCASE("copy")
+  {
+    cc_vector_t v = cc_vector_copy(u);
+    CHECK(cc_vector_capacity(v) == 4);
+    check_vector<int>(v, { 0, 1, 2, 3 });
+    cc_vector_delete(v);
+  }
+
+  SUBCASE("swap")
+  {
+    std::vector<int> x = { 5, 6 };
+    cc_vector_t v = cc_vector_from_array(x.data(), x.size(), sizeof(int));
+    cc_vector_swap(u, v);
+    check_vector<int>(u, { 5, 6 });
+    check_vector<int>(v, { 0, 1, 2, 3 });
+    cc_vector_delete(v);
+  }
+
+  SUBCASE("release")
+  {
+    int* data = (int*) cc_vector_release(u);
+    CHECK(data != storage);
+    CHECK(data[3] == 3);
+    CHECK(cc_vector_data(u) == storage);
+    CHECK(cc_vector_empty(u));
+    free(data);
+  }
+
+  cc_vector_delete(u);
+}
+
 TEST_CASE("vector comparison [atomic]")
 {
   std::vector<long> x = { 1, 12, 123, 1234, 12345, 123456, 1234567 };
@@ -197,6 +197,23 @@ TEST_CASE("vector capacity [deep]")
     CHECK(cc_vector_capacity(v) == 4);
   }
 
+  SUBCASE("relocation")
+  {
+    cc_vector_t w = iarray_vector_from_array(x);
+    for (int n = 0; n < 100; ++n)
+    {
+      cc_vector_push_back(w, &a);
+    }
+    CHECK(cc_vector_size(w) == 103);
+    CHECK(iarray_equal(cc_vector_get(w, 2), &x[2], 0));
+    CHECK(iarray_equal(cc_vector_get(w, 102), &a, 0));
+
+    cc_vector_shrink_to_fit(w);
+    CHECK(cc_vector_capacity(w) == 103);
+    CHECK(iarray_equal(cc_vector_get(w, 0), &x[0], 0));
+    cc_vector_delete(w);
+  }
+
   cc_vector_delete(u);
   cc_vector_delete(v);
 }
@@ -234,6 +251,34 @@ TEST_CASE("vector modification [deep]")
     check_vector<iarray>(v, { {2, x1} });
   }
 
+  SUBCASE("emplace")
+  {
+    cc_vector_t w = iarray_vector_from_array(x);
+    iarray* y = (iarray*) cc_vector_emplace(w, 1);
+    REQUIRE(y != nullptr);
+    iarray_copy(y, &a, sizeof(iarray));
+    y = (iarray*) cc_vector_emplace_back(w);
+    REQUIRE(y != nullptr);
+    iarray_copy(y, &x[0], sizeof(iarray));
+    check_vector<iarray>(w, { {2, x1}, {1, a1}, {2, x2}, {2, x3}, {2, x1} });
+    cc_vector_delete(w);
+  }
+
+  SUBCASE("ranges")
+  {
+    cc_vector_t w = iarray_vector_from_array(x);
+    cc_vector_insert_range(w, 1, x.data(), 2);
+    cc_vector_append_array(w, &a, 1);
+    check_vector<iarray>(w, { {2, x1}, {2, x1}, {2, x2}, {2, x2}, {2, x3},
+                              {1, a1} });
+    cc_vector_erase(w, 0, 3);
+    check_vector<iarray>(w, { {2, x2}, {2, x3}, {1, a1} });
+    cc_vector_append_vector(w, w);
+    check_vector<iarray>(w, { {2, x2}, {2, x3}, {1, a1},
+                              {2, x2}, {2, x3}, {1, a1} });
+    cc_vector_delete(w);
+  }
+
   SUBCASE("push back")
   {
     cc_vector_push_back(u, &a);